@@ -1,14 +1,16 @@
 # FILEPATH: libversa/LibVersa.cmake
 
-# This CMake script defines a macro called `versa_create_version_info` that is used to generate version information for a project.
+# This CMake script defines a macro called `versa_setup_target` that is used to generate version information for a target.
 # The macro takes several arguments, including `NAMESPACE`, `MAJOR`, `MINOR`, `PATCH`, `TWEAK`, and `SUFFIX`, which can be provided by the user.
 # If any of these arguments are not provided, the macro will use default values based on the project's version information.
-# The macro also supports an optional `GIT_LOG` flag, which, when enabled, retrieves the latest commit hash from the Git repository.
-# The macro uses the `configure_file` command to generate `version.h` and `version.hpp` files based on template files.
-# These generated files will contain the version information and can be included in the project's source code.
+# The macro also supports an optional `GIT_HASH` flag, which, when enabled, retrieves the latest commit hash from the Git repository.
+# Every target gets a generated `versa/project.hpp`, declaring `<namespace>::version`, and one generated source file defining it.
+# The macro also uses the `configure_file` command to generate `versa/version.h`, the C API, and `versa/version.hpp` from template files,
+# next to `versa/project.hpp` on the target's include path. `version.hpp` includes `version.h` and stands alone; a C++ source includes
+# either `version.hpp` or `project.hpp`, since both declare `<namespace>::version`.
 
 # Usage:
-# versa_create_version_info(NAMESPACE <namespace> [MAJOR <major>] [MINOR <minor>] [PATCH <patch>] [TWEAK <tweak>] [SUFFIX <suffix>] [GIT_LOG])
+# versa_setup_target(<target> NAMESPACE <namespace> [MAJOR <major>] [MINOR <minor>] [PATCH <patch>] [TWEAK <tweak>] [SUFFIX <suffix>] [GIT_HASH])
 
 # Arguments:
 # - `NAMESPACE`: The namespace for the version information. If not provided, it defaults to the project's namespace.
@@ -18,15 +20,20 @@
 # - `TWEAK`: The tweak version number. If not provided, it defaults to the project's tweak version number.
 # - `SUFFIX`: The version suffix. If not provided, it defaults to the project's version suffix, if available.
 # - `GIT_HASH`: Optional flag to include the latest commit hash in the version information. If provided, it retrieves the commit hash using the `git log` command.
+# - `COMPILE_DEFINITIONS`: Optional flag to also pass the version as `_VERSA_PROJECT_*` definitions on every compile of the target, for the
+#                          VERSA_MAJOR_VERSION etc. macros of constants.inc. Off by default, since a version bump then recompiles the whole target.
+# - `PRECOMPILE`: Optional flag to precompile the core libversa headers for the target, also turned on for every target by LIBVERSA_PRECOMPILE_HEADERS.
+# - `ELF_NOTE`: Optional flag to embed the build_info and version in a `.note.versa` ELF note of the target, which versa::info::read_build_note() and the versa_scan tool read without running the binary.
 # - `INCLUDE_DIR`: This is the location of the versa/version.h.in, version.hpp.in, etc.
 # - `LANG`: The language to use for the version information. If not provided, it defaults to the language of your project. Currently, only C and C++ are supported.
 #           If set to C, the generated files will use C-style structs, functions and macros in version.h. 
 #           If set to C++/CXX/CPP, the generated files will use C++-style classes, functions and namespaces in version.hpp.in.
 
 # Example:
-# versa_create_version_info(NAMESPACE MyProject MAJOR 1 MINOR 2 PATCH 3 TWEAK 4 SUFFIX "alpha" GIT_LOG)
+# versa_setup_target(my_app NAMESPACE MyProject MAJOR 1 MINOR 2 PATCH 3 TWEAK 4 SUFFIX "alpha" GIT_HASH)
 
 set(_VERSA_INCLUDE_DIR ${CMAKE_CURRENT_SOURCE_DIR})
+set(_VERSA_LIST_DIR ${CMAKE_CURRENT_LIST_DIR})
 
 #macro(versa_configure_file INC_DIR NS HEADER)
 #   configure_file(${INC_DIR}/versa/${HEADER}.in
@@ -44,7 +51,7 @@ set(_VERSA_INCLUDE_DIR ${CMAKE_CURRENT_SOURCE_DIR})
 #endfunction()
  
 macro(versa_setup_target _target)
-   set(options GIT_HASH)
+   set(options GIT_HASH ELF_NOTE COMPILE_DEFINITIONS PRECOMPILE)
    set(oneValueArgs NAMESPACE MAJOR MINOR PATCH TWEAK SUFFIX)
    set(multiValueArgs)
    cmake_parse_arguments( LV_ARGS "${options}" 
@@ -60,26 +67,26 @@ macro(versa_setup_target _target)
       set(LV_NAMESPACE ${LV_ARGS_NAMESPACE})
    endif()
 
-   if (NOT LV_ARGS_MAJOR)
-      set(LV_MAJOR ${PROJECT_VERSA_MAJOR})
+   if (NOT DEFINED LV_ARGS_MAJOR)
+      set(LV_MAJOR ${PROJECT_VERSION_MAJOR})
    else()
       set(LV_MAJOR ${LV_ARGS_MAJOR})
    endif()
 
-   if (NOT LV_ARGS_MINOR)
-      set(LV_MINOR ${PROJECT_VERSA_MINOR})
+   if (NOT DEFINED LV_ARGS_MINOR)
+      set(LV_MINOR ${PROJECT_VERSION_MINOR})
    else()
       set(LV_MINOR ${LV_ARGS_MINOR})
    endif()
 
-   if (NOT LV_ARGS_PATCH)
-      set(LV_PATCH ${PROJECT_VERSA_PATCH})
+   if (NOT DEFINED LV_ARGS_PATCH)
+      set(LV_PATCH ${PROJECT_VERSION_PATCH})
    else()
       set(LV_PATCH ${LV_ARGS_PATCH})
    endif()
 
-   if (NOT LV_ARGS_TWEAK)
-      set(LV_TWEAK ${PROJECT_VERSA_TWEAK})
+   if (NOT DEFINED LV_ARGS_TWEAK)
+      set(LV_TWEAK ${PROJECT_VERSION_TWEAK})
    else()
       set(LV_TWEAK ${LV_ARGS_TWEAK})
    endif()
@@ -102,6 +109,8 @@ macro(versa_setup_target _target)
       )
    endif()
    
+   set(LV_USE_SUFFIX 0)
+   set(LV_USE_GIT_HASH 0)
    set(LV_MSG "Creating version information for ${LV_NAMESPACE} ${LV_MAJOR}.${LV_MINOR}.${LV_PATCH}.${LV_TWEAK}")
 
    if (LV_SUFFIX)
@@ -116,18 +125,51 @@ macro(versa_setup_target _target)
 
    message(STATUS ${LV_MSG})
 
-   target_compile_definitions(${_target} PRIVATE 
-      _VERSA_PROJECT_NAMESPACE=${LV_NAMESPACE}
-      _VERSA_PROJECT_MAJOR_VERSION=${LV_MAJOR}
-      _VERSA_PROJECT_MINOR_VERSION=${LV_MINOR}
-      _VERSA_PROJECT_PATCH_VERSION=${LV_PATCH}
-      _VERSA_PROJECT_TWEAK_VERSION=${LV_TWEAK}
-      _VERSA_PROJECT_SUFFIX=${LV_SUFFIX}
-      _VERSA_PROJECT_GIT_HASH=${LV_GIT_HASH}
-      _VERSA_PROJECT_USE_SUFFIX=${LV_USE_SUFFIX}
-      _VERSA_PROJECT_USE_GIT_HASH=${LV_USE_GIT_HASH}
-      NSS="foo"
-   )
+   set(LV_TARGET ${_target})
+   foreach(_part MAJOR MINOR PATCH TWEAK)
+      if ("${LV_${_part}}" STREQUAL "")
+         set(LV_${_part} 0)
+      endif()
+   endforeach()
+
+   # configure_file() leaves unchanged files alone, so a new version only rebuilds the source file.
+   set(LV_PROJECT_DIR ${CMAKE_CURRENT_BINARY_DIR}/${_target}_versa)
+   configure_file(${_VERSA_LIST_DIR}/include/versa/project.hpp.in ${LV_PROJECT_DIR}/versa/project.hpp @ONLY)
+   configure_file(${_VERSA_LIST_DIR}/include/versa/project.cpp.in ${LV_PROJECT_DIR}/${_target}_versa_project.cpp @ONLY)
+   configure_file(${_VERSA_LIST_DIR}/include/versa/version.h.in ${LV_PROJECT_DIR}/versa/version.h @ONLY)
+   configure_file(${_VERSA_LIST_DIR}/include/versa/version.hpp.in ${LV_PROJECT_DIR}/versa/version.hpp @ONLY)
+   target_sources(${_target} PRIVATE ${LV_PROJECT_DIR}/${_target}_versa_project.cpp)
+   target_include_directories(${_target} PRIVATE ${LV_PROJECT_DIR})
+   target_link_libraries(${_target} PRIVATE versa)
+
+   if (LV_ARGS_COMPILE_DEFINITIONS)
+      target_compile_definitions(${_target} PRIVATE 
+         _VERSA_PROJECT_NAMESPACE=${LV_NAMESPACE}
+         _VERSA_PROJECT_MAJOR_VERSION=${LV_MAJOR}
+         _VERSA_PROJECT_MINOR_VERSION=${LV_MINOR}
+         _VERSA_PROJECT_PATCH_VERSION=${LV_PATCH}
+         _VERSA_PROJECT_TWEAK_VERSION=${LV_TWEAK}
+         _VERSA_PROJECT_SUFFIX=${LV_SUFFIX}
+         _VERSA_PROJECT_GIT_HASH=${LV_GIT_HASH}
+         _VERSA_PROJECT_USE_SUFFIX=${LV_USE_SUFFIX}
+         _VERSA_PROJECT_USE_GIT_HASH=${LV_USE_GIT_HASH}
+      )
+   endif()
+
+   # Headers with configuration macros, like check.hpp and trace.hpp, stay out so sources can still set them; C sources get none.
+   if ((LV_ARGS_PRECOMPILE OR LIBVERSA_PRECOMPILE_HEADERS) AND NOT CMAKE_VERSION VERSION_LESS 3.16)
+      target_precompile_headers(${_target} PRIVATE
+         $<$<COMPILE_LANGUAGE:CXX>:<versa/constants.hpp$<ANGLE-R>>
+         $<$<COMPILE_LANGUAGE:CXX>:<versa/cpu_features.hpp$<ANGLE-R>>
+         $<$<COMPILE_LANGUAGE:CXX>:<versa/versions.hpp$<ANGLE-R>>
+      )
+   endif()
+
+   if (LV_ARGS_ELF_NOTE)
+      set(LV_NOTE_SOURCE ${CMAKE_CURRENT_BINARY_DIR}/${_target}_versa_build_note.cpp)
+      configure_file(${_VERSA_LIST_DIR}/include/versa/build_note.cpp.in ${LV_NOTE_SOURCE} @ONLY)
+      target_sources(${_target} PRIVATE ${LV_NOTE_SOURCE})
+   endif()
 
    #get_target_property(LV_INCLUDES versa INCLUDE_DIRECTORIES)
    #list(APPEND LV_INCLUDES ${CMAKE_CURRENT_BINARY_DIR}/include)
@@ -0,0 +1,83 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <mutex>
+#include <shared_mutex>
+
+#include <versa/atomic.hpp>
+
+using namespace versa::util;
+
+namespace {
+   // What we had: a shared_mutex around the value, whose reader count every read writes.
+   template <typename T>
+   struct shared_mutex_guarded {
+      mutable std::shared_mutex mutex;
+      T value;
+
+      T load() const {
+         std::shared_lock<std::shared_mutex> lock(mutex);
+         return value;
+      }
+   };
+}
+
+TEST_CASE("Atomic Benchmarks", "[atomic_benchmarks]") {
+   constexpr int reads = 1000;
+   const fixed_bytes<16> token("0123456789abcdef");
+   const fixed_bytes<32> digest("0123456789abcdef0123456789abcdef");
+
+   shared_mutex_guarded<fixed_bytes<16>> guarded_token{{}, token};
+   shared_mutex_guarded<fixed_bytes<32>> guarded_digest{{}, digest};
+   shared_mutex_guarded<versa::info::version_info> guarded_version{{}, versa::info::version_info(1, 2, 3, 4, "rc1", "")};
+   atomic_fixed_bytes<16> atomic_token(token);
+   atomic_fixed_bytes<32> atomic_digest(digest);
+   snapshot<versa::info::version_info> version(versa::info::version_info(1, 2, 3, 4, "rc1", ""));
+
+   BENCHMARK("1000 shared_mutex fixed_bytes<16> reads") {
+      uint64_t sum = 0;
+      for (int i = 0; i < reads; ++i)
+         sum += static_cast<uint8_t>(guarded_token.load()[i & 15]);
+      return sum;
+   };
+   BENCHMARK("1000 atomic_fixed_bytes<16> reads") {
+      uint64_t sum = 0;
+      for (int i = 0; i < reads; ++i)
+         sum += static_cast<uint8_t>(atomic_token.load()[i & 15]);
+      return sum;
+   };
+   BENCHMARK("1000 shared_mutex fixed_bytes<32> reads") {
+      uint64_t sum = 0;
+      for (int i = 0; i < reads; ++i)
+         sum += static_cast<uint8_t>(guarded_digest.load()[i & 31]);
+      return sum;
+   };
+   BENCHMARK("1000 atomic_fixed_bytes<32> reads") {
+      uint64_t sum = 0;
+      for (int i = 0; i < reads; ++i)
+         sum += static_cast<uint8_t>(atomic_digest.load()[i & 31]);
+      return sum;
+   };
+   BENCHMARK("1000 shared_mutex version_info reads") {
+      uint64_t sum = 0;
+      for (int i = 0; i < reads; ++i) {
+         std::shared_lock<std::shared_mutex> lock(guarded_version.mutex);
+         sum += guarded_version.value.minor;
+      }
+      return sum;
+   };
+   BENCHMARK("1000 snapshot version_info reads") {
+      uint64_t sum = 0;
+      for (int i = 0; i < reads; ++i)
+         sum += version.read()->minor;
+      return sum;
+   };
+   BENCHMARK("atomic_fixed_bytes<16> store") {
+      atomic_token.store(token);
+      return 0;
+   };
+   BENCHMARK("snapshot version_info store") {
+      version.store(versa::info::version_info(1, 2, 3, 4, "rc1", ""));
+      return 0;
+   };
+}
@@ -0,0 +1,119 @@
+#!/usr/bin/env python3
+# Turns Catch2 benchmark results into JSON and compares two such files, to catch regressions.
+#
+#   benchmark_report.py run -o results.json <libversa_benchmarks> [catch2 arguments...]
+#   benchmark_report.py convert results.xml -o results.json
+#   benchmark_report.py compare baseline.json results.json [--threshold 5] [--strict]
+#
+# compare exits with 1 when a benchmark's mean grew by more than the threshold, in percent, and its
+# confidence interval no longer overlaps the baseline's. With --strict the mean alone decides.
+
+import argparse
+import json
+import platform
+import subprocess
+import sys
+import xml.etree.ElementTree as ET
+
+
+def parse_xml(text):
+   results = []
+   root = ET.fromstring(text)
+   for case in root.iter("TestCase"):
+      for bench in case.iter("BenchmarkResults"):
+         mean = bench.find("mean")
+         stddev = bench.find("standardDeviation")
+         results.append({
+            "test_case": case.get("name"),
+            "name": bench.get("name"),
+            "samples": int(bench.get("samples")),
+            "mean_ns": float(mean.get("value")),
+            "low_ns": float(mean.get("lowerBound")),
+            "high_ns": float(mean.get("upperBound")),
+            "stddev_ns": float(stddev.get("value")) if stddev is not None else 0.0,
+         })
+   return results
+
+
+def write_json(path, source, results):
+   with open(path, "w") as out:
+      json.dump({"source": source, "machine": platform.node(), "benchmarks": results}, out, indent=2)
+   print(f"wrote {len(results)} benchmarks to {path}")
+
+
+def run(args):
+   done = subprocess.run([args.binary, "--reporter", "xml", *args.catch_args], capture_output=True, text=True)
+   if done.returncode != 0:
+      sys.stderr.write(done.stderr)
+      return done.returncode
+   write_json(args.output, args.binary, parse_xml(done.stdout))
+   return 0
+
+
+def convert(args):
+   with open(args.xml) as f:
+      write_json(args.output, args.xml, parse_xml(f.read()))
+   return 0
+
+
+def by_key(path):
+   with open(path) as f:
+      return {f"{b['test_case']} / {b['name']}": b for b in json.load(f)["benchmarks"]}
+
+
+def compare(args):
+   baseline, current = by_key(args.baseline), by_key(args.current)
+   threshold = args.threshold / 100.0
+   regressions = 0
+   print(f"{'benchmark':<72} {'baseline':>12} {'current':>12} {'change':>8}")
+   for key, now in current.items():
+      before = baseline.get(key)
+      if before is None:
+         print(f"{key:<72} {'':>12} {now['mean_ns']:>10.1f}ns {'new':>8}")
+         continue
+      change = now["mean_ns"] / before["mean_ns"] - 1.0
+      note = ""
+      if change > threshold:
+         if args.strict or now["low_ns"] > before["high_ns"]:
+            note = "  REGRESSION"
+            regressions += 1
+         else:
+            note = "  (within noise)"
+      elif change < -threshold:
+         note = "  improved"
+      print(f"{key:<72} {before['mean_ns']:>10.1f}ns {now['mean_ns']:>10.1f}ns {change * 100:>+7.1f}%{note}")
+   for key in baseline.keys() - current.keys():
+      print(f"{key:<72} {baseline[key]['mean_ns']:>10.1f}ns {'':>12} {'missing':>8}")
+
+   print(f"{regressions} regression(s) over {args.threshold:g}%")
+   return 1 if regressions else 0
+
+
+def main():
+   parser = argparse.ArgumentParser(description="Catch2 benchmark results as JSON, and regression checks between them.")
+   commands = parser.add_subparsers(dest="command", required=True)
+
+   p = commands.add_parser("run", help="run the benchmarks and write the results as JSON")
+   p.add_argument("binary")
+   p.add_argument("-o", "--output", required=True)
+   p.add_argument("catch_args", nargs=argparse.REMAINDER, help="passed on to the benchmark binary")
+   p.set_defaults(func=run)
+
+   p = commands.add_parser("convert", help="convert the output of --reporter xml to JSON")
+   p.add_argument("xml")
+   p.add_argument("-o", "--output", required=True)
+   p.set_defaults(func=convert)
+
+   p = commands.add_parser("compare", help="flag benchmarks that got slower than the baseline")
+   p.add_argument("baseline")
+   p.add_argument("current")
+   p.add_argument("--threshold", type=float, default=5.0, help="percent, 5 by default")
+   p.add_argument("--strict", action="store_true", help="flag on the mean alone, ignoring the confidence intervals")
+   p.set_defaults(func=compare)
+
+   args = parser.parse_args()
+   return args.func(args)
+
+
+if __name__ == "__main__":
+   sys.exit(main())
@@ -0,0 +1,20 @@
+#include <catch2/catch_all.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <versa/build_note.hpp>
+
+TEST_CASE("Build Note Benchmarks", "[build_note_benchmarks]") {
+   // The benchmark binary carries a note, see benchmarks/CMakeLists.txt.
+   const std::string self = std::filesystem::read_symlink("/proc/self/exe").string();
+   const std::vector<std::string> paths(1000, self);
+
+   BENCHMARK("Read 1000 notes, 1 thread") {
+      return versa::info::scan_build_notes(paths, 1).size();
+   };
+   BENCHMARK("Read 1000 notes, all cores") {
+      return versa::info::scan_build_notes(paths).size();
+   };
+}
@@ -0,0 +1,99 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <versa/check.hpp>
+#include <versa/utils.hpp>
+
+namespace {
+   // How check(bool, std::string) used to look: the message copied by value, the throw inlined.
+   inline void legacy_check(const bool condition, std::string message) {
+      if (!condition) [[unlikely]] {
+         throw std::runtime_error(std::move(message));
+      }
+   }
+
+   // Keeps a loop scalar, as any loop with a check is, so the baselines differ only by the check.
+   inline void keep_scalar(uint64_t& value) {
+#if defined(__GNUC__) || defined(__clang__)
+      asm volatile("" : "+r"(value));
+#endif
+   }
+}
+
+TEST_CASE("Check Benchmarks", "[check_benchmarks]") {
+   std::vector<uint32_t> values(1 << 16);
+   for (std::size_t i = 0; i < values.size(); ++i)
+      values[i] = static_cast<uint32_t>(i * 2654435761u) >> 8;
+   const std::string message = "value out of range";
+
+   BENCHMARK("no check") {
+      uint64_t sum = 0;
+      for (auto v : values)
+         sum += v;
+      return sum;
+   };
+   BENCHMARK("no check, scalar") {
+      uint64_t sum = 0;
+      for (auto v : values) {
+         sum += v;
+         keep_scalar(sum);
+      }
+      return sum;
+   };
+   BENCHMARK("VERSA_CHECK") {
+      uint64_t sum = 0;
+      for (auto v : values) {
+         VERSA_CHECK(v < (1u << 24), "value {} out of range", v);
+         sum += v;
+      }
+      return sum;
+   };
+   BENCHMARK("check(bool, const char*)") {
+      uint64_t sum = 0;
+      for (auto v : values) {
+         versa::util::check(v < (1u << 24), "value out of range");
+         sum += v;
+      }
+      return sum;
+   };
+   BENCHMARK("check(bool, const std::string&)") {
+      uint64_t sum = 0;
+      for (auto v : values) {
+         versa::util::check(v < (1u << 24), message);
+         sum += v;
+      }
+      return sum;
+   };
+   // The failing path: building the exception and unwinding to the caller.
+   BENCHMARK("check(bool, const char*) failing") {
+      try {
+         versa::util::check(values.size() == 0, "value out of range");
+      } catch (const std::exception& e) {
+         return e.what()[0];
+      }
+      return '\0';
+   };
+#if VERSA_CHECK_POLICY == VERSA_CHECK_THROW
+   BENCHMARK("VERSA_CHECK failing") {
+      try {
+         VERSA_CHECK(values.size() == 0, "value {} out of range", values.size());
+      } catch (const std::exception& e) {
+         return e.what()[0];
+      }
+      return '\0';
+   };
+#endif
+   BENCHMARK("legacy check(bool, std::string)") {
+      uint64_t sum = 0;
+      for (auto v : values) {
+         legacy_check(v < (1u << 24), message);
+         sum += v;
+      }
+      return sum;
+   };
+}
@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+# Times how long the compiler takes to parse each public libversa header on its own, which is what
+# every translation unit that includes it pays. Run through the libversa_compile_benchmarks target.
+
+import argparse
+import json
+import pathlib
+import statistics
+import subprocess
+import sys
+import time
+
+
+def time_header(compiler, flags, header, repeat):
+   source = f"#include <versa/{header}>\n"
+   samples = []
+   for _ in range(repeat):
+      start = time.perf_counter()
+      done = subprocess.run([compiler, *flags, "-fsyntax-only", "-x", "c++", "-"], input=source.encode(), capture_output=True)
+      samples.append((time.perf_counter() - start) * 1000.0)
+      if done.returncode != 0:
+         sys.exit(f"{header} does not compile:\n{done.stderr.decode()}")
+   return statistics.median(samples), min(samples)
+
+
+def main():
+   parser = argparse.ArgumentParser(description=__doc__)
+   parser.add_argument("--compiler", required=True)
+   parser.add_argument("--include", action="append", default=[], help="include directory, may repeat")
+   parser.add_argument("--flag", action="append", default=[], help="extra compiler flag, may repeat")
+   parser.add_argument("--repeat", type=int, default=5)
+   parser.add_argument("--json", help="also write the results to this file")
+   parser.add_argument("headers", nargs="*", help="headers under versa/, all of them by default")
+   args = parser.parse_args()
+
+   flags = ["-std=gnu++20", *args.flag, *(f"-I{d}" for d in args.include)]
+   headers = args.headers
+   if not headers:
+      for d in args.include:
+         headers += sorted(p.name for p in pathlib.Path(d, "versa").glob("*.hpp"))
+
+   results = {}
+   print(f"{'header':<24} {'median ms':>10} {'min ms':>10}")
+   for header in headers:
+      median, best = time_header(args.compiler, flags, header, args.repeat)
+      results[header] = {"median_ms": round(median, 2), "min_ms": round(best, 2)}
+      print(f"{header:<24} {median:>10.1f} {best:>10.1f}")
+
+   if args.json:
+      with open(args.json, "w") as out:
+         json.dump({"compiler": args.compiler, "flags": flags, "headers": results}, out, indent=2)
+   return 0
+
+
+if __name__ == "__main__":
+   sys.exit(main())
@@ -0,0 +1,49 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <random>
+#include <span>
+#include <vector>
+
+#include <versa/constraints.hpp>
+#include <versa/versions.hpp>
+
+using namespace versa::info;
+
+TEST_CASE("Version Constraint Benchmarks", "[version_constraint_benchmarks]") {
+   std::mt19937 rng(42);
+   std::vector<packed_version> packed(1 << 20);
+   for (auto& p : packed)
+      packed_version::from(version_view{{rng() % 10, rng() % 100, rng() % 1000, rng() % 10}, "", ""}, p);
+   std::vector<uint64_t> keys;
+   for (const auto& p : packed)
+      keys.push_back(p.key());
+   std::vector<uint64_t> bits(packed.size() / 64);
+   const auto c = make_constraint(">=1.2.0 <2.0.0 || ^3.1 || ~5.7.2 || 8.x");
+
+   BENCHMARK("parse_constraint") {
+      version_constraint out;
+      return parse_constraint(">=1.2.0 <2.0.0 || ^3.1 || ~5.7.2 || 8.x", out) == std::errc{};
+   };
+   BENCHMARK("operator<=> per version 1M") {
+      const version_info lo1(1, 2), hi1(2), lo2(3, 1), hi2(4), lo3(5, 7, 2), hi3(5, 8), lo4(8), hi4(9);
+      std::size_t count = 0;
+      for (const auto& p : packed) {
+         const version_info v(p.major, p.minor, p.patch, p.tweak);
+         count += (v >= lo1 && v < hi1) || (v >= lo2 && v < hi2) || (v >= lo3 && v < hi3) || (v >= lo4 && v < hi4);
+      }
+      return count;
+   };
+   BENCHMARK("matches per version 1M") {
+      std::size_t count = 0;
+      for (const auto& p : packed)
+         count += c.matches(p);
+      return count;
+   };
+   BENCHMARK("match portable 1M keys") {
+      detail::match_keys_portable(c.intervals.data(), c.size, keys.data(), keys.size(), bits.data());
+      return bits[0];
+   };
+   BENCHMARK("match 1M keys") { return match(c, std::span<const uint64_t>(keys), std::span<uint64_t>(bits)); };
+   BENCHMARK("match 1M packed_version") { return match(c, std::span<const packed_version>(packed), std::span<uint64_t>(bits)); };
+}
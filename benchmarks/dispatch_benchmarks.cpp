@@ -0,0 +1,57 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+
+#include <versa/cpu_features.hpp>
+#include <versa/dispatch.hpp>
+
+using namespace versa::info;
+using namespace versa::util;
+
+namespace {
+   [[gnu::noinline]] uint64_t mix_scalar(uint64_t v) { return v * 0x9E3779B97F4A7C15ull + 1; }
+   [[gnu::noinline]] VERSA_TARGET("avx2") uint64_t mix_avx2(uint64_t v) { return v * 0x9E3779B97F4A7C15ull + 1; }
+
+   using mix_dispatch = dispatcher<
+      implementation<&mix_avx2, cpu_features::avx2, architectures::x64 | architectures::x86>,
+      implementation<&mix_scalar>>;
+
+   constexpr mix_dispatch mix;
+   uint64_t (* volatile mix_pointer)(uint64_t) = &mix_scalar;
+}
+
+#if VERSA_HAS_IFUNC
+VERSA_DEFINE_IFUNC(uint64_t, versa_bench_mix_ifunc, (uint64_t), mix_dispatch)
+#endif
+
+TEST_CASE("Dispatch Benchmarks", "[dispatch_benchmarks]") {
+   constexpr int iterations = 1000;
+   mix_dispatch::resolve();
+
+   BENCHMARK("direct call") {
+      uint64_t v = 0;
+      for (int i = 0; i < iterations; ++i) v = mix_scalar(v);
+      return v;
+   };
+
+   BENCHMARK("function pointer") {
+      uint64_t v = 0;
+      auto fn = mix_pointer;
+      for (int i = 0; i < iterations; ++i) v = fn(v);
+      return v;
+   };
+
+   BENCHMARK("dispatcher") {
+      uint64_t v = 0;
+      for (int i = 0; i < iterations; ++i) v = mix(v);
+      return v;
+   };
+
+#if VERSA_HAS_IFUNC
+   BENCHMARK("ifunc") {
+      uint64_t v = 0;
+      for (int i = 0; i < iterations; ++i) v = versa_bench_mix_ifunc(v);
+      return v;
+   };
+#endif
+}
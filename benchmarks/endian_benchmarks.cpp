@@ -0,0 +1,81 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include <arpa/inet.h>
+
+#include <versa/endian.hpp>
+
+namespace {
+   // A big-endian wire record: 4 byte id, 2 byte flags, 2 byte length, 8 byte offset.
+   constexpr std::size_t record_size = 16;
+
+   struct decoded {
+      uint32_t id;
+      uint16_t flags;
+      uint16_t length;
+      uint64_t offset;
+   };
+}
+
+TEST_CASE("Endian Benchmarks", "[endian_benchmarks]") {
+   constexpr std::size_t records = 4096;
+   std::vector<std::byte> wire(records * record_size);
+   for (std::size_t i = 0; i < wire.size(); ++i)
+      wire[i] = static_cast<std::byte>(i * 131);
+
+   BENCHMARK("Decode 4096 records, copy and ntohl") {
+      uint64_t sum = 0;
+      for (std::size_t r = 0; r < records; ++r) {
+         const std::byte* p = wire.data() + r * record_size;
+         decoded d;
+         uint32_t id; uint16_t flags, length; uint32_t hi, lo;
+         std::memcpy(&id, p, 4);
+         std::memcpy(&flags, p + 4, 2);
+         std::memcpy(&length, p + 6, 2);
+         std::memcpy(&hi, p + 8, 4);
+         std::memcpy(&lo, p + 12, 4);
+         d.id = ntohl(id);
+         d.flags = ntohs(flags);
+         d.length = ntohs(length);
+         d.offset = (uint64_t{ntohl(hi)} << 32) | ntohl(lo);
+         sum += d.id + d.flags + d.length + d.offset;
+      }
+      return sum;
+   };
+   BENCHMARK("Decode 4096 records, be views") {
+      using namespace versa::util;
+      uint64_t sum = 0;
+      for (std::size_t r = 0; r < records; ++r) {
+         const std::byte* p = wire.data() + r * record_size;
+         sum += be<const uint32_t>(p) + be<const uint16_t>(p + 4) + be<const uint16_t>(p + 6) + be<const uint64_t>(p + 8);
+      }
+      return sum;
+   };
+
+   std::vector<uint32_t> words(1 << 16);
+   for (std::size_t i = 0; i < words.size(); ++i)
+      words[i] = static_cast<uint32_t>(i * 2654435761u);
+   std::vector<uint64_t> longs(1 << 15);
+   for (std::size_t i = 0; i < longs.size(); ++i)
+      longs[i] = i * 0x9E3779B97F4A7C15ull;
+
+   BENCHMARK("Byteswap 64K uint32, portable") {
+      versa::util::detail::byteswap_portable<4>(reinterpret_cast<std::byte*>(words.data()), words.size());
+      return words[0];
+   };
+   BENCHMARK("Byteswap 64K uint32, dispatched") {
+      versa::util::byteswap(std::span<uint32_t>(words));
+      return words[0];
+   };
+   BENCHMARK("Byteswap 32K uint64, portable") {
+      versa::util::detail::byteswap_portable<8>(reinterpret_cast<std::byte*>(longs.data()), longs.size());
+      return longs[0];
+   };
+   BENCHMARK("Byteswap 32K uint64, dispatched") {
+      versa::util::byteswap(std::span<uint64_t>(longs));
+      return longs[0];
+   };
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <versa/fixed_string.hpp>
+
+using namespace versa::util;
+
+namespace {
+   // A small alphabet makes neighbouring keys share long prefixes, so compares run deep into the keys.
+   template <std::size_t N>
+   std::vector<fixed_bytes<N>> random_keys(std::size_t count, uint32_t alphabet = 4) {
+      std::mt19937 rng(42);
+      std::vector<fixed_bytes<N>> keys(count);
+      for (auto& k : keys)
+         for (auto& c : k)
+            c = static_cast<char>(rng() % alphabet);
+      return keys;
+   }
+
+   template <std::size_t N>
+   void compare_benchmarks() {
+      const auto keys = random_keys<N>(1024);
+      const std::string suffix = " N=" + std::to_string(N);
+
+      BENCHMARK("memcmp ==" + suffix) {
+         std::size_t hits = 0;
+         for (std::size_t i = 1; i < keys.size(); ++i)
+            hits += std::memcmp(keys[i - 1].data(), keys[i].data(), N) == 0;
+         return hits;
+      };
+
+      BENCHMARK("operator==" + suffix) {
+         std::size_t hits = 0;
+         for (std::size_t i = 1; i < keys.size(); ++i)
+            hits += keys[i - 1] == keys[i];
+         return hits;
+      };
+
+      BENCHMARK("memcmp <=>" + suffix) {
+         int less = 0;
+         for (std::size_t i = 1; i < keys.size(); ++i)
+            less += std::memcmp(keys[i - 1].data(), keys[i].data(), N) < 0;
+         return less;
+      };
+
+      BENCHMARK("operator<=>" + suffix) {
+         int less = 0;
+         for (std::size_t i = 1; i < keys.size(); ++i)
+            less += keys[i - 1] < keys[i];
+         return less;
+      };
+
+      // Digests are uniformly distributed, search over those.
+      const auto digests = random_keys<N>(1024, 256);
+      const std::span<const fixed_bytes<N>> view(digests);
+      const auto needle = digests.back();
+
+      BENCHMARK("memcmp linear search" + suffix) {
+         std::size_t i = 0;
+         while (i < digests.size() && std::memcmp(digests[i].data(), needle.data(), N) != 0) ++i;
+         return i;
+      };
+
+      BENCHMARK("find" + suffix) {
+         return find(view, needle) - view.begin();
+      };
+   }
+
+   template <std::size_t N>
+   void construct_copy_benchmarks() {
+      const auto keys = random_keys<N>(1024, 256);
+      const std::string text(reinterpret_cast<const char*>(keys.data()), keys.size() * sizeof(fixed_bytes<N>));
+      std::vector<fixed_bytes<N>> out(keys.size());
+      const std::string suffix = " N=" + std::to_string(N);
+
+      // The checked constructor, as used for keys read out of text or a buffer.
+      BENCHMARK("construct from string_view" + suffix) {
+         for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = fixed_bytes<N>(std::string_view(text.data() + i * sizeof(fixed_bytes<N>), N));
+         return out.back()[0];
+      };
+
+      BENCHMARK("copy" + suffix) {
+         for (std::size_t i = 0; i < out.size(); ++i)
+            out[i] = keys[i];
+         return out.back()[0];
+      };
+   }
+}
+
+TEST_CASE("Fixed Bytes Benchmarks", "[fixed_bytes_benchmarks]") {
+   compare_benchmarks<8>();
+   construct_copy_benchmarks<8>();
+   compare_benchmarks<16>();
+   construct_copy_benchmarks<16>();
+   compare_benchmarks<20>();
+   construct_copy_benchmarks<20>();
+   compare_benchmarks<32>();
+   construct_copy_benchmarks<32>();
+   compare_benchmarks<64>();
+   construct_copy_benchmarks<64>();
+}
@@ -0,0 +1,103 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <versa/fixed_string.hpp>
+#include <versa/flat_map.hpp>
+#include <versa/hash.hpp>
+
+using namespace versa::util;
+
+namespace {
+   template <std::size_t N>
+   std::vector<fixed_bytes<N>> random_keys(std::size_t count, uint32_t seed = 42) {
+      std::mt19937 rng(seed);
+      std::vector<fixed_bytes<N>> keys(count);
+      for (auto& k : keys)
+         for (auto& c : k)
+            c = static_cast<char>(rng());
+      return keys;
+   }
+
+   // The byte-at-a-time baseline most hand-rolled key hashes look like.
+   inline uint64_t fnv1a(const void* data, std::size_t size) {
+      const auto* p = static_cast<const unsigned char*>(data);
+      uint64_t h = 0xcbf29ce484222325ull;
+      for (std::size_t i = 0; i < size; ++i)
+         h = (h ^ p[i]) * 0x100000001b3ull;
+      return h;
+   }
+
+   template <std::size_t N>
+   void hash_benchmarks() {
+      const auto keys = random_keys<N>(1024);
+      const std::string suffix = " N=" + std::to_string(N);
+
+      BENCHMARK("fnv1a" + suffix) {
+         uint64_t acc = 0;
+         for (const auto& k : keys)
+            acc ^= fnv1a(k.data(), N);
+         return acc;
+      };
+
+      BENCHMARK("hash" + suffix) {
+         uint64_t acc = 0;
+         for (const auto& k : keys)
+            acc ^= hash(k);
+         return acc;
+      };
+   }
+
+   template <typename Map>
+   std::size_t lookups(const Map& map, const std::vector<fixed_bytes<32>>& probes) {
+      std::size_t hits = 0;
+      for (const auto& k : probes)
+         hits += map.find(k) != map.end();
+      return hits;
+   }
+}
+
+TEST_CASE("Hash Benchmarks", "[hash_benchmarks]") {
+   hash_benchmarks<8>();
+   hash_benchmarks<20>();
+   hash_benchmarks<32>();
+   hash_benchmarks<64>();
+   hash_benchmarks<256>();
+}
+
+TEST_CASE("Flat Map Benchmarks", "[flat_map_benchmarks]") {
+   constexpr std::size_t count = 1 << 16;
+   const auto keys   = random_keys<32>(count);
+   const auto misses = random_keys<32>(count, 7);
+
+   std::unordered_map<fixed_bytes<32>, uint32_t> unordered;
+   flat_map<fixed_bytes<32>, uint32_t> flat;
+   for (uint32_t i = 0; i < count; ++i) {
+      unordered.emplace(keys[i], i);
+      flat.emplace(keys[i], i);
+   }
+
+   BENCHMARK("unordered_map find hit") { return lookups(unordered, keys); };
+   BENCHMARK("flat_map find hit") { return lookups(flat, keys); };
+   BENCHMARK("unordered_map find miss") { return lookups(unordered, misses); };
+   BENCHMARK("flat_map find miss") { return lookups(flat, misses); };
+
+   BENCHMARK("unordered_map insert") {
+      std::unordered_map<fixed_bytes<32>, uint32_t> map;
+      for (uint32_t i = 0; i < count; ++i)
+         map.emplace(keys[i], i);
+      return map.size();
+   };
+
+   BENCHMARK("flat_map insert") {
+      flat_map<fixed_bytes<32>, uint32_t> map;
+      for (uint32_t i = 0; i < count; ++i)
+         map.emplace(keys[i], i);
+      return map.size();
+   };
+}
@@ -0,0 +1,97 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <versa/fixed_string.hpp>
+#include <versa/hex.hpp>
+
+using namespace versa::util;
+
+namespace {
+   std::vector<fixed_bytes<20>> random_hashes(std::size_t count) {
+      std::mt19937 rng(42);
+      std::vector<fixed_bytes<20>> hashes(count);
+      for (auto& h : hashes)
+         for (auto& c : h)
+            c = static_cast<char>(rng());
+      return hashes;
+   }
+}
+
+TEST_CASE("Hex Benchmarks", "[hex_benchmarks]") {
+   const auto hashes = random_hashes(4096);
+   std::string packed(40 * hashes.size(), '\0');
+   to_hex(std::span<const fixed_bytes<20>>(hashes), std::span<char>(packed));
+   std::vector<fixed_bytes<20>> decoded(hashes.size());
+   std::vector<std::byte> big(1 << 16);
+   std::string big_hex(2 * big.size(), '\0');
+
+   BENCHMARK("snprintf encode git hash") {
+      char out[41];
+      std::size_t total = 0;
+      for (const auto& h : hashes) {
+         for (std::size_t i = 0; i < 20; ++i)
+            std::snprintf(out + 2 * i, 3, "%02x", static_cast<unsigned>(static_cast<uint8_t>(h[i])));
+         total += static_cast<unsigned char>(out[0]);
+      }
+      return total;
+   };
+
+   BENCHMARK("scalar encode git hash") {
+      for (std::size_t i = 0; i < hashes.size(); ++i)
+         detail::hex_encode_scalar(packed.data() + 40 * i, hashes[i].bytes(), 20);
+      return packed[0];
+   };
+
+   BENCHMARK("to_hex git hash") {
+      to_hex(std::span<const fixed_bytes<20>>(hashes), std::span<char>(packed));
+      return packed[0];
+   };
+
+   BENCHMARK("sscanf decode git hash") {
+      std::size_t total = 0;
+      for (std::size_t i = 0; i < hashes.size(); ++i) {
+         for (std::size_t j = 0; j < 20; ++j) {
+            unsigned v = 0;
+            std::sscanf(packed.data() + 40 * i + 2 * j, "%2x", &v);
+            decoded[i][j] = static_cast<char>(v);
+         }
+         total += static_cast<unsigned char>(decoded[i][0]);
+      }
+      return total;
+   };
+
+   BENCHMARK("scalar decode git hash") {
+      bool ok = true;
+      for (std::size_t i = 0; i < hashes.size(); ++i)
+         ok &= detail::hex_decode_scalar(reinterpret_cast<std::byte*>(decoded[i].data()), packed.data() + 40 * i, 20);
+      return ok;
+   };
+
+   BENCHMARK("from_hex git hash") {
+      return from_hex(packed, std::span<fixed_bytes<20>>(decoded));
+   };
+
+   BENCHMARK("scalar encode 64KiB") {
+      detail::hex_encode_scalar(big_hex.data(), big.data(), big.size());
+      return big_hex[0];
+   };
+
+   BENCHMARK("hex_encode 64KiB") {
+      hex_encode(big_hex.data(), big.data(), big.size());
+      return big_hex[0];
+   };
+
+   BENCHMARK("scalar decode 64KiB") {
+      return detail::hex_decode_scalar(big.data(), big_hex.data(), big.size());
+   };
+
+   BENCHMARK("hex_decode 64KiB") {
+      return hex_decode(big.data(), big_hex.data(), big.size());
+   };
+}
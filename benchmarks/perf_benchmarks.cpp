@@ -0,0 +1,48 @@
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <cstdint>
+
+#include <versa/perf.hpp>
+
+TEST_CASE("Perf Benchmarks", "[perf_benchmarks]") {
+   constexpr int reads = 1000;
+   versa::perf::cycle_clock::calibrate();
+
+   BENCHMARK("1000 steady_clock::now") {
+      int64_t sum = 0;
+      for (int i = 0; i < reads; ++i)
+         sum += std::chrono::steady_clock::now().time_since_epoch().count();
+      return sum;
+   };
+   BENCHMARK("1000 cycle_clock::ticks") {
+      uint64_t sum = 0;
+      for (int i = 0; i < reads; ++i)
+         sum += versa::perf::cycle_clock::ticks();
+      return sum;
+   };
+   BENCHMARK("1000 cycle_clock::ticks_ordered") {
+      uint64_t sum = 0;
+      for (int i = 0; i < reads; ++i)
+         sum += versa::perf::cycle_clock::ticks_ordered();
+      return sum;
+   };
+   BENCHMARK("1000 cycle_clock::now") {
+      int64_t sum = 0;
+      for (int i = 0; i < reads; ++i)
+         sum += versa::perf::cycle_clock::now().time_since_epoch().count();
+      return sum;
+   };
+
+   versa::perf::latency_histogram histogram;
+   BENCHMARK("1000 histogram records") {
+      for (uint64_t i = 0; i < reads; ++i)
+         histogram.record(i * 7919);
+      return histogram.count();
+   };
+   BENCHMARK("1000 scoped_stopwatch") {
+      for (int i = 0; i < reads; ++i)
+         versa::perf::scoped_stopwatch watch(histogram);
+      return histogram.count();
+   };
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <versa/record_table.hpp>
+
+using namespace versa::util;
+
+namespace {
+   using digest_t = fixed_bytes<32>;
+   using meta_t   = fixed_bytes<16>;
+
+   struct digest_hash {
+      std::size_t operator()(const digest_t& d) const noexcept {
+         return std::hash<std::string_view>{}(std::string_view(d.data(), d.size()));
+      }
+   };
+
+   digest_t make_digest(std::mt19937_64& rng) {
+      digest_t d;
+      for (std::size_t i = 0; i < 32; i += 8) {
+         const uint64_t r = rng();
+         std::memcpy(d._data + i, &r, 8);
+      }
+      return d;
+   }
+}
+
+TEST_CASE("Record Table Benchmarks", "[record_table_benchmarks]") {
+   constexpr std::size_t count = 1 << 20;
+   constexpr std::size_t lookups = 1000;
+   const auto dir = std::filesystem::temp_directory_path();
+   const std::string sorted_path = (dir / "versa_bench_sorted.tbl").string();
+   const std::string eytzinger_path = (dir / "versa_bench_eytzinger.tbl").string();
+
+   std::mt19937_64 rng(42);
+   std::vector<digest_t> digests(count);
+   for (auto& d : digests)
+      d = make_digest(rng);
+   meta_t meta;
+   std::memset(meta._data, 7, sizeof(meta._data));
+
+   for (const auto& [path, layout] : {std::pair{sorted_path, record_layout::sorted}, std::pair{eytzinger_path, record_layout::eytzinger}}) {
+      record_table_builder<digest_t, meta_t> builder(path, {layout});
+      for (const auto& d : digests)
+         builder.add(d, meta);
+      builder.finish();
+   }
+
+   std::vector<digest_t> probes(lookups);
+   for (auto& p : probes)
+      p = digests[rng() % count];
+
+   BENCHMARK("1M digests into std::unordered_map") {
+      std::unordered_map<digest_t, meta_t, digest_hash> map;
+      map.reserve(count);
+      for (const auto& d : digests)
+         map.emplace(d, meta);
+      return map.size();
+   };
+   BENCHMARK("1M digest record_table open") {
+      record_table<digest_t, meta_t> table(eytzinger_path.c_str());
+      return table.size();
+   };
+
+   std::unordered_map<digest_t, meta_t, digest_hash> map;
+   for (const auto& d : digests)
+      map.emplace(d, meta);
+   const record_table<digest_t, meta_t> sorted(sorted_path.c_str());
+   const record_table<digest_t, meta_t> eytzinger(eytzinger_path.c_str());
+   std::vector<const meta_t*> found(lookups);
+
+   BENCHMARK("1000 std::unordered_map finds") {
+      std::size_t hits = 0;
+      for (const auto& p : probes)
+         hits += map.find(p) != map.end();
+      return hits;
+   };
+   BENCHMARK("1000 sorted record_table finds") {
+      std::size_t hits = 0;
+      for (const auto& p : probes)
+         hits += sorted.find(p) != nullptr;
+      return hits;
+   };
+   BENCHMARK("1000 sorted record_table batched finds") {
+      sorted.find_batch(probes, found);
+      return found[0];
+   };
+   BENCHMARK("1000 eytzinger record_table finds") {
+      std::size_t hits = 0;
+      for (const auto& p : probes)
+         hits += eytzinger.find(p) != nullptr;
+      return hits;
+   };
+   BENCHMARK("1000 eytzinger record_table batched finds") {
+      eytzinger.find_batch(probes, found);
+      return found[0];
+   };
+
+   std::filesystem::remove(sorted_path);
+   std::filesystem::remove(eytzinger_path);
+}
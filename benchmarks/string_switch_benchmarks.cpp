@@ -0,0 +1,57 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstddef>
+#include <random>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include <versa/string_switch.hpp>
+
+using namespace versa::util;
+
+namespace {
+   constexpr std::string_view names[] = {"get", "put", "del", "scan", "incr", "decr", "append", "expire", "ttl",
+                                         "ping", "auth", "select", "flush", "keys", "exists", "rename", "mget", "mset"};
+
+   // The usual hand-written dispatch: compare against each name in turn.
+   std::size_t compare_chain(std::string_view s) {
+      for (std::size_t i = 0; i < std::size(names); ++i)
+         if (s == names[i])
+            return i;
+      return std::size(names);
+   }
+}
+
+TEST_CASE("String Switch Benchmarks", "[string_switch_benchmarks]") {
+   std::mt19937 rng(42);
+   std::vector<std::string> commands;
+   for (std::size_t i = 0; i < 4096; ++i)
+      commands.emplace_back(rng() % 8 ? names[rng() % std::size(names)] : "unknown");
+   std::unordered_map<std::string_view, std::size_t> map;
+   for (std::size_t i = 0; i < std::size(names); ++i)
+      map.emplace(names[i], i);
+
+   BENCHMARK("compare chain 4096 commands") {
+      std::size_t sum = 0;
+      for (const auto& c : commands)
+         sum += compare_chain(c);
+      return sum;
+   };
+   BENCHMARK("unordered_map 4096 commands") {
+      std::size_t sum = 0;
+      for (const auto& c : commands) {
+         const auto it = map.find(c);
+         sum += it == map.end() ? std::size(names) : it->second;
+      }
+      return sum;
+   };
+   BENCHMARK("string_switch 4096 commands") {
+      std::size_t sum = 0;
+      for (const auto& c : commands)
+         sum += string_switch<"get", "put", "del", "scan", "incr", "decr", "append", "expire", "ttl", "ping",
+                              "auth", "select", "flush", "keys", "exists", "rename", "mget", "mset">(c);
+      return sum;
+   };
+}
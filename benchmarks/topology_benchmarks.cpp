@@ -0,0 +1,36 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdio>
+#include <string>
+
+#include <versa/topology.hpp>
+
+namespace {
+   // What services do today: scan /proc/cpuinfo for the processor count and the cache size.
+   std::size_t parse_proc_cpuinfo() {
+      std::FILE* file = std::fopen("/proc/cpuinfo", "r");
+      if (!file)
+         return 0;
+      std::size_t processors = 0;
+      char line[512];
+      while (std::fgets(line, sizeof(line), file))
+         if (std::string(line).rfind("processor", 0) == 0)
+            ++processors;
+      std::fclose(file);
+      return processors;
+   }
+}
+
+TEST_CASE("Topology Benchmarks", "[topology_benchmarks]") {
+   versa::info::host_topology::get();
+
+   BENCHMARK("Parse /proc/cpuinfo") {
+      return parse_proc_cpuinfo();
+   };
+   BENCHMARK("host_topology::load") {
+      return versa::info::host_topology::load().logical_cores;
+   };
+   BENCHMARK("host_topology::get") {
+      return versa::info::host_topology::get().logical_cores;
+   };
+}
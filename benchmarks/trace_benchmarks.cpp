@@ -0,0 +1,55 @@
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#define VERSA_TRACING 1
+#include <versa/trace.hpp>
+
+namespace {
+   // The usual alternative: one mutex guarded vector shared by all threads.
+   struct mutex_logger {
+      std::mutex mutex;
+      std::vector<versa::trace::event> events;
+
+      void record(const char* name, uint64_t start, uint64_t duration) {
+         std::lock_guard<std::mutex> lock(mutex);
+         events.push_back({name, start, duration, 0, versa::trace::event_kind::scope});
+      }
+   };
+}
+
+TEST_CASE("Trace Benchmarks", "[trace_benchmarks]") {
+   constexpr int scopes = 1000;
+   mutex_logger logger;
+   logger.events.reserve(1 << 20);
+   versa::trace::drain([](const versa::trace::event&) {});
+
+   BENCHMARK("1000 untraced iterations") {
+      uint64_t sum = 0;
+      for (int i = 0; i < scopes; ++i)
+         sum += versa::trace::now();
+      return sum;
+   };
+   BENCHMARK("1000 mutex logger scopes") {
+      for (int i = 0; i < scopes; ++i) {
+         const uint64_t start = versa::trace::now();
+         logger.record("scope", start, versa::trace::now() - start);
+      }
+      logger.events.clear();
+      return logger.events.size();
+   };
+   BENCHMARK("1000 VERSA_TRACE_SCOPE") {
+      for (int i = 0; i < scopes; ++i) {
+         VERSA_TRACE_SCOPE("scope");
+      }
+      return versa::trace::drain([](const versa::trace::event&) {});
+   };
+   BENCHMARK("1000 VERSA_TRACE_COUNTER") {
+      for (int i = 0; i < scopes; ++i)
+         VERSA_TRACE_COUNTER("counter", i);
+      return versa::trace::drain([](const versa::trace::event&) {});
+   };
+}
@@ -0,0 +1,160 @@
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <versa/constants.hpp>
+#include <versa/versions.hpp>
+
+using namespace versa::info;
+
+namespace {
+   std::string make_manifest(std::size_t count) {
+      std::mt19937 rng(42);
+      std::string text;
+      for (std::size_t i = 0; i < count; ++i) {
+         const version_info v(rng() % 10, rng() % 100, rng() % 1000, rng() % 10, rng() % 2 ? "rc" + std::to_string(rng() % 9) : "",
+                              rng() % 2 ? "4b825dc642cb6eb9a060e54bf8d69288fbee4904" : "");
+         text += v.to_string();
+         text += '\n';
+      }
+      return text;
+   }
+
+   // What a hand-written parser usually looks like: getline, find and stoi.
+   std::size_t parse_with_stoi(const std::string& text, std::vector<version_info>& out) {
+      std::istringstream stream(text);
+      std::string line;
+      out.clear();
+      while (std::getline(stream, line)) {
+         version_info v(0);
+         std::size_t pos = 0;
+         v.major = std::stoi(line.substr(pos));
+         pos = line.find('.', pos) + 1;
+         v.minor = std::stoi(line.substr(pos));
+         pos = line.find('.', pos) + 1;
+         v.patch = std::stoi(line.substr(pos));
+         pos = line.find('.', pos) + 1;
+         v.tweak = std::stoi(line.substr(pos));
+         if (const auto dash = line.find('-'); dash != std::string::npos)
+            v.suffix = line.substr(dash + 1, line.find(' ', dash) - dash - 1);
+         if (const auto paren = line.find('('); paren != std::string::npos)
+            v.git_hash = line.substr(paren + 1, line.size() - paren - 2);
+         out.push_back(std::move(v));
+      }
+      return out.size();
+   }
+
+   // The concatenating to_string() version_info used to have, kept as the baseline.
+   std::string legacy_to_string(const version_info& v) {
+      using parts = version_info::parts;
+      const auto suffix = v.to_string<parts::suffix>().empty() ? "" : "-" + v.to_string<parts::suffix>();
+      const auto git_hash = v.to_string<parts::git_hash>().empty() ? "" : " (" + v.to_string<parts::git_hash>() + ")";
+      return v.to_string<parts::major>() + "." +
+             v.to_string<parts::minor>() + "." +
+             v.to_string<parts::patch>() + "." +
+             v.to_string<parts::tweak>() +
+             suffix + git_hash;
+   }
+
+   constexpr version_view constant_version{{1, 4, 12, 7}, "rc1", "4b825dc642cb6eb9a060e54bf8d69288fbee4904"};
+}
+
+TEST_CASE("Version Parse Benchmarks", "[version_parse_benchmarks]") {
+   constexpr std::size_t count = 100000;
+   const std::string text = make_manifest(count);
+   std::vector<version_view> views(count);
+   std::vector<version_info> infos;
+
+   BENCHMARK("getline + stoi " + std::to_string(text.size() / 1024) + " KiB") { return parse_with_stoi(text, infos); };
+
+   BENCHMARK("parse_version per line") {
+      std::size_t parsed = 0, line = 0;
+      for (std::size_t nl; (nl = text.find('\n', line)) != std::string::npos; line = nl + 1)
+         parsed += parse_version(std::string_view(text).substr(line, nl - line), views[parsed]) == std::errc{};
+      return parsed;
+   };
+
+   BENCHMARK("parse_versions portable") { return detail::parse_versions_portable(text, views).parsed; };
+   BENCHMARK("parse_versions") { return parse_versions(text, views).parsed; };
+}
+
+TEST_CASE("Version Format Benchmarks", "[version_format_benchmarks]") {
+   const version_info v(1, 4, 12, 7, "rc1", "4b825dc642cb6eb9a060e54bf8d69288fbee4904");
+   char buffer[128];
+
+   BENCHMARK("legacy to_string") { return legacy_to_string(v).size(); };
+   BENCHMARK("to_string") { return v.to_string().size(); };
+   BENCHMARK("snprintf") {
+      return std::snprintf(buffer, sizeof(buffer), "%u.%u.%u.%u-%s (%s)", unsigned(v.major), unsigned(v.minor), unsigned(v.patch),
+                           unsigned(v.tweak), v.suffix.c_str(), v.git_hash.c_str());
+   };
+   BENCHMARK("format_to") { return v.format_to(buffer) - buffer; };
+   BENCHMARK("version_string") {
+      const auto text = versa::util::to_string_view(version_string<constant_version>);
+      return text.data() + text.size();
+   };
+}
+
+TEST_CASE("Version Compare Benchmarks", "[version_compare_benchmarks]") {
+   std::mt19937 rng(42);
+   const char* suffixes[] = {"", "", "rc.1", "beta"};
+   std::vector<version_info> infos;
+   for (std::size_t i = 0; i < 4096; ++i)
+      infos.emplace_back(rng() % 4, rng() % 4, rng() % 4, rng() % 4, suffixes[rng() % 4], "");
+
+   BENCHMARK("4096 version_info number") {
+      uint64_t sum = 0;
+      for (const auto& v : infos)
+         sum += v.number();
+      return sum;
+   };
+   BENCHMARK("4096 version_info <=>") {
+      std::size_t less = 0;
+      for (std::size_t i = 1; i < infos.size(); ++i)
+         less += infos[i - 1] < infos[i];
+      return less;
+   };
+}
+
+TEST_CASE("Version Sort Benchmarks", "[version_sort_benchmarks]") {
+   // Each run sorts a fresh copy, the copy benchmark is the part of every result that is not sorting.
+   std::mt19937 rng(42);
+   const std::string_view suffixes[] = {"", "", "", "rc.1", "rc.2", "beta"};
+   std::vector<packed_version> packed(1 << 20);
+   for (auto& p : packed)
+      packed_version::from(version_view{{rng() % 10, rng() % 100, rng() % 1000, rng() % 10}, suffixes[rng() % 6], ""}, p);
+   std::vector<version_info> infos;
+   for (std::size_t i = 0; i < (1 << 18); ++i)
+      infos.push_back(packed[i].to_version_info());
+
+   BENCHMARK("copy 1M packed_version") {
+      auto copy = packed;
+      return copy.size();
+   };
+   BENCHMARK("std::sort 1M packed_version") {
+      auto copy = packed;
+      std::sort(copy.begin(), copy.end());
+      return copy.size();
+   };
+   BENCHMARK("sort_versions 1M packed_version") {
+      auto copy = packed;
+      sort_versions(std::span<packed_version>(copy));
+      return copy.size();
+   };
+   BENCHMARK("std::sort 256K version_info") {
+      auto copy = infos;
+      std::sort(copy.begin(), copy.end());
+      return copy.size();
+   };
+   BENCHMARK("sort_versions 256K version_info") {
+      auto copy = infos;
+      sort_versions(std::span<version_info>(copy));
+      return copy.size();
+   };
+}
@@ -0,0 +1,428 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+#include "constants.hpp"
+#include "cpu_features.hpp"
+#include "fixed_string.hpp"
+#include "topology.hpp"
+
+#if (VERSA_X64_BUILD) || (VERSA_X86_BUILD)
+   #if defined(_MSC_VER)
+      #include <intrin.h>
+   #endif
+   #include <immintrin.h>
+#endif
+
+/**
+ * VERSA_HAS_CAS128 is 1 where atomic_fixed_bytes can use a 16 byte compare and swap: cmpxchg16b on
+ * x64, casp or an ldaxp/stlxp loop (whichever the compiler targets) on ARM64.
+ */
+#if (VERSA_X64_BUILD) && (defined(__GNUC__) || defined(__clang__) || defined(_MSC_VER))
+   #define VERSA_HAS_CAS128 1
+#elif (VERSA_ARM64_BUILD) && (defined(__GNUC__) || defined(__clang__))
+   #define VERSA_HAS_CAS128 1
+#else
+   #define VERSA_HAS_CAS128 0
+#endif
+
+namespace versa::util {
+   namespace detail {
+      /**
+       * @brief Tells the core that the thread is spinning, so a sibling hyperthread gets the pipeline.
+       */
+      inline void cpu_relax() noexcept {
+#if (VERSA_X64_BUILD) || (VERSA_X86_BUILD)
+         _mm_pause();
+#elif (VERSA_ARM64_BUILD) && (defined(__GNUC__) || defined(__clang__))
+         __asm__ volatile("yield");
+#else
+         std::this_thread::yield();
+#endif
+      }
+
+      struct alignas(16) words128 {
+         uint64_t lo;
+         uint64_t hi;
+      };
+
+#if VERSA_HAS_CAS128
+      /**
+       * @brief Replaces `*ptr` with `desired` if it equals `expected`, otherwise loads it into
+       * `expected`. Sequentially consistent.
+       */
+      inline bool cas128(words128* ptr, words128& expected, words128 desired) noexcept {
+   #if (VERSA_X64_BUILD) && defined(_MSC_VER) && !defined(__clang__)
+         return _InterlockedCompareExchange128(reinterpret_cast<volatile long long*>(ptr),
+                                               static_cast<long long>(desired.hi), static_cast<long long>(desired.lo),
+                                               reinterpret_cast<long long*>(&expected)) != 0;
+   #elif (VERSA_X64_BUILD)
+         bool ok;
+         __asm__ __volatile__("lock cmpxchg16b %[mem]"
+                              : "=@ccz"(ok), [mem] "+m"(*ptr), "+a"(expected.lo), "+d"(expected.hi)
+                              : "b"(desired.lo), "c"(desired.hi)
+                              : "memory");
+         return ok;
+   #else
+         unsigned __int128 e = (static_cast<unsigned __int128>(expected.hi) << 64) | expected.lo;
+         const unsigned __int128 d = (static_cast<unsigned __int128>(desired.hi) << 64) | desired.lo;
+         const bool ok = __atomic_compare_exchange_n(reinterpret_cast<unsigned __int128*>(ptr), &e, d, false,
+                                                     __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST);
+         expected = {static_cast<uint64_t>(e), static_cast<uint64_t>(e >> 64)};
+         return ok;
+   #endif
+      }
+
+      /**
+       * @brief Loads 16 bytes atomically. Processors with AVX make aligned 16 byte SSE loads atomic,
+       * which leaves the cache line shared between readers; elsewhere this is a compare and swap that
+       * writes back what it read.
+       */
+      inline words128 load128(words128* ptr) noexcept {
+   #if (VERSA_X64_BUILD)
+         if (info::has_features(info::host_cpu_features(), info::cpu_features::avx2)) {
+      #if defined(_MSC_VER) && !defined(__clang__)
+            const __m128i v = _mm_load_si128(reinterpret_cast<const __m128i*>(ptr));
+            _ReadWriteBarrier();
+      #else
+            __m128i v;
+            __asm__ __volatile__("movdqa %1, %0" : "=x"(v) : "m"(*ptr) : "memory");
+      #endif
+            words128 result;
+            std::memcpy(&result, &v, sizeof(result));
+            return result;
+         }
+   #endif
+         words128 expected = {0, 0};
+         cas128(ptr, expected, expected);
+         return expected;
+      }
+#endif
+   } // namespace detail
+
+   /**
+    * @brief A fixed_bytes that threads read and replace atomically, e.g. a token swapped while
+    * workers read it on every request.
+    *
+    * Up to 8 bytes it is a std::atomic<uint64_t>; up to 16 bytes a 16 byte compare and swap where
+    * VERSA_HAS_CAS128. Larger values use a seqlock: readers never write shared memory, and retry in
+    * the rare case that a store overlapped their copy; writers exclude only each other.
+    */
+   template <std::size_t N, typename B = std::byte>
+   class atomic_fixed_bytes {
+      public:
+         using value_type = fixed_bytes<N, B>;
+         static_assert(std::is_trivially_copyable_v<value_type>);
+
+         /**
+          * @brief Whether load() and store() are single atomic instructions rather than a seqlock.
+          */
+         constexpr static inline bool is_always_lock_free = N <= 8 || (N <= 16 && VERSA_HAS_CAS128);
+
+         inline atomic_fixed_bytes() noexcept : atomic_fixed_bytes(value_type{}) {}
+
+         explicit inline atomic_fixed_bytes(const value_type& value) noexcept {
+            if constexpr (storage == storage_kind::seqlock) {
+               uint64_t words[word_count] = {};
+               std::memcpy(words, value.bytes(), N);
+               for (std::size_t i = 0; i < word_count; ++i)
+                  _s.words[i].store(words[i], std::memory_order_relaxed);
+            } else {
+               _s.words = to_words(value);
+            }
+         }
+
+         atomic_fixed_bytes(const atomic_fixed_bytes&) = delete;
+         atomic_fixed_bytes& operator=(const atomic_fixed_bytes&) = delete;
+
+         inline value_type load() const noexcept {
+            if constexpr (storage == storage_kind::word) {
+               return from_words(_s.words.load(std::memory_order_acquire));
+            } else if constexpr (storage == storage_kind::cas128) {
+               return from_words(detail::load128(&_s.words));
+            } else {
+               value_type result;
+               for (;;) {
+                  const uint64_t seq = _s.seq.load(std::memory_order_acquire);
+                  if (seq & 1) {
+                     detail::cpu_relax();
+                     continue;
+                  }
+                  copy_out(result);
+                  std::atomic_thread_fence(std::memory_order_acquire);
+                  if (_s.seq.load(std::memory_order_relaxed) == seq)
+                     return result;
+               }
+            }
+         }
+
+         inline operator value_type() const noexcept { return load(); }
+
+         inline void store(const value_type& value) noexcept { exchange(value); }
+
+         inline atomic_fixed_bytes& operator=(const value_type& value) noexcept {
+            store(value);
+            return *this;
+         }
+
+         inline value_type exchange(const value_type& value) noexcept {
+            if constexpr (storage == storage_kind::word) {
+               return from_words(_s.words.exchange(to_words(value), std::memory_order_acq_rel));
+            } else if constexpr (storage == storage_kind::cas128) {
+               const detail::words128 desired = to_words(value);
+               detail::words128 expected = detail::load128(&_s.words);
+               while (!detail::cas128(&_s.words, expected, desired)) {}
+               return from_words(expected);
+            } else {
+               const uint64_t seq = lock();
+               value_type old;
+               copy_out(old);
+               copy_in(value);
+               _s.seq.store(seq + 2, std::memory_order_release);
+               return old;
+            }
+         }
+
+         /**
+          * @brief Stores `desired` if the value equals `expected`, otherwise loads it into `expected`.
+          * @return Whether the value was replaced.
+          */
+         inline bool compare_exchange(value_type& expected, const value_type& desired) noexcept {
+            if constexpr (storage == storage_kind::word) {
+               uint64_t e = to_words(expected);
+               const bool ok = _s.words.compare_exchange_strong(e, to_words(desired), std::memory_order_acq_rel);
+               expected = from_words(e);
+               return ok;
+            } else if constexpr (storage == storage_kind::cas128) {
+               detail::words128 e = to_words(expected);
+               const bool ok = detail::cas128(&_s.words, e, to_words(desired));
+               expected = from_words(e);
+               return ok;
+            } else {
+               const uint64_t seq = lock();
+               value_type current;
+               copy_out(current);
+               if (current == expected) {
+                  copy_in(desired);
+                  _s.seq.store(seq + 2, std::memory_order_release);
+                  return true;
+               }
+               // Nothing changed, so readers that overlapped the lock need not retry.
+               _s.seq.store(seq, std::memory_order_release);
+               expected = current;
+               return false;
+            }
+         }
+
+      private:
+         enum class storage_kind { word, cas128, seqlock };
+         constexpr static inline storage_kind storage = N <= 8 ? storage_kind::word
+                                                      : N <= 16 && VERSA_HAS_CAS128 ? storage_kind::cas128
+                                                      : storage_kind::seqlock;
+         constexpr static inline std::size_t word_count = (N + 7) / 8;
+
+         inline static auto to_words(const value_type& value) noexcept {
+            if constexpr (storage == storage_kind::word) {
+               uint64_t words = 0;
+               std::memcpy(&words, value.bytes(), N);
+               return words;
+            } else {
+               detail::words128 words = {0, 0};
+               std::memcpy(&words, value.bytes(), N);
+               return words;
+            }
+         }
+
+         template <typename W>
+         inline static value_type from_words(const W& words) noexcept {
+            value_type result;
+            std::memcpy(result._data, &words, N);
+            return result;
+         }
+
+         // Seqlock writers: an odd sequence marks a store in progress.
+         inline uint64_t lock() noexcept {
+            uint64_t seq = _s.seq.load(std::memory_order_relaxed);
+            for (;;) {
+               if (!(seq & 1) && _s.seq.compare_exchange_weak(seq, seq + 1, std::memory_order_acquire, std::memory_order_relaxed))
+                  break;
+               detail::cpu_relax();
+               seq = _s.seq.load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_release);
+            return seq;
+         }
+
+         // Unrolled, so the words stay in registers: going through a buffer of 8 byte stores that the
+         // copy then reads with 16 byte loads would stall on store forwarding.
+         inline void copy_out(value_type& value) const noexcept {
+            uint64_t words[word_count];
+            [&]<std::size_t... I>(std::index_sequence<I...>) {
+               ((words[I] = _s.words[I].load(std::memory_order_relaxed)), ...);
+            }(std::make_index_sequence<word_count>{});
+            std::memcpy(value._data, words, N);
+         }
+
+         inline void copy_in(const value_type& value) noexcept {
+            uint64_t words[word_count] = {};
+            std::memcpy(words, value.bytes(), N);
+            for (std::size_t i = 0; i < word_count; ++i)
+               _s.words[i].store(words[i], std::memory_order_relaxed);
+         }
+
+         struct word_storage {
+            std::atomic<uint64_t> words;
+         };
+
+         struct cas128_storage {
+            detail::words128 words;
+         };
+
+         struct seqlock_storage {
+            std::atomic<uint64_t> seq{0};
+            std::atomic<uint64_t> words[word_count];
+         };
+
+         mutable std::conditional_t<storage == storage_kind::word, word_storage,
+                 std::conditional_t<storage == storage_kind::cas128, cas128_storage, seqlock_storage>> _s;
+   };
+
+   namespace detail {
+      /**
+       * @brief A small number unique to the calling thread, handed out in order of first use.
+       */
+      inline std::size_t thread_slot() noexcept {
+         static std::atomic<std::size_t> next{0};
+         thread_local const std::size_t slot = next.fetch_add(1, std::memory_order_relaxed);
+         return slot;
+      }
+   } // namespace detail
+
+   /**
+    * @brief An RCU style published value: readers get the current T without locks, and a store
+    * replaces it and frees the old one after the last reader of it is done.
+    *
+    * Readers count themselves in one of `Shards` cache line sized slots chosen by thread, so reads
+    * on different cores do not share a line. A store waits for the readers of the old value, so it
+    * must not be called by a thread that holds a guard of the same snapshot.
+    * ```
+    * snapshot<version_info> active(version_info(1, 2, 3, 4, "rc1"));
+    * if (auto v = active.read(); v->major < 2) ...
+    * active.store(version_info(2, 0, 0, 0));
+    * ```
+    */
+   template <typename T, std::size_t Shards = 64>
+   class snapshot {
+      static_assert(Shards > 0);
+
+      struct alignas(info::hardware_destructive_interference_size) shard {
+         std::atomic<int64_t> readers[2] = {0, 0};
+      };
+
+      public:
+         /**
+          * @brief Keeps the value it was read from alive until destroyed.
+          */
+         class guard {
+            public:
+               inline guard(guard&& other) noexcept : _value(other._value), _readers(std::exchange(other._readers, nullptr)) {}
+               guard(const guard&) = delete;
+               guard& operator=(const guard&) = delete;
+               guard& operator=(guard&&) = delete;
+
+               inline ~guard() {
+                  if (_readers)
+                     _readers->fetch_sub(1, std::memory_order_release);
+               }
+
+               inline const T& operator*() const noexcept { return *_value; }
+               inline const T* operator->() const noexcept { return _value; }
+               inline const T* get() const noexcept { return _value; }
+
+            private:
+               friend class snapshot;
+               inline guard(const T* value, std::atomic<int64_t>* readers) noexcept : _value(value), _readers(readers) {}
+
+               const T* _value;
+               std::atomic<int64_t>* _readers;
+         };
+
+         explicit inline snapshot(T value = T{}) : _current(new T(std::move(value))) {}
+
+         snapshot(const snapshot&) = delete;
+         snapshot& operator=(const snapshot&) = delete;
+
+         inline ~snapshot() { delete _current.load(std::memory_order_relaxed); }
+
+         /**
+          * @brief The current value; it stays valid while the guard lives, even if replaced meanwhile.
+          */
+         inline guard read() const noexcept {
+            shard& s = _shards[detail::thread_slot() % Shards];
+            std::atomic<int64_t>& readers = s.readers[_epoch.load(std::memory_order_seq_cst) & 1];
+            readers.fetch_add(1, std::memory_order_seq_cst);
+            return guard(_current.load(std::memory_order_seq_cst), &readers);
+         }
+
+         inline T load() const { return *read(); }
+
+         /**
+          * @brief Publishes `value`, then waits for the readers of the previous one and frees it.
+          */
+         inline void store(T value) {
+            T* next = new T(std::move(value));
+            std::lock_guard<std::mutex> lock(_writer);
+            publish(next);
+         }
+
+         /**
+          * @brief Read, copy, update: calls `f(T&)` on a copy of the current value and publishes the
+          * copy. Concurrent updates are serialized, so none is lost.
+          */
+         template <typename F>
+         inline void update(F&& f) {
+            std::lock_guard<std::mutex> lock(_writer);
+            T* next = new T(*_current.load(std::memory_order_relaxed));
+            try {
+               f(*next);
+            } catch (...) {
+               delete next;
+               throw;
+            }
+            publish(next);
+         }
+
+      private:
+         inline void publish(T* next) noexcept {
+            const T* old = _current.exchange(next, std::memory_order_seq_cst);
+            // Any reader of `old` counted itself before the exchange, so it is in one of the two
+            // counters. Flipping the epoch first sends new readers to the other counter, so each wait
+            // only covers readers that were already running.
+            for (int i = 0; i < 2; ++i) {
+               const uint64_t epoch = _epoch.fetch_add(1, std::memory_order_seq_cst) & 1;
+               for (const shard& s : _shards) {
+                  for (unsigned spins = 0; s.readers[epoch].load(std::memory_order_seq_cst) != 0; ++spins) {
+                     if (spins < 64)
+                        detail::cpu_relax();
+                     else
+                        std::this_thread::yield();
+                  }
+               }
+            }
+            delete old;
+         }
+
+         std::atomic<T*> _current;
+         alignas(info::hardware_destructive_interference_size) std::atomic<uint64_t> _epoch{0};
+         std::mutex _writer;
+         mutable shard _shards[Shards];
+   };
+} // namespace versa::util
@@ -0,0 +1,307 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "constants.hpp"
+#include "endian.hpp"
+#include "mmap.hpp"
+
+namespace versa::info {
+   constexpr inline uint32_t build_note_magic  = 0x56525341; /**< "VRSA" */
+   constexpr inline uint32_t build_note_layout = 1;
+   constexpr inline uint32_t build_note_type   = 0x56455201; /**< The ELF note type, under the owner "versa" */
+   constexpr inline char build_note_owner[]    = "versa";
+
+   /**
+    * @brief The fixed 128 byte record of the build_info and version of a binary, kept in an ELF note.
+    *
+    * Every field is a 32 bit word or a character array, so the record needs no padding and is read
+    * back on any host: the words are in the byte order of the target, which `magic` reveals.
+    */
+   struct build_note {
+      uint32_t magic = build_note_magic;
+      uint32_t layout = build_note_layout;
+      uint32_t version_high = 0;      /**< The top half of version_t::key() */
+      uint32_t version_low = 0;       /**< The bottom half of version_t::key() */
+      uint32_t arch = 0;              /**< architectures */
+      uint32_t os = 0;                /**< operating_systems */
+      uint32_t compiler = 0;          /**< compilers */
+      uint32_t compiler_version = 0;
+      uint32_t language = 0;          /**< languages */
+      uint32_t build = 0;             /**< build_types */
+      uint32_t endianess = 0;         /**< endianesses */
+      uint32_t reserved = 0;
+      char suffix_text[32] = {};      /**< Nul padded, truncated to 31 characters */
+      char git_hash_text[48] = {};    /**< Nul padded, truncated to 47 characters */
+
+      constexpr inline uint64_t key() const noexcept { return (uint64_t{version_high} << 32) | version_low; }
+
+      constexpr inline version_t version() const noexcept {
+         const uint64_t k = key();
+         return version_t{(k >> 48) & 0xFFFF, (k >> 32) & 0xFFFF, (k >> 16) & 0xFFFF, k & 0xFFFF};
+      }
+
+      constexpr inline std::string_view suffix() const noexcept {
+         return std::string_view(suffix_text, std::find(suffix_text, suffix_text + sizeof(suffix_text) - 1, '\0') - suffix_text);
+      }
+
+      constexpr inline std::string_view git_hash() const noexcept {
+         return std::string_view(git_hash_text, std::find(git_hash_text, git_hash_text + sizeof(git_hash_text) - 1, '\0') - git_hash_text);
+      }
+
+      inline version_info to_version_info() const {
+         const version_t v = version();
+         return version_info(v.major, v.minor, v.patch, v.tweak, suffix(), git_hash());
+      }
+
+      constexpr inline build_info info() const noexcept {
+         return build_info{static_cast<architectures>(arch), static_cast<endianesses>(endianess),
+                           static_cast<operating_systems>(os), static_cast<compilers>(compiler), compiler_version,
+                           static_cast<languages>(language), static_cast<build_types>(build)};
+      }
+   };
+
+   static_assert(sizeof(build_note) == 128 && std::is_trivially_copyable_v<build_note>);
+
+   /**
+    * @brief A complete ELF note: header, owner name and the build_note descriptor, 4 byte aligned.
+    */
+   struct elf_build_note {
+      uint32_t name_size = sizeof(build_note_owner);
+      uint32_t desc_size = sizeof(build_note);
+      uint32_t type = build_note_type;
+      char name[8] = {'v', 'e', 'r', 's', 'a', '\0', '\0', '\0'};
+      build_note desc;
+   };
+
+   static_assert(sizeof(elf_build_note) == 20 + sizeof(build_note));
+
+   /**
+    * @brief Builds the note of this translation unit's build_info and the given version.
+    */
+   constexpr inline elf_build_note make_elf_build_note(uint16_t major, uint16_t minor, uint16_t patch, uint16_t tweak,
+                                                       std::string_view suffix, std::string_view git_hash,
+                                                       const build_info& info = current_build_info) noexcept {
+      elf_build_note note;
+      const uint64_t key = version_t{major, minor, patch, tweak}.key();
+      note.desc.version_high     = static_cast<uint32_t>(key >> 32);
+      note.desc.version_low      = static_cast<uint32_t>(key);
+      note.desc.arch             = static_cast<uint32_t>(info.arch);
+      note.desc.os               = static_cast<uint32_t>(info.os);
+      note.desc.compiler         = static_cast<uint32_t>(info.compiler);
+      note.desc.compiler_version = static_cast<uint32_t>(info.compiler_version);
+      note.desc.language         = static_cast<uint32_t>(info.language);
+      note.desc.build            = static_cast<uint32_t>(info.build);
+      note.desc.endianess        = static_cast<uint32_t>(info.endianess);
+      std::copy_n(suffix.begin(), std::min(suffix.size(), sizeof(note.desc.suffix_text) - 1), note.desc.suffix_text);
+      std::copy_n(git_hash.begin(), std::min(git_hash.size(), sizeof(note.desc.git_hash_text) - 1), note.desc.git_hash_text);
+      return note;
+   }
+
+   namespace detail {
+      struct elf_reader {
+         const std::byte* data;
+         std::size_t size;
+         bool big;
+
+         template <typename T>
+         inline T read(uint64_t offset) const noexcept {
+            return big ? util::load_endian<T, std::endian::big>(data + offset)
+                       : util::load_endian<T, std::endian::little>(data + offset);
+         }
+
+         inline bool contains(uint64_t offset, uint64_t length) const noexcept {
+            return offset <= size && length <= size - offset;
+         }
+      };
+
+      /**
+       * @brief Looks for the versa note among the notes in [offset, offset + length).
+       */
+      inline bool find_note_in(const elf_reader& elf, uint64_t offset, uint64_t length, uint64_t align, build_note& out) noexcept {
+         if (!elf.contains(offset, length))
+            return false;
+         align = align == 8 ? 8 : 4;
+         const uint64_t end = offset + length;
+         auto padded = [align](uint64_t n) { return (n + align - 1) & ~(align - 1); };
+         while (offset + 12 <= end) {
+            const uint64_t name_size = elf.read<uint32_t>(offset);
+            const uint64_t desc_size = elf.read<uint32_t>(offset + 4);
+            const uint32_t type      = elf.read<uint32_t>(offset + 8);
+            const uint64_t name_at   = offset + 12;
+            const uint64_t desc_at   = name_at + padded(name_size);
+            if (desc_at > end || desc_size > end - desc_at)
+               return false;
+            if (type == build_note_type && name_size == sizeof(build_note_owner) && desc_size >= sizeof(build_note) &&
+                std::memcmp(elf.data + name_at, build_note_owner, sizeof(build_note_owner)) == 0) {
+               std::memcpy(static_cast<void*>(&out), elf.data + desc_at, sizeof(build_note));
+               if (elf.big != (std::endian::native == std::endian::big)) {
+                  uint32_t words[12];
+                  std::memcpy(words, &out, sizeof(words));
+                  util::byteswap(std::span<uint32_t>(words));
+                  std::memcpy(static_cast<void*>(&out), words, sizeof(words));
+               }
+               if (out.magic == build_note_magic)
+                  return true;
+            }
+            offset = desc_at + padded(desc_size);
+         }
+         return false;
+      }
+   } // namespace detail
+
+   /**
+    * @brief Finds the build note in an ELF image in memory, 32 or 64 bit, of either byte order.
+    *
+    * The PT_NOTE segments are searched first, then, for objects without program headers, the
+    * SHT_NOTE sections. Nothing is loaded or relocated.
+    * @param image The bytes of the file.
+    * @param out Receives the note, converted to host byte order.
+    * @return std::errc{} if found, executable_format_error if `image` is not ELF, no_message if it has no note.
+    */
+   inline std::errc read_build_note(std::span<const std::byte> image, build_note& out) noexcept {
+      if (image.size() < 52 || std::memcmp(image.data(), "\x7f" "ELF", 4) != 0)
+         return std::errc::executable_format_error;
+      const uint8_t elf_class = static_cast<uint8_t>(image[4]);
+      const uint8_t elf_data  = static_cast<uint8_t>(image[5]);
+      if ((elf_class != 1 && elf_class != 2) || (elf_data != 1 && elf_data != 2))
+         return std::errc::executable_format_error;
+      const bool wide = elf_class == 2;
+      const detail::elf_reader elf{image.data(), image.size(), elf_data == 2};
+      if (wide && image.size() < 64)
+         return std::errc::executable_format_error;
+
+      const uint64_t phoff     = wide ? elf.read<uint64_t>(32) : elf.read<uint32_t>(28);
+      const uint64_t shoff     = wide ? elf.read<uint64_t>(40) : elf.read<uint32_t>(32);
+      const uint16_t phentsize = elf.read<uint16_t>(wide ? 54 : 42);
+      const uint16_t phnum     = elf.read<uint16_t>(wide ? 56 : 44);
+      const uint16_t shentsize = elf.read<uint16_t>(wide ? 58 : 46);
+      const uint16_t shnum     = elf.read<uint16_t>(wide ? 60 : 48);
+
+      constexpr uint32_t pt_note = 4, sht_note = 7;
+      if (phoff && elf.contains(phoff, uint64_t{phentsize} * phnum) && phentsize >= (wide ? 56 : 32)) {
+         for (uint16_t i = 0; i < phnum; ++i) {
+            const uint64_t ph = phoff + uint64_t{i} * phentsize;
+            if (elf.read<uint32_t>(ph) != pt_note)
+               continue;
+            const uint64_t offset = wide ? elf.read<uint64_t>(ph + 8)  : elf.read<uint32_t>(ph + 4);
+            const uint64_t length = wide ? elf.read<uint64_t>(ph + 32) : elf.read<uint32_t>(ph + 16);
+            const uint64_t align  = wide ? elf.read<uint64_t>(ph + 48) : elf.read<uint32_t>(ph + 28);
+            if (detail::find_note_in(elf, offset, length, align, out))
+               return std::errc{};
+         }
+      }
+      if (shoff && elf.contains(shoff, uint64_t{shentsize} * shnum) && shentsize >= (wide ? 64 : 40)) {
+         for (uint16_t i = 0; i < shnum; ++i) {
+            const uint64_t sh = shoff + uint64_t{i} * shentsize;
+            if (elf.read<uint32_t>(sh + 4) != sht_note)
+               continue;
+            const uint64_t offset = wide ? elf.read<uint64_t>(sh + 24) : elf.read<uint32_t>(sh + 16);
+            const uint64_t length = wide ? elf.read<uint64_t>(sh + 32) : elf.read<uint32_t>(sh + 20);
+            const uint64_t align  = wide ? elf.read<uint64_t>(sh + 48) : elf.read<uint32_t>(sh + 32);
+            if (detail::find_note_in(elf, offset, length, align, out))
+               return std::errc{};
+         }
+      }
+      return std::errc::no_message;
+   }
+
+   /**
+    * @brief Finds the build note in a file by mapping it read only; the file is never executed or loaded.
+    * @return std::errc{} if found, the error of open() or mmap(), or the errors of the in memory overload.
+    */
+   inline std::errc read_build_note(const char* path, build_note& out) noexcept {
+#if VERSA_HAS_MMAP
+      const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+      if (fd < 0)
+         return static_cast<std::errc>(errno);
+      struct stat st;
+      if (::fstat(fd, &st) != 0) {
+         const int error = errno;
+         ::close(fd);
+         return static_cast<std::errc>(error);
+      }
+      if (!S_ISREG(st.st_mode) || st.st_size < 52) {
+         ::close(fd);
+         return S_ISDIR(st.st_mode) ? std::errc::is_a_directory : std::errc::executable_format_error;
+      }
+      const std::size_t size = static_cast<std::size_t>(st.st_size);
+      void* map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+      ::close(fd);
+      if (map == MAP_FAILED)
+         return static_cast<std::errc>(errno);
+      const std::errc result = read_build_note(std::span<const std::byte>(static_cast<const std::byte*>(map), size), out);
+      ::munmap(map, size);
+      return result;
+#else
+      (void)path;
+      (void)out;
+      return std::errc::not_supported;
+#endif
+   }
+
+   struct build_note_result {
+      std::errc error = std::errc{};
+      build_note note;
+   };
+
+   /**
+    * @brief Reads the build notes of many files on several threads.
+    * @param paths The files to read.
+    * @param threads The number of threads, 0 for one per logical core.
+    * @return One result per path, in the same order.
+    */
+   inline std::vector<build_note_result> scan_build_notes(std::span<const std::string> paths, unsigned threads = 0) {
+      std::vector<build_note_result> results(paths.size());
+      if (threads == 0)
+         threads = std::max(1u, std::thread::hardware_concurrency());
+      threads = static_cast<unsigned>(std::min<std::size_t>(threads, paths.size()));
+      std::atomic<std::size_t> next{0};
+      auto work = [&] {
+         // Claiming small batches keeps the counter off the hot path without unbalancing the threads.
+         constexpr std::size_t batch = 16;
+         for (std::size_t begin; (begin = next.fetch_add(batch, std::memory_order_relaxed)) < paths.size();)
+            for (std::size_t i = begin; i < std::min(begin + batch, paths.size()); ++i)
+               results[i].error = read_build_note(paths[i].c_str(), results[i].note);
+      };
+      std::vector<std::thread> pool;
+      for (unsigned t = 1; t < threads; ++t)
+         pool.emplace_back(work);
+      work();
+      for (auto& thread : pool)
+         thread.join();
+      return results;
+   }
+} // namespace versa::info
+
+/**
+ * @brief VERSA_EMBED_BUILD_NOTE(major, minor, patch, tweak, "suffix", "git hash") places the build
+ * note of the translation unit in a `.note.versa` section, so it ends up in a PT_NOTE segment that
+ * read_build_note() and `readelf -n` find. Use it once per binary; versa_setup_target(... ELF_NOTE)
+ * generates that translation unit. It expands to nothing for non ELF targets.
+ */
+#if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+   #if defined(__has_attribute) && __has_attribute(retain)
+      #define VERSA_BUILD_NOTE_RETAIN , gnu::retain
+   #else
+      #define VERSA_BUILD_NOTE_RETAIN
+   #endif
+   #define VERSA_EMBED_BUILD_NOTE(...)                                                                   \
+      [[gnu::used, gnu::section(".note.versa"), gnu::aligned(4) VERSA_BUILD_NOTE_RETAIN]]                \
+      static constexpr ::versa::info::elf_build_note versa_build_note_ = ::versa::info::make_elf_build_note(__VA_ARGS__)
+#else
+   #define VERSA_EMBED_BUILD_NOTE(...) static_assert(true)
+#endif
@@ -0,0 +1,272 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include <atomic>
+#include <charconv>
+#include <source_location>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "constants.hpp"
+#include "utils.hpp"
+
+/**
+ * The action VERSA_CHECK takes when its condition is false:
+ * - VERSA_CHECK_THROW: throw a std::runtime_error with the location and message.
+ * - VERSA_CHECK_ABORT: print the location and message to stderr and abort.
+ * - VERSA_CHECK_LOG: print the location and message to stderr and continue.
+ * - VERSA_CHECK_DISABLED: do not evaluate the condition or the message arguments at all; both are still
+ *   compiled, so variables only a check uses do not become unused.
+ *
+ * VERSA_CHECK_POLICY picks one. Unless it is defined up front, it is taken from
+ * VERSA_CHECK_POLICY_DEBUG, VERSA_CHECK_POLICY_RELEASE or VERSA_CHECK_POLICY_MIN_SIZE_RELEASE according
+ * to the VERSA_*_BUILD macros; by default every build type throws except minimum size release builds,
+ * which abort and so carry no exception paths.
+ *
+ * VERSA_CHECK_COUNTERS set to 1 gives every VERSA_CHECK a relaxed atomic failure counter, see
+ * for_each_check_site(). The policy and the counters are template arguments of the failure handler,
+ * so translation units may choose differently without breaking the one definition rule.
+ */
+#define VERSA_CHECK_THROW    0
+#define VERSA_CHECK_ABORT    1
+#define VERSA_CHECK_LOG      2
+#define VERSA_CHECK_DISABLED 3
+
+#ifndef VERSA_CHECK_POLICY_DEBUG
+   #define VERSA_CHECK_POLICY_DEBUG VERSA_CHECK_THROW
+#endif
+
+#ifndef VERSA_CHECK_POLICY_RELEASE
+   #define VERSA_CHECK_POLICY_RELEASE VERSA_CHECK_THROW
+#endif
+
+#ifndef VERSA_CHECK_POLICY_MIN_SIZE_RELEASE
+   #define VERSA_CHECK_POLICY_MIN_SIZE_RELEASE VERSA_CHECK_ABORT
+#endif
+
+#ifndef VERSA_CHECK_POLICY
+   #if VERSA_DEBUG_BUILD
+      #define VERSA_CHECK_POLICY VERSA_CHECK_POLICY_DEBUG
+   #elif VERSA_MIN_SIZE_RELEASE_BUILD
+      #define VERSA_CHECK_POLICY VERSA_CHECK_POLICY_MIN_SIZE_RELEASE
+   #elif VERSA_RELEASE_BUILD
+      #define VERSA_CHECK_POLICY VERSA_CHECK_POLICY_RELEASE
+   #else
+      #define VERSA_CHECK_POLICY VERSA_CHECK_THROW
+   #endif
+#endif
+
+#ifndef VERSA_CHECK_COUNTERS
+   #define VERSA_CHECK_COUNTERS 0
+#endif
+
+namespace versa::util {
+   /**
+    * @brief The static record of one VERSA_CHECK. It is constant initialized, so it costs nothing until
+    * the check first fails, at which point it joins the list walked by for_each_check_site().
+    */
+   struct check_site {
+      constexpr inline check_site(const char* expression, std::source_location location) noexcept
+         : expression(expression), location(location) {}
+
+      check_site(const check_site&) = delete;
+      check_site& operator=(const check_site&) = delete;
+
+      inline uint64_t failures() const noexcept { return count.load(std::memory_order_relaxed); }
+
+      const char* expression;          /**< The checked condition as written */
+      std::source_location location;   /**< Where the check is */
+      std::atomic<uint64_t> count{0};  /**< Failures so far, only kept with VERSA_CHECK_COUNTERS */
+      std::atomic<bool> listed{false};
+      check_site* next = nullptr;
+   };
+
+   namespace detail {
+      constinit inline std::atomic<check_site*> check_sites{nullptr};
+
+      inline void count_check_failure(check_site& site) noexcept {
+         site.count.fetch_add(1, std::memory_order_relaxed);
+         if (!site.listed.exchange(true, std::memory_order_relaxed)) {
+            check_site* head = check_sites.load(std::memory_order_relaxed);
+            do {
+               site.next = head;
+            } while (!check_sites.compare_exchange_weak(head, &site, std::memory_order_release, std::memory_order_relaxed));
+         }
+      }
+
+      inline void append_check_arg(std::string& out, std::string_view value) { out.append(value); }
+      inline void append_check_arg(std::string& out, const char* value) { out.append(value ? value : "(null)"); }
+      inline void append_check_arg(std::string& out, const std::string& value) { out.append(value); }
+
+      template <typename T>
+      requires std::is_arithmetic_v<T>
+      inline void append_check_arg(std::string& out, T value) {
+         if constexpr (std::is_same_v<T, bool>) {
+            out.append(value ? "true" : "false");
+         } else if constexpr (std::is_same_v<T, char>) {
+            out.push_back(value);
+         } else {
+            char buffer[64];
+            const auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            out.append(buffer, result.ptr);
+         }
+      }
+
+      template <typename T>
+      requires requires(const T& t) { { t.to_string() } -> std::convertible_to<std::string>; }
+      inline void append_check_arg(std::string& out, const T& value) { out.append(value.to_string()); }
+
+      /**
+       * @brief Appends `fmt` up to its next `{}` placeholder, unescaping `{{` and `}}`.
+       * @return The rest of `fmt` after the placeholder, or an empty view if there was none.
+       */
+      inline std::string_view append_until_placeholder(std::string& out, std::string_view fmt, bool& found) {
+         found = false;
+         std::size_t i = 0;
+         while (i < fmt.size()) {
+            const char c = fmt[i];
+            if ((c == '{' || c == '}') && i + 1 < fmt.size() && fmt[i + 1] == c) {
+               out.push_back(c);
+               i += 2;
+            } else if (c == '{' && i + 1 < fmt.size() && fmt[i + 1] == '}') {
+               found = true;
+               return fmt.substr(i + 2);
+            } else {
+               out.push_back(c);
+               ++i;
+            }
+         }
+         return {};
+      }
+
+      /**
+       * @brief A small `{}` formatter for check messages, which works without <format>.
+       *
+       * Arguments may be strings, numbers, bool, char, or anything with a to_string() member. Surplus
+       * placeholders are printed as is and surplus arguments are dropped.
+       */
+      template <typename... Args>
+      inline std::string format_check_message(std::string_view fmt, const Args&... args) {
+         std::string out;
+         bool found = true;
+         if constexpr (sizeof...(Args) > 0) {
+            auto next = [&](const auto& arg) {
+               if (!found)
+                  return;
+               fmt = append_until_placeholder(out, fmt, found);
+               if (found)
+                  append_check_arg(out, arg);
+            };
+            (next(args), ...);
+         }
+         while (!fmt.empty()) {
+            fmt = append_until_placeholder(out, fmt, found);
+            if (found)
+               out.append("{}");
+         }
+         return out;
+      }
+
+      template <int Policy>
+      inline void report_check_failure(const check_site& site, const std::string& message) {
+         std::string text = site.location.file_name();
+         text += ':';
+         append_check_arg(text, site.location.line());
+         text += ": check `";
+         text += site.expression;
+         text += "` failed";
+         if (!message.empty()) {
+            text += ": ";
+            text += message;
+         }
+         if constexpr (Policy == VERSA_CHECK_THROW) {
+            throw std::runtime_error(text);
+         } else {
+            text += '\n';
+            std::fwrite(text.data(), 1, text.size(), stderr);
+            if constexpr (Policy == VERSA_CHECK_ABORT)
+               std::abort();
+         }
+      }
+
+      /**
+       * @brief The failure path of VERSA_CHECK. Everything beyond the branch lives here, out of line and
+       * in the cold section, including the formatting of the message.
+       */
+      template <int Policy, bool Counters, typename... Args>
+      VERSA_COLD void check_failed(check_site& site, std::string_view fmt, const Args&... args) {
+         if constexpr (Counters)
+            count_check_failure(site);
+         report_check_failure<Policy>(site, format_check_message(fmt, args...));
+      }
+
+      template <int Policy, bool Counters>
+      VERSA_COLD void check_failed(check_site& site) {
+         if constexpr (Counters)
+            count_check_failure(site);
+         report_check_failure<Policy>(site, std::string());
+      }
+
+      /**
+       * @brief Only named inside sizeof by a disabled VERSA_CHECK, to keep its message arguments used.
+       */
+      template <typename... Args>
+      bool unevaluated_check_args(const Args&... args);
+   } // namespace detail
+
+   /**
+    * @brief Calls `f(const check_site&)` for every VERSA_CHECK that has failed at least once while
+    * counters were enabled, most recently first listed first. Safe to call while checks are failing.
+    */
+   template <typename F>
+   inline void for_each_check_site(F&& f) {
+      for (const check_site* site = detail::check_sites.load(std::memory_order_acquire); site; site = site->next)
+         f(*site);
+   }
+
+   /**
+    * @brief A line per failed check site, `file:line: expression: count`, for logs and monitoring.
+    */
+   inline std::string check_counters_report() {
+      std::string report;
+      for_each_check_site([&](const check_site& site) {
+         report += site.location.file_name();
+         report += ':';
+         detail::append_check_arg(report, site.location.line());
+         report += ": ";
+         report += site.expression;
+         report += ": ";
+         detail::append_check_arg(report, site.failures());
+         report += '\n';
+      });
+      return report;
+   }
+} // namespace versa::util
+
+/**
+ * @brief Checks a condition and applies VERSA_CHECK_POLICY if it is false.
+ *
+ * A passing check is one predicted branch; the message is only formatted on failure.
+ * ```
+ * VERSA_CHECK(size <= capacity, "size {} exceeds capacity {}", size, capacity);
+ * ```
+ */
+#if VERSA_CHECK_POLICY == VERSA_CHECK_DISABLED
+   #define VERSA_CHECK(cond, ...) \
+      ((void)sizeof(!(cond)) __VA_OPT__(, (void)sizeof(::versa::util::detail::unevaluated_check_args(__VA_ARGS__))))
+#else
+   #define VERSA_CHECK(cond, ...)                                                                              \
+      do {                                                                                                     \
+         if (!(cond)) [[unlikely]] {                                                                           \
+            constinit static ::versa::util::check_site versa_check_site_{#cond, ::std::source_location::current()}; \
+            ::versa::util::detail::check_failed<VERSA_CHECK_POLICY, (VERSA_CHECK_COUNTERS != 0)>(              \
+               versa_check_site_ __VA_OPT__(,) __VA_ARGS__);                                                  \
+         }                                                                                                     \
+      } while (0)
+#endif
@@ -2,8 +2,16 @@
 
 #include <cstdint>
 
+#include <algorithm>
+#include <array>
 #include <bit>
+#include <charconv>
+#include <compare>
 #include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
 
 #include <versa/constants.inc>
 
@@ -28,6 +36,58 @@ namespace versa::info {
       wasm64  = 0x8000, /**< WebAssembly 64-bit architecture */
    };
 
+   constexpr inline architectures operator|(architectures a, architectures b) noexcept {
+      return static_cast<architectures>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+   }
+
+   constexpr inline architectures operator&(architectures a, architectures b) noexcept {
+      return static_cast<architectures>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+   }
+
+   /**
+    * @brief The architecture this translation unit is being compiled for.
+    */
+   constexpr inline architectures build_architecture =
+#if VERSA_X64_BUILD
+      architectures::x64;
+#elif VERSA_X86_BUILD
+      architectures::x86;
+#elif VERSA_ARM64_BUILD
+      architectures::arm64;
+#elif VERSA_ARM32_BUILD
+      architectures::arm32;
+#elif VERSA_SPARC64_BUILD
+      architectures::sparc64;
+#elif VERSA_SPARC32_BUILD
+      architectures::sparc32;
+#elif VERSA_MIPS64_BUILD
+      architectures::mips64;
+#elif VERSA_MIPS32_BUILD
+      architectures::mips32;
+#elif VERSA_PPC64_BUILD
+      architectures::ppc64;
+#elif VERSA_PPC32_BUILD
+      architectures::ppc32;
+#elif VERSA_RISCV64_BUILD
+      architectures::riscv64;
+#elif VERSA_RISCV32_BUILD
+      architectures::riscv32;
+#elif VERSA_S390X_BUILD
+      architectures::s390x;
+#elif VERSA_S390_BUILD
+      architectures::s390;
+#elif VERSA_WASM64_BUILD
+      architectures::wasm64;
+#elif VERSA_WASM32_BUILD
+      architectures::wasm32;
+#else
+      architectures::unknown;
+#endif
+
+#pragma push_macro("linux")
+#pragma push_macro("unix")
+#undef linux
+#undef unix
    enum class operating_systems : uint16_t {
       unknown = 0x0,  /**< Unknown operating system */
       windows = 0x1,  /**< Windows operating system */
@@ -40,6 +100,8 @@ namespace versa::info {
       wasi    = 0x80, /**< WebAssembly System Interface operating system */
       posix   = 0x100 /**< POSIX operating system */
    };
+#pragma pop_macro("unix")
+#pragma pop_macro("linux")
 
    enum class compilers : uint16_t {
       unknown = 0x0, /**< Unknown compiler */
@@ -66,6 +128,14 @@ namespace versa::info {
       big     = 0x2  /**< Big-endian */
    };
 
+   /**
+    * @brief The byte order of the target, taken from std::endian since VERSA_BYTE_ORDER relies on
+    * __BYTE_ORDER__, which not every compiler defines.
+    */
+   constexpr inline endianesses build_endianess =
+      std::endian::native == std::endian::little ? endianesses::little :
+      std::endian::native == std::endian::big    ? endianesses::big    : endianesses::unknown;
+
    enum class languages : uint8_t {
       unknown = 0x0, /**< Unknown language */
       c       = 0x1, /**< C language */
@@ -82,13 +152,341 @@ namespace versa::info {
       build_types build = build_types::unknown;
    };
 
+#pragma push_macro("linux")
+#pragma push_macro("unix")
+#undef linux
+#undef unix
+   /**
+    * @brief The operating system this translation unit is being compiled for.
+    */
+   constexpr inline operating_systems build_operating_system =
+#if VERSA_ANDROID_BUILD
+      operating_systems::android;
+#elif VERSA_LINUX_BUILD
+      operating_systems::linux;
+#elif VERSA_WINDOWS_BUILD
+      operating_systems::windows;
+#elif defined(__APPLE__)
+      operating_systems::macos;
+#elif VERSA_BSD_BUILD
+      operating_systems::bsd;
+#elif VERSA_WASI_BUILD
+      operating_systems::wasi;
+#elif VERSA_UNIX_BUILD
+      operating_systems::unix;
+#else
+      operating_systems::unknown;
+#endif
+#pragma pop_macro("unix")
+#pragma pop_macro("linux")
+
+   /**
+    * @brief The compiler of this translation unit; clang before gcc, since clang defines __GNUC__ too.
+    */
+   constexpr inline compilers build_compiler =
+#if VERSA_INTEL_BUILD
+      compilers::intel;
+#elif VERSA_CLANG_BUILD
+      compilers::clang;
+#elif VERSA_MSVC_BUILD
+      compilers::msvc;
+#elif VERSA_GCC_BUILD
+      compilers::gcc;
+#elif VERSA_CL430_BUILD
+      compilers::cl430;
+#else
+      compilers::unknown;
+#endif
+
+   constexpr inline build_types build_type =
+#if VERSA_TRACE_BUILD
+      build_types::trace;
+#elif VERSA_PROFILE_BUILD
+      build_types::profile;
+#elif VERSA_MIN_SIZE_RELEASE_BUILD
+      build_types::minimum_size;
+#elif VERSA_RELEASE_WITH_DEBUG_INFO
+      build_types::release_with_debug_info;
+#elif VERSA_DEBUG_BUILD
+      build_types::debug;
+#elif VERSA_RELEASE_BUILD
+      build_types::release;
+#else
+      build_types::unknown;
+#endif
+
+   /**
+    * @brief The build_info of this translation unit.
+    */
+   constexpr inline build_info current_build_info = {
+      build_architecture, build_endianess, build_operating_system, build_compiler, VERSA_COMPILER_VERSION,
+#if VERSA_CPP_BUILD
+      languages::cpp,
+#else
+      languages::c,
+#endif
+      build_type};
+
    struct version_t {
       uint64_t major : 16;
       uint64_t minor : 16;
       uint64_t patch : 16;
       uint64_t tweak : 16; 
+
+      /**
+       * @brief The canonical sort key: the four fields in big-endian order, so comparing keys as
+       * integers orders versions by major, then minor, then patch, then tweak, without collisions.
+       */
+      constexpr inline uint64_t key() const noexcept {
+         return (uint64_t{major} << 48) | (uint64_t{minor} << 32) | (uint64_t{patch} << 16) | uint64_t{tweak};
+      }
+   };
+
+   namespace detail {
+      /**
+       * @brief Orders two version suffixes by semver prerelease precedence.
+       *
+       * An empty suffix (a release) sorts after any prerelease. Otherwise the dot separated identifiers
+       * are compared in turn: numeric ones by value, numeric before alphanumeric, alphanumeric ones in
+       * ASCII order, and a prefix before the longer list.
+       */
+      constexpr inline std::strong_ordering compare_prerelease(std::string_view a, std::string_view b) noexcept {
+         if (a.empty() || b.empty())
+            return a.empty() <=> b.empty();
+         auto numeric = [](std::string_view id) {
+            if (id.empty())
+               return false;
+            for (char c : id)
+               if (c < '0' || c > '9')
+                  return false;
+            return true;
+         };
+         while (true) {
+            const std::size_t ea = a.find('.'), eb = b.find('.');
+            const std::string_view ia = a.substr(0, ea), ib = b.substr(0, eb);
+            const bool na = numeric(ia), nb = numeric(ib);
+            std::strong_ordering cmp = std::strong_ordering::equal;
+            if (na && nb) {
+               const std::string_view ta = ia.substr(std::min(ia.find_first_not_of('0'), ia.size() - 1));
+               const std::string_view tb = ib.substr(std::min(ib.find_first_not_of('0'), ib.size() - 1));
+               cmp = ta.size() <=> tb.size();
+               if (cmp == 0) cmp = ta.compare(tb) <=> 0;
+               if (cmp == 0) cmp = ia.size() <=> ib.size();
+            } else if (na != nb) {
+               cmp = na ? std::strong_ordering::less : std::strong_ordering::greater;
+            } else {
+               cmp = ia.compare(ib) <=> 0;
+            }
+            if (cmp != 0)
+               return cmp;
+            if (ea == std::string_view::npos || eb == std::string_view::npos)
+               return (ea == std::string_view::npos) == (eb == std::string_view::npos) ? std::strong_ordering::equal
+                      : ea == std::string_view::npos ? std::strong_ordering::less : std::strong_ordering::greater;
+            a.remove_prefix(ea + 1);
+            b.remove_prefix(eb + 1);
+         }
+      }
+
+      /**
+       * @brief The total order of all version types: key(), then semver prerelease precedence, then the
+       * git hash as a plain string so that only identical versions compare equal.
+       */
+      constexpr inline std::strong_ordering compare_versions(const version_t& a, std::string_view suffix_a, std::string_view hash_a,
+                                                             const version_t& b, std::string_view suffix_b, std::string_view hash_b) noexcept {
+         if (const auto cmp = a.key() <=> b.key(); cmp != 0)
+            return cmp;
+         if (const auto cmp = compare_prerelease(suffix_a, suffix_b); cmp != 0)
+            return cmp;
+         return hash_a.compare(hash_b) <=> 0;
+      }
+
+      constexpr inline std::size_t version_number_size(uint32_t v) noexcept {
+         return v < 10 ? 1 : v < 100 ? 2 : v < 1000 ? 3 : v < 10000 ? 4 : 5;
+      }
+
+      constexpr inline char* write_version_number(char* out, uint32_t v) noexcept {
+         if (std::is_constant_evaluated()) {
+            const std::size_t size = version_number_size(v);
+            for (std::size_t i = size; i > 0; --i, v /= 10)
+               out[i - 1] = static_cast<char>('0' + v % 10);
+            return out + size;
+         }
+         return std::to_chars(out, out + 5, v).ptr;
+      }
+
+      constexpr inline char* write_version_text(char* out, std::string_view text) noexcept {
+         for (char c : text) *out++ = c;
+         return out;
+      }
+
+      /**
+       * @brief The number of characters format_version() writes for these parts.
+       */
+      constexpr inline std::size_t formatted_version_size(const version_t& v, std::string_view suffix, std::string_view git_hash) noexcept {
+         return version_number_size(v.major) + version_number_size(v.minor) + version_number_size(v.patch) +
+                version_number_size(v.tweak) + 3 + (suffix.empty() ? 0 : suffix.size() + 1) +
+                (git_hash.empty() ? 0 : git_hash.size() + 3);
+      }
+
+      /**
+       * @brief Writes `major.minor.patch.tweak[-suffix][ (git_hash)]` without allocating.
+       * @return One past the last character written, no terminator is added.
+       */
+      constexpr inline char* format_version(char* out, const version_t& v, std::string_view suffix, std::string_view git_hash) noexcept {
+         out = write_version_number(out, v.major);
+         *out++ = '.';
+         out = write_version_number(out, v.minor);
+         *out++ = '.';
+         out = write_version_number(out, v.patch);
+         *out++ = '.';
+         out = write_version_number(out, v.tweak);
+         if (!suffix.empty()) {
+            *out++ = '-';
+            out = write_version_text(out, suffix);
+         }
+         if (!git_hash.empty()) {
+            *out++ = ' ';
+            *out++ = '(';
+            out = write_version_text(out, git_hash);
+            *out++ = ')';
+         }
+         return out;
+      }
+   } // namespace detail
+
+   /**
+    * @brief A parsed version whose suffix and git hash point into the parsed text instead of owning a copy.
+    */
+   struct version_view : public version_t {
+      std::string_view suffix;
+      std::string_view git_hash;
+
+      /**
+       * @brief The length of the text format_to() writes.
+       */
+      constexpr inline std::size_t formatted_size() const noexcept {
+         return detail::formatted_version_size(*this, suffix, git_hash);
+      }
+
+      /**
+       * @brief Writes the version in the to_string() format without allocating.
+       * @param out Receives formatted_size() characters, no terminator is added.
+       * @return One past the last character written.
+       */
+      constexpr inline char* format_to(char* out) const noexcept {
+         return detail::format_version(out, *this, suffix, git_hash);
+      }
+
+      constexpr inline std::strong_ordering operator<=>(const version_view& other) const noexcept {
+         return detail::compare_versions(*this, suffix, git_hash, other, other.suffix, other.git_hash);
+      }
+
+      constexpr inline bool operator==(const version_view& other) const noexcept { return (*this <=> other) == 0; }
    };
 
+   namespace detail {
+      enum version_char_class : uint8_t {
+         version_digit = 0x1, /**< 0-9 */
+         version_hash  = 0x2, /**< Alphanumerics, allowed in a git hash */
+         version_ident = 0x4  /**< Semver identifier characters plus '_', allowed in a suffix or build metadata */
+      };
+
+      // A table lookup per character keeps the scanning loops to one load and test.
+      constexpr inline auto version_char_classes = []() {
+         std::array<uint8_t, 256> table = {};
+         for (std::size_t c = 0; c < 256; ++c) {
+            const bool digit = c >= '0' && c <= '9';
+            const bool alnum = digit || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+            table[c] = (digit ? version_digit : 0) | (alnum ? version_hash : 0) |
+                       (alnum || c == '-' || c == '.' || c == '_' ? version_ident : 0);
+         }
+         return table;
+      }();
+
+      constexpr inline bool is_version_char(char c, version_char_class cls) noexcept {
+         return version_char_classes[static_cast<uint8_t>(c)] & cls;
+      }
+
+      constexpr inline std::errc parse_version_number(const char*& p, const char* end, uint16_t& out) noexcept {
+         const char* start = p;
+         uint32_t value = 0;
+         for (; p != end && is_version_char(*p, version_digit); ++p) {
+            value = value * 10 + static_cast<uint32_t>(*p - '0');
+            if (value > 0xFFFF)
+               return std::errc::result_out_of_range;
+         }
+         if (p == start)
+            return std::errc::invalid_argument;
+         out = static_cast<uint16_t>(value);
+         return std::errc{};
+      }
+   } // namespace detail
+
+   /**
+    * @brief Parses a version without allocating.
+    *
+    * Accepts the format version_info::to_string() writes, `1.2.3.4-alpha (abc123)`, and semver style
+    * strings such as `v1.2.3-rc.1+build.5`: an optional leading `v`, one to four numeric components
+    * (missing ones are 0), an optional `-suffix`, optional `+build` metadata which is discarded, and an
+    * optional ` (git_hash)`.
+    * @param text The text to parse, it has to contain nothing else.
+    * @param out Receives the version, its views point into `text`; left unchanged on failure.
+    * @return std::errc{} on success, invalid_argument for malformed text or result_out_of_range for a
+    * component above 65535.
+    */
+   constexpr inline std::errc parse_version(std::string_view text, version_view& out) noexcept {
+      const char* p   = text.data();
+      const char* end = p + text.size();
+      if (p != end && (*p == 'v' || *p == 'V'))
+         ++p;
+
+      uint16_t parts[4] = {};
+      for (std::size_t i = 0; i < 4; ++i) {
+         if (i > 0) {
+            if (p == end || *p != '.')
+               break;
+            ++p;
+         }
+         if (const auto ec = detail::parse_version_number(p, end, parts[i]); ec != std::errc{})
+            return ec;
+      }
+
+      std::string_view suffix, git_hash;
+      if (p != end && *p == '-') {
+         const char* start = ++p;
+         while (p != end && detail::is_version_char(*p, detail::version_ident)) ++p;
+         if (p == start)
+            return std::errc::invalid_argument;
+         suffix = std::string_view(start, p - start);
+      }
+      if (p != end && *p == '+') {
+         const char* start = ++p;
+         while (p != end && detail::is_version_char(*p, detail::version_ident)) ++p;
+         if (p == start)
+            return std::errc::invalid_argument;
+      }
+      if (p != end && *p == ' ') {
+         if (end - p < 4 || p[1] != '(' || end[-1] != ')')
+            return std::errc::invalid_argument;
+         const char* start = p += 2;
+         while (p != end - 1 && detail::is_version_char(*p, detail::version_hash)) ++p;
+         if (p == start)
+            return std::errc::invalid_argument;
+         git_hash = std::string_view(start, p - start);
+         ++p;
+      }
+      if (p != end)
+         return std::errc::invalid_argument;
+
+      out.major    = parts[0];
+      out.minor    = parts[1];
+      out.patch    = parts[2];
+      out.tweak    = parts[3];
+      out.suffix   = suffix;
+      out.git_hash = git_hash;
+      return std::errc{};
+   }
+
    struct version_info : public version_t {
       enum class parts : uint8_t {
          major,   /**< Major version */
@@ -105,16 +503,51 @@ namespace versa::info {
       version_info() = default;
       version_info(const version_info&) = default;
       version_info(version_info&&) = default;
+      version_info& operator=(const version_info&) = default;
+      version_info& operator=(version_info&&) = default;
 
       constexpr inline version_info(std::uint16_t major=0, std::uint16_t minor=0, std::uint16_t patch=0, std::uint16_t tweak=0, std::string_view suffix="", std::string_view git_hash="")
          : version_t(major, minor, patch, tweak), suffix(suffix), git_hash(git_hash) {}
 
+      /**
+       * @brief Orders by major, minor, patch and tweak, then by semver prerelease precedence of the
+       * suffix (so 1.0.0-rc1 < 1.0.0), then by git hash.
+       */
       constexpr inline std::strong_ordering operator<=>(const version_info& other) const noexcept {
-         return number() <=> other.number();
+         return detail::compare_versions(*this, suffix, git_hash, other, other.suffix, other.git_hash);
       }
 
+      constexpr inline bool operator==(const version_info& other) const noexcept { return (*this <=> other) == 0; }
+
+      /**
+       * @brief The numeric version, the same collision free value as key().
+       */
       constexpr inline uint64_t number() const {
-         return (major * 1000000) + (minor * 10000) + (patch * 100) + tweak;
+         return key();
+      }
+
+      /**
+       * @brief Parses a version without allocating, see parse_version() for the accepted formats.
+       * @param text The text to parse.
+       * @param out Receives the version, its views point into `text`.
+       * @return std::errc{} on success, otherwise the reason the text was rejected.
+       */
+      constexpr static inline std::errc parse(std::string_view text, version_view& out) noexcept {
+         return parse_version(text, out);
+      }
+
+      /**
+       * @brief Parses a version, see parse_version() for the accepted formats.
+       * @param text The text to parse.
+       * @param out Receives the version; left unchanged on failure.
+       * @return std::errc{} on success, otherwise the reason the text was rejected.
+       */
+      constexpr static inline std::errc parse(std::string_view text, version_info& out) {
+         version_view view{};
+         if (const auto ec = parse_version(text, view); ec != std::errc{})
+            return ec;
+         out = version_info(view.major, view.minor, view.patch, view.tweak, view.suffix, view.git_hash);
+         return std::errc{};
       }
 
       template <parts part>
@@ -155,17 +588,70 @@ namespace versa::info {
          }
       }
 
+      /**
+       * @brief The length of the text format_to() and to_string() produce.
+       */
+      constexpr inline std::size_t formatted_size() const noexcept {
+         return detail::formatted_version_size(*this, suffix, git_hash);
+      }
+
+      /**
+       * @brief Writes `major.minor.patch.tweak[-suffix][ (git_hash)]` into a caller buffer without allocating.
+       * @param out Receives formatted_size() characters, no terminator is added.
+       * @return One past the last character written.
+       */
+      constexpr inline char* format_to(char* out) const noexcept {
+         return detail::format_version(out, *this, suffix, git_hash);
+      }
+
       inline std::string to_string() const {
-         const auto suffix = to_string<parts::suffix>().empty() ? "" : "-" + to_string<parts::suffix>();
-         const auto git_hash = to_string<parts::git_hash>().empty() ? "" : " (" + to_string<parts::git_hash>() + ")";
-         return to_string<parts::major>() + "." + 
-                to_string<parts::minor>() + "." + 
-                to_string<parts::patch>() + "." + 
-                to_string<parts::tweak>() +
-                suffix + git_hash; 
+         std::string result(formatted_size(), '\0');
+         format_to(result.data());
+         return result;
       }
    };
 
 } // namespace versa::info
 
-#define VERSA_BUILD_INFO \
+#if defined(__has_include)
+   #if __has_include(<format>)
+      #include <format>
+   #endif
+#endif
+
+#if defined(__cpp_lib_format)
+namespace versa::info::detail {
+   /**
+    * @brief Formats through format_to(), so std::format("{}", version) costs no temporary strings.
+    */
+   struct version_formatter {
+      constexpr inline auto parse(std::format_parse_context& ctx) {
+         auto it = ctx.begin();
+         if (it != ctx.end() && *it != '}')
+            throw std::format_error("versions take no format specification");
+         return it;
+      }
+
+      template <typename Version, typename FormatContext>
+      inline auto format(const Version& version, FormatContext& ctx) const {
+         char buffer[128];
+         const std::size_t size = version.formatted_size();
+         if (size <= sizeof(buffer)) {
+            version.format_to(buffer);
+            return std::copy_n(buffer, size, ctx.out());
+         }
+         std::string text(size, '\0');
+         version.format_to(text.data());
+         return std::copy(text.begin(), text.end(), ctx.out());
+      }
+   };
+} // namespace versa::info::detail
+
+template <>
+struct std::formatter<versa::info::version_info, char> : versa::info::detail::version_formatter {};
+
+template <>
+struct std::formatter<versa::info::version_view, char> : versa::info::detail::version_formatter {};
+#endif
+
+#define VERSA_BUILD_INFO
@@ -0,0 +1,438 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <span>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include "constants.hpp"
+#include "cpu_features.hpp"
+#include "dispatch.hpp"
+#include "utils.hpp"
+#include "versions.hpp"
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+   #include <immintrin.h>
+#endif
+
+namespace versa::info {
+   /**
+    * @brief An inclusive range [lo, hi] of version keys, see version_t::key().
+    */
+   struct version_interval {
+      uint64_t lo;
+      uint64_t hi;
+
+      /**
+       * @brief Tests lo <= key <= hi with one subtraction and one compare.
+       */
+      constexpr inline bool contains(uint64_t key) const noexcept { return key - lo <= hi - lo; }
+
+      constexpr inline bool operator==(const version_interval&) const noexcept = default;
+   };
+
+   /**
+    * @brief A compiled version constraint such as `>=1.2.0 <2.0.0 || ^3.1`.
+    *
+    * The constraint is held as a sorted set of disjoint, non-adjacent intervals over version_t::key(),
+    * so two constraints that accept the same versions compare equal and matching needs no parsing.
+    * It ranges over the numeric parts only; suffixes and git hashes are not considered.
+    */
+   struct version_constraint {
+      constexpr static inline std::size_t max_intervals = 16;
+
+      std::array<version_interval, max_intervals> intervals = {};
+      std::size_t size = 0;
+
+      constexpr inline std::span<const version_interval> ranges() const noexcept { return {intervals.data(), size}; }
+
+      /**
+       * @brief Tests a single key; the intervals are few, so every one is tested without branching.
+       */
+      constexpr inline bool matches(uint64_t key) const noexcept {
+         bool result = false;
+         for (std::size_t i = 0; i < size; ++i)
+            result |= intervals[i].contains(key);
+         return result;
+      }
+
+      template <typename Version>
+      requires std::is_base_of_v<version_t, Version>
+      constexpr inline bool matches(const Version& v) const noexcept { return matches(v.key()); }
+
+      constexpr inline bool operator==(const version_constraint& other) const noexcept {
+         return std::equal(intervals.begin(), intervals.begin() + size, other.intervals.begin(), other.intervals.begin() + other.size);
+      }
+   };
+
+   namespace detail {
+      constexpr inline uint64_t max_version_key = ~uint64_t{0};
+
+      /**
+       * @brief A version in a constraint, where trailing parts may be missing or wildcards (`1.2`, `1.x`, `*`).
+       */
+      struct partial_version {
+         uint64_t floor = 0;    /**< The key with the missing parts as 0 */
+         std::size_t parts = 0; /**< The number of parts given before the first wildcard */
+
+         /**
+          * @brief The highest key whose part `index` is one more than this version's, minus one; e.g. for
+          * index 1, 1.2.3 gives the last key before 1.3.0. Saturates at the largest key.
+          */
+         constexpr inline uint64_t before_bump(std::size_t index) const noexcept {
+            const uint64_t unit = uint64_t{1} << (16 * (3 - index));
+            const uint64_t base = floor & ~(unit - 1);
+            return base > max_version_key - unit ? max_version_key : base + unit - 1;
+         }
+
+         /**
+          * @brief The highest key this partial version stands for, e.g. 1.2 covers up to 1.2.65535.65535.
+          */
+         constexpr inline uint64_t ceil() const noexcept {
+            return parts == 0 ? max_version_key : parts == 4 ? floor : before_bump(parts - 1);
+         }
+      };
+
+      constexpr inline bool is_wildcard(char c) noexcept { return c == 'x' || c == 'X' || c == '*'; }
+
+      constexpr inline bool is_constraint_space(char c) noexcept { return c == ' ' || c == '\t' || c == ','; }
+
+      /**
+       * @brief Parses a partial version up to the next separator, skipping a leading `v` and any
+       * prerelease or build suffix.
+       */
+      constexpr inline std::errc parse_partial_version(const char*& p, const char* end, partial_version& out) noexcept {
+         if (p != end && (*p == 'v' || *p == 'V'))
+            ++p;
+         out = {};
+         bool wildcard = false;
+         for (std::size_t i = 0; i < 4; ++i) {
+            if (i > 0) {
+               if (p == end || *p != '.')
+                  break;
+               ++p;
+            }
+            if (p != end && is_wildcard(*p)) {
+               ++p;
+               wildcard = true;
+               continue;
+            }
+            uint16_t part = 0;
+            if (const auto ec = parse_version_number(p, end, part); ec != std::errc{})
+               return ec;
+            if (wildcard)
+               return std::errc::invalid_argument;
+            out.floor |= uint64_t{part} << (16 * (3 - i));
+            ++out.parts;
+         }
+         if (p != end && (*p == '-' || *p == '+')) {
+            ++p;
+            while (p != end && is_version_char(*p, version_ident)) ++p;
+         }
+         if (p != end && !is_constraint_space(*p) && *p != '|')
+            return std::errc::invalid_argument;
+         return std::errc{};
+      }
+
+      /**
+       * @brief Parses one comparator and narrows `range` to the versions it accepts.
+       */
+      constexpr inline std::errc parse_comparator(const char*& p, const char* end, version_interval& range, bool& empty) noexcept {
+         enum class op { eq, lt, le, gt, ge, caret, tilde } kind = op::eq;
+         if (p != end && *p == '^')      { kind = op::caret; ++p; }
+         else if (p != end && *p == '~') { kind = op::tilde; ++p; }
+         else if (p != end && *p == '=') { ++p; }
+         else if (p != end && (*p == '<' || *p == '>')) {
+            const bool less = *p++ == '<';
+            const bool equal = p != end && *p == '=';
+            p += equal;
+            kind = less ? (equal ? op::le : op::lt) : (equal ? op::ge : op::gt);
+         }
+         while (p != end && *p == ' ') ++p;
+
+         partial_version v;
+         if (const auto ec = parse_partial_version(p, end, v); ec != std::errc{})
+            return ec;
+
+         // A hyphen range, `1.2.3 - 2.3`, runs from the first version to everything the second covers.
+         if (kind == op::eq) {
+            const char* q = p;
+            while (q != end && *q == ' ') ++q;
+            if (q + 1 < end && *q == '-' && q[1] == ' ') {
+               q += 2;
+               while (q != end && *q == ' ') ++q;
+               partial_version upper;
+               if (const auto ec = parse_partial_version(q, end, upper); ec != std::errc{})
+                  return ec;
+               p = q;
+               range.lo = std::max(range.lo, v.floor);
+               range.hi = std::min(range.hi, upper.ceil());
+               empty |= range.lo > range.hi;
+               return std::errc{};
+            }
+         }
+
+         uint64_t lo = 0, hi = max_version_key;
+         switch (kind) {
+            case op::eq: lo = v.floor; hi = v.ceil(); break;
+            case op::ge: lo = v.floor; break;
+            case op::le: hi = v.ceil(); break;
+            case op::gt:
+               empty |= v.ceil() == max_version_key;
+               lo = v.ceil() + 1;
+               break;
+            case op::lt:
+               empty |= v.floor == 0;
+               hi = v.floor - 1;
+               break;
+            case op::caret: {
+               // Up to the next change of the first non-zero part, or of the last given part if all are 0.
+               std::size_t index = v.parts == 0 ? 0 : v.parts - 1;
+               for (std::size_t i = 0; i < v.parts; ++i) {
+                  if ((v.floor >> (16 * (3 - i))) & 0xFFFF) {
+                     index = i;
+                     break;
+                  }
+               }
+               lo = v.floor;
+               hi = v.parts == 0 ? max_version_key : v.before_bump(index);
+               break;
+            }
+            case op::tilde:
+               lo = v.floor;
+               hi = v.parts == 0 ? max_version_key : v.before_bump(std::min<std::size_t>(v.parts - 1, 1));
+               break;
+         }
+         range.lo = std::max(range.lo, lo);
+         range.hi = std::min(range.hi, hi);
+         empty |= range.lo > range.hi;
+         return std::errc{};
+      }
+
+      /**
+       * @brief Sorts the intervals and merges the ones that overlap or touch.
+       */
+      constexpr inline std::size_t normalize_intervals(version_interval* intervals, std::size_t size) noexcept {
+         std::sort(intervals, intervals + size, [](const auto& a, const auto& b) { return a.lo < b.lo; });
+         std::size_t out = 0;
+         for (std::size_t i = 0; i < size; ++i) {
+            if (out > 0 && (intervals[out - 1].hi == max_version_key || intervals[i].lo <= intervals[out - 1].hi + 1))
+               intervals[out - 1].hi = std::max(intervals[out - 1].hi, intervals[i].hi);
+            else
+               intervals[out++] = intervals[i];
+         }
+         return out;
+      }
+   } // namespace detail
+
+   /**
+    * @brief Compiles a version constraint without allocating.
+    *
+    * The syntax follows npm style ranges: alternatives separated by `||`, each a list of comparators
+    * separated by spaces or commas that must all hold. A comparator is `=`, `<`, `<=`, `>`, `>=`, `^` or
+    * `~` followed by a version with one to four parts, where trailing parts may be omitted or written
+    * as `x` or `*`, or a hyphen range `1.2.3 - 2.0`. A bare partial version matches everything it
+    * covers, `*` or an empty alternative matches any version. Prerelease and build suffixes are
+    * accepted and ignored.
+    * @param text The constraint.
+    * @param out Receives the constraint; left unchanged on failure.
+    * @return std::errc{} on success, invalid_argument for malformed text, result_out_of_range if a part
+    * exceeds 65535, or value_too_large if the alternatives need more than max_intervals intervals.
+    */
+   constexpr inline std::errc parse_constraint(std::string_view text, version_constraint& out) noexcept {
+      std::array<version_interval, version_constraint::max_intervals> intervals = {};
+      std::size_t size = 0;
+      const char* p = text.data();
+      const char* end = p + text.size();
+      while (true) {
+         version_interval range{0, detail::max_version_key};
+         bool empty = false;
+         while (true) {
+            while (p != end && detail::is_constraint_space(*p)) ++p;
+            if (p == end || *p == '|')
+               break;
+            if (const auto ec = detail::parse_comparator(p, end, range, empty); ec != std::errc{})
+               return ec;
+         }
+         if (!empty) {
+            if (size == intervals.size())
+               return std::errc::value_too_large;
+            intervals[size++] = range;
+         }
+         if (p == end)
+            break;
+         if (p + 1 == end || p[1] != '|')
+            return std::errc::invalid_argument;
+         p += 2;
+      }
+
+      version_constraint result;
+      size = detail::normalize_intervals(intervals.data(), size);
+      std::copy(intervals.begin(), intervals.begin() + size, result.intervals.begin());
+      result.size = size;
+      out = result;
+      return std::errc{};
+   }
+
+   /**
+    * @brief Compiles a constraint during compilation; malformed text is a compile error.
+    */
+   consteval inline version_constraint compile_constraint(std::string_view text) {
+      version_constraint result;
+      if (parse_constraint(text, result) != std::errc{})
+         throw std::invalid_argument("invalid version constraint");
+      return result;
+   }
+
+   /**
+    * @brief Compiles a constraint, throwing a runtime_error if it is malformed.
+    */
+   inline version_constraint make_constraint(std::string_view text) {
+      version_constraint result;
+      util::check(parse_constraint(text, result) == std::errc{}, "invalid version constraint");
+      return result;
+   }
+
+   namespace detail {
+      using match_keys_fn = void (*)(const version_interval*, std::size_t, const uint64_t*, std::size_t, uint64_t*);
+
+      /**
+       * @brief Sets bit i of `bits` when keys[i] lies in one of the intervals; writes (count + 63) / 64
+       * words, bits past `count` are 0.
+       */
+      inline void match_keys_portable(const version_interval* intervals, std::size_t interval_count, const uint64_t* keys,
+                                      std::size_t count, uint64_t* bits) noexcept {
+         for (std::size_t word = 0; word * 64 < count; ++word) {
+            const std::size_t n = std::min<std::size_t>(64, count - word * 64);
+            uint64_t mask = 0;
+            for (std::size_t j = 0; j < n; ++j) {
+               const uint64_t key = keys[word * 64 + j];
+               bool hit = false;
+               for (std::size_t i = 0; i < interval_count; ++i)
+                  hit |= intervals[i].contains(key);
+               mask |= uint64_t{hit} << j;
+            }
+            bits[word] = mask;
+         }
+      }
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      // AVX2 has only a signed 64-bit compare, so both sides of key - lo <= hi - lo get their sign bit flipped.
+      VERSA_TARGET("avx2")
+      inline void match_keys_avx2(const version_interval* intervals, std::size_t interval_count, const uint64_t* keys,
+                                  std::size_t count, uint64_t* bits) noexcept {
+         const __m256i sign = _mm256_set1_epi64x(static_cast<long long>(uint64_t{1} << 63));
+         __m256i lo[version_constraint::max_intervals], width[version_constraint::max_intervals];
+         for (std::size_t i = 0; i < interval_count; ++i) {
+            lo[i]    = _mm256_set1_epi64x(static_cast<long long>(intervals[i].lo));
+            width[i] = _mm256_xor_si256(_mm256_set1_epi64x(static_cast<long long>(intervals[i].hi - intervals[i].lo)), sign);
+         }
+         const std::size_t full = count / 64;
+         for (std::size_t word = 0; word < full; ++word) {
+            uint64_t mask = 0;
+            for (std::size_t j = 0; j < 64; j += 4) {
+               const __m256i key = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + word * 64 + j));
+               __m256i outside = _mm256_set1_epi64x(-1);
+               for (std::size_t i = 0; i < interval_count; ++i) {
+                  const __m256i offset = _mm256_xor_si256(_mm256_sub_epi64(key, lo[i]), sign);
+                  outside = _mm256_and_si256(outside, _mm256_cmpgt_epi64(offset, width[i]));
+               }
+               mask |= uint64_t{~static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(outside))) & 0xFu} << j;
+            }
+            bits[word] = mask;
+         }
+         match_keys_portable(intervals, interval_count, keys + full * 64, count - full * 64, bits + full);
+      }
+
+      VERSA_TARGET("avx512f")
+      inline void match_keys_avx512(const version_interval* intervals, std::size_t interval_count, const uint64_t* keys,
+                                    std::size_t count, uint64_t* bits) noexcept {
+         __m512i lo[version_constraint::max_intervals], width[version_constraint::max_intervals];
+         for (std::size_t i = 0; i < interval_count; ++i) {
+            lo[i]    = _mm512_set1_epi64(static_cast<long long>(intervals[i].lo));
+            width[i] = _mm512_set1_epi64(static_cast<long long>(intervals[i].hi - intervals[i].lo));
+         }
+         const std::size_t full = count / 64;
+         for (std::size_t word = 0; word < full; ++word) {
+            uint64_t mask = 0;
+            for (std::size_t j = 0; j < 64; j += 8) {
+               const __m512i key = _mm512_loadu_si512(keys + word * 64 + j);
+               __mmask8 inside = 0;
+               for (std::size_t i = 0; i < interval_count; ++i)
+                  inside |= _mm512_cmple_epu64_mask(_mm512_sub_epi64(key, lo[i]), width[i]);
+               mask |= uint64_t{inside} << j;
+            }
+            bits[word] = mask;
+         }
+         match_keys_portable(intervals, interval_count, keys + full * 64, count - full * 64, bits + full);
+      }
+
+      using match_keys_dispatch = util::dispatcher<
+         util::implementation<&match_keys_avx512, cpu_features::avx512f, architectures::x64 | architectures::x86>,
+         util::implementation<&match_keys_avx2, cpu_features::avx2, architectures::x64 | architectures::x86>,
+         util::implementation<&match_keys_portable>>;
+#endif
+
+      inline match_keys_fn match_keys_kernel() noexcept {
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+         return match_keys_dispatch::get();
+#else
+         return &match_keys_portable;
+#endif
+      }
+
+      inline std::size_t count_matches(const uint64_t* bits, std::size_t count) noexcept {
+         std::size_t result = 0;
+         for (std::size_t i = 0; i < (count + 63) / 64; ++i)
+            result += static_cast<std::size_t>(std::popcount(bits[i]));
+         return result;
+      }
+   } // namespace detail
+
+   /**
+    * @brief Tests a batch of version keys against a constraint.
+    * @param constraint The constraint.
+    * @param keys The keys, see version_t::key().
+    * @param bits Receives bit i set when keys[i] matches; needs (keys.size() + 63) / 64 words.
+    * @return The number of matches.
+    */
+   inline std::size_t match(const version_constraint& constraint, std::span<const uint64_t> keys, std::span<uint64_t> bits) {
+      util::check(bits.size() * 64 >= keys.size(), "match: bit span too small");
+      detail::match_keys_kernel()(constraint.intervals.data(), constraint.size, keys.data(), keys.size(), bits.data());
+      return detail::count_matches(bits.data(), keys.size());
+   }
+
+   /**
+    * @brief Tests a batch of versions against a constraint.
+    *
+    * The keys are gathered a block at a time into a stack buffer and tested with the widest vector
+    * kernel the host supports, so the cost per version is a key computation and a few compares.
+    * @param constraint The constraint.
+    * @param versions version_info, version_view, packed_version or any other version_t.
+    * @param bits Receives bit i set when versions[i] matches; needs (versions.size() + 63) / 64 words.
+    * @return The number of matches.
+    */
+   template <typename Version>
+   requires std::is_base_of_v<version_t, Version>
+   inline std::size_t match(const version_constraint& constraint, std::span<const Version> versions, std::span<uint64_t> bits) {
+      util::check(bits.size() * 64 >= versions.size(), "match: bit span too small");
+      const auto kernel = detail::match_keys_kernel();
+      constexpr std::size_t block = 512;
+      uint64_t keys[block];
+      for (std::size_t first = 0; first < versions.size(); first += block) {
+         const std::size_t n = std::min(block, versions.size() - first);
+         for (std::size_t i = 0; i < n; ++i)
+            keys[i] = versions[first + i].key();
+         kernel(constraint.intervals.data(), constraint.size, keys, n, bits.data() + first / 64);
+      }
+      return detail::count_matches(bits.data(), versions.size());
+   }
+
+} // namespace versa::info
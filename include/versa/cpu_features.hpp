@@ -0,0 +1,227 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <atomic>
+
+#include <versa/constants.hpp>
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+   #if defined(_MSC_VER)
+      #include <intrin.h>
+   #else
+      #include <cpuid.h>
+   #endif
+#elif VERSA_ARM64_BUILD
+   #if defined(__linux__)
+      #include <sys/auxv.h>
+   #elif defined(__APPLE__)
+      #include <sys/sysctl.h>
+   #endif
+#endif
+
+namespace versa::info {
+   /**
+    * @brief Optional instruction set extensions of the host CPU.
+    *
+    * Unlike build_info, which describes what the binary was compiled for, these flags
+    * describe the processor the binary is currently running on. The x86 features occupy
+    * the low 16 bits and the ARM features the high 16 bits, so a set detected on one
+    * architecture never contains flags belonging to another.
+    */
+   enum class cpu_features : uint32_t {
+      none     = 0x0,     /**< No optional features */
+      sse2     = 0x1,     /**< x86 SSE2 */
+      ssse3    = 0x2,     /**< x86 SSSE3 */
+      sse42    = 0x4,     /**< x86 SSE4.2 */
+      popcnt   = 0x8,     /**< x86 POPCNT */
+      avx2     = 0x10,    /**< x86 AVX2 (with OS support for the YMM state) */
+      bmi2     = 0x20,    /**< x86 BMI2 */
+      avx512f  = 0x40,    /**< x86 AVX-512 Foundation (with OS support for the ZMM state) */
+      avx512bw = 0x80,    /**< x86 AVX-512 Byte and Word */
+      avx512vl = 0x100,   /**< x86 AVX-512 Vector Length */
+      neon     = 0x10000, /**< ARM Advanced SIMD */
+      crc32    = 0x20000, /**< ARM CRC32 instructions */
+      sve      = 0x40000  /**< ARM Scalable Vector Extension */
+   };
+
+   constexpr inline cpu_features operator|(cpu_features a, cpu_features b) noexcept {
+      return static_cast<cpu_features>(static_cast<uint32_t>(a) | static_cast<uint32_t>(b));
+   }
+
+   constexpr inline cpu_features operator&(cpu_features a, cpu_features b) noexcept {
+      return static_cast<cpu_features>(static_cast<uint32_t>(a) & static_cast<uint32_t>(b));
+   }
+
+   constexpr inline cpu_features operator~(cpu_features a) noexcept {
+      return static_cast<cpu_features>(~static_cast<uint32_t>(a));
+   }
+
+   /**
+    * @brief Checks whether every feature in `required` is present in `set`.
+    * @param set The available features.
+    * @param required The features to look for.
+    * @return true if `set` is a superset of `required`.
+    */
+   constexpr inline bool has_features(cpu_features set, cpu_features required) noexcept {
+      return (set & required) == required;
+   }
+
+   namespace detail {
+      constexpr inline uint64_t cpu_features_valid = uint64_t{1} << 63;
+
+      inline std::atomic<uint64_t> cpu_features_detected{0};             /**< Raw detection result, set once */
+      inline std::atomic<uint64_t> cpu_features_active{0};               /**< Detected features after masking */
+      inline std::atomic<uint32_t> cpu_features_mask{~uint32_t{0}};      /**< Test/override mask */
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      /**
+       * @brief Executes the cpuid instruction.
+       * @return The eax, ebx, ecx and edx registers, in that order.
+       */
+      inline std::array<uint32_t, 4> cpuid(uint32_t leaf, uint32_t subleaf = 0) noexcept {
+         std::array<uint32_t, 4> regs = {};
+   #if defined(_MSC_VER)
+         int out[4];
+         __cpuidex(out, static_cast<int>(leaf), static_cast<int>(subleaf));
+         for (std::size_t i = 0; i < 4; ++i) regs[i] = static_cast<uint32_t>(out[i]);
+   #else
+         __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+   #endif
+         return regs;
+      }
+
+      inline uint64_t xgetbv(uint32_t index) noexcept {
+   #if defined(_MSC_VER)
+         return _xgetbv(index);
+   #else
+         uint32_t lo, hi;
+         __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(index));
+         return (uint64_t{hi} << 32) | lo;
+   #endif
+      }
+
+      inline uint32_t detect_cpu_features() noexcept {
+         uint32_t features = 0;
+         const uint32_t max_leaf = cpuid(0)[0];
+         if (max_leaf < 1)
+            return features;
+
+         const auto leaf1 = cpuid(1);
+         const uint32_t ecx = leaf1[2], edx = leaf1[3];
+         if (edx & (1u << 26)) features |= static_cast<uint32_t>(cpu_features::sse2);
+         if (ecx & (1u << 9))  features |= static_cast<uint32_t>(cpu_features::ssse3);
+         if (ecx & (1u << 20)) features |= static_cast<uint32_t>(cpu_features::sse42);
+         if (ecx & (1u << 23)) features |= static_cast<uint32_t>(cpu_features::popcnt);
+
+         // AVX state has to be enabled by the OS (XCR0) before the instructions are usable.
+         const bool osxsave  = ecx & (1u << 27);
+         const uint64_t xcr0 = osxsave ? xgetbv(0) : 0;
+         const bool ymm_os   = (xcr0 & 0x6) == 0x6;
+         const bool zmm_os   = (xcr0 & 0xE6) == 0xE6;
+
+         if (max_leaf >= 7) {
+            const uint32_t ebx = cpuid(7, 0)[1];
+            if (ymm_os && (ebx & (1u << 5)))  features |= static_cast<uint32_t>(cpu_features::avx2);
+            if (ebx & (1u << 8))              features |= static_cast<uint32_t>(cpu_features::bmi2);
+            if (zmm_os && (ebx & (1u << 16))) features |= static_cast<uint32_t>(cpu_features::avx512f);
+            if (zmm_os && (ebx & (1u << 30))) features |= static_cast<uint32_t>(cpu_features::avx512bw);
+            if (zmm_os && (ebx & (1u << 31))) features |= static_cast<uint32_t>(cpu_features::avx512vl);
+         }
+         return features;
+      }
+#elif VERSA_ARM64_BUILD
+      inline uint32_t detect_cpu_features() noexcept {
+         // Advanced SIMD is mandatory on AArch64.
+         uint32_t features = static_cast<uint32_t>(cpu_features::neon);
+   #if defined(__ARM_FEATURE_CRC32)
+         features |= static_cast<uint32_t>(cpu_features::crc32);
+   #endif
+   #if defined(__ARM_FEATURE_SVE)
+         features |= static_cast<uint32_t>(cpu_features::sve);
+   #endif
+   #if defined(__linux__)
+         const unsigned long hwcap = getauxval(AT_HWCAP);
+         if (hwcap & (1ul << 7))  features |= static_cast<uint32_t>(cpu_features::crc32); // HWCAP_CRC32
+         if (hwcap & (1ul << 22)) features |= static_cast<uint32_t>(cpu_features::sve);   // HWCAP_SVE
+   #elif defined(__APPLE__)
+         int value = 0;
+         std::size_t size = sizeof(value);
+         if (sysctlbyname("hw.optional.armv8_crc32", &value, &size, nullptr, 0) == 0 && value)
+            features |= static_cast<uint32_t>(cpu_features::crc32);
+   #endif
+         return features;
+      }
+#else
+      inline uint32_t detect_cpu_features() noexcept {
+         uint32_t features = 0;
+   #if defined(__ARM_NEON)
+         features |= static_cast<uint32_t>(cpu_features::neon);
+   #endif
+         return features;
+      }
+#endif
+
+      /**
+       * @brief Slow path of host_cpu_features(), runs the detection and publishes the result.
+       *
+       * Detection is idempotent, so concurrent first callers may both run it and store the same value.
+       */
+      [[gnu::cold, gnu::noinline]] inline uint64_t refresh_cpu_features() noexcept {
+         uint64_t detected = cpu_features_detected.load(std::memory_order_relaxed);
+         if (!(detected & cpu_features_valid)) {
+            detected = cpu_features_valid | detect_cpu_features();
+            cpu_features_detected.store(detected, std::memory_order_relaxed);
+         }
+         const uint64_t active = cpu_features_valid | (detected & cpu_features_mask.load(std::memory_order_relaxed));
+         cpu_features_active.store(active, std::memory_order_relaxed);
+         return active;
+      }
+   } // namespace detail
+
+   /**
+    * @brief Gets the features of the CPU the process is running on.
+    *
+    * Detection runs once and is cached, after which this is a single relaxed atomic load.
+    * @return The detected features, restricted by any mask installed with mask_cpu_features().
+    */
+   inline cpu_features host_cpu_features() noexcept {
+      uint64_t active = detail::cpu_features_active.load(std::memory_order_relaxed);
+      if (!(active & detail::cpu_features_valid)) [[unlikely]]
+         active = detail::refresh_cpu_features();
+      return static_cast<cpu_features>(static_cast<uint32_t>(active));
+   }
+
+   /**
+    * @brief Checks whether the host CPU supports all of the given features.
+    * @param required The features to look for.
+    * @return true if every feature in `required` is available.
+    */
+   inline bool has_cpu_features(cpu_features required) noexcept {
+      return has_features(host_cpu_features(), required);
+   }
+
+   /**
+    * @brief Restricts the reported host features to `allowed`, e.g. to force a scalar code path in tests.
+    *
+    * Anything that already cached a decision based on the old features (such as a resolved dispatcher)
+    * is not affected, so masks should be installed before those are first used.
+    * @param allowed The features that may be reported.
+    * @return The previously installed mask.
+    */
+   inline cpu_features mask_cpu_features(cpu_features allowed) noexcept {
+      const auto previous = detail::cpu_features_mask.exchange(static_cast<uint32_t>(allowed), std::memory_order_relaxed);
+      detail::refresh_cpu_features();
+      return static_cast<cpu_features>(previous);
+   }
+
+   /**
+    * @brief Removes any mask installed with mask_cpu_features().
+    */
+   inline void reset_cpu_features_mask() noexcept {
+      mask_cpu_features(static_cast<cpu_features>(~uint32_t{0}));
+   }
+
+} // namespace versa::info
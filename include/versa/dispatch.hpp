@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstdint>
+
+#include <atomic>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <versa/constants.hpp>
+#include <versa/cpu_features.hpp>
+
+/**
+ * VERSA_TARGET(X) marks a function as compiled for the instruction set extension X (e.g. "avx2")
+ * regardless of the -march the rest of the translation unit uses, so that several variants of a
+ * kernel can live in one binary and be selected at runtime with versa::util::dispatcher.
+ *
+ * VERSA_HAS_IFUNC is set to 1 when the toolchain and object format support GNU indirect functions.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+   #define VERSA_TARGET(X) __attribute__((target(X)))
+#else
+   #define VERSA_TARGET(X)
+#endif
+
+#if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__)) && !defined(__ANDROID__) && (VERSA_X64_BUILD || VERSA_X86_BUILD || VERSA_ARM64_BUILD)
+   #define VERSA_HAS_IFUNC 1
+#else
+   #define VERSA_HAS_IFUNC 0
+#endif
+
+namespace versa::util {
+   /**
+    * @brief One candidate implementation of a dispatched kernel.
+    * @tparam Fn The kernel, all candidates of a dispatcher must share one function pointer type.
+    * @tparam Features The cpu_features the kernel requires.
+    * @tparam Arch The architectures the kernel is built for, unknown for portable code.
+    */
+   template <auto Fn, info::cpu_features Features = info::cpu_features::none, info::architectures Arch = info::architectures::unknown>
+   requires std::is_pointer_v<decltype(Fn)> && std::is_function_v<std::remove_pointer_t<decltype(Fn)>>
+   struct implementation {
+      using fn_type = decltype(Fn);
+
+      constexpr static inline fn_type fn = Fn;
+      constexpr static inline info::cpu_features features = Features;
+      constexpr static inline info::architectures arch = Arch;
+
+      /**
+       * @brief Checks whether this candidate can run on a host with the given features.
+       * @param host The features of the host CPU.
+       * @return true if the candidate targets the build architecture and all of its features are present.
+       */
+      constexpr static inline bool usable(info::cpu_features host) noexcept {
+         constexpr bool arch_ok = Arch == info::architectures::unknown ||
+                                  (Arch & info::build_architecture) != info::architectures::unknown;
+         return arch_ok && info::has_features(host, Features);
+      }
+   };
+
+   namespace detail {
+      template <typename Fn, typename... Impls>
+      struct dispatch_table;
+
+      template <typename R, bool NoExcept, typename... Args, typename... Impls>
+      struct dispatch_table<R(*)(Args...) noexcept(NoExcept), Impls...> {
+         using fn_type = R(*)(Args...) noexcept(NoExcept);
+
+         static_assert((std::is_same_v<typename Impls::fn_type, fn_type> && ...), "All implementations must share one signature");
+
+         static inline fn_type select(info::cpu_features host) noexcept {
+            fn_type result = nullptr;
+            (void)((Impls::usable(host) && (result = Impls::fn, true)) || ...);
+            return result;
+         }
+
+         static inline fn_type resolve() noexcept {
+            const fn_type fn = select(info::host_cpu_features());
+            target.store(fn, std::memory_order_relaxed);
+            return fn;
+         }
+
+         // The first call lands here, resolves the best candidate and replaces itself with it.
+         static R trampoline(Args... args) noexcept(NoExcept) {
+            return resolve()(std::forward<Args>(args)...);
+         }
+
+         constinit static inline std::atomic<fn_type> target{&trampoline};
+      };
+   } // namespace detail
+
+   /**
+    * @brief Runtime dispatch between several implementations of one kernel.
+    *
+    * Candidates are listed best first; the first one whose architecture matches the build and whose
+    * required cpu_features are present on the host is selected on the first call and cached, so every
+    * later call costs one relaxed atomic load and one indirect call.
+    *
+    * ```
+    * constexpr versa::util::dispatcher<
+    *    versa::util::implementation<&sum_avx2, cpu_features::avx2, architectures::x64>,
+    *    versa::util::implementation<&sum_neon, cpu_features::neon, architectures::arm64>,
+    *    versa::util::implementation<&sum_scalar>> sum;
+    * auto total = sum(data, size);
+    * ```
+    * The last candidate must be portable, requiring no features on any architecture, so that
+    * resolution can never fail.
+    */
+   template <typename... Impls>
+   struct dispatcher {
+      static_assert(sizeof...(Impls) > 0, "A dispatcher needs at least one implementation");
+
+      using fallback = std::tuple_element_t<sizeof...(Impls) - 1, std::tuple<Impls...>>;
+      static_assert(fallback::features == info::cpu_features::none && fallback::arch == info::architectures::unknown,
+                    "The last implementation of a dispatcher must be portable");
+
+      using table   = detail::dispatch_table<typename std::tuple_element_t<0, std::tuple<Impls...>>::fn_type, Impls...>;
+      using fn_type = typename table::fn_type;
+
+      /**
+       * @brief Calls the selected implementation.
+       */
+      template <typename... Ts>
+      inline decltype(auto) operator()(Ts&&... args) const {
+         return table::target.load(std::memory_order_relaxed)(std::forward<Ts>(args)...);
+      }
+
+      /**
+       * @brief Picks the implementation that would be used on a host with the given features.
+       * @param host The features to select for.
+       * @return The selected implementation, never nullptr since the last candidate is portable.
+       */
+      static inline fn_type select(info::cpu_features host) noexcept { return table::select(host); }
+
+      /**
+       * @brief Resolves the implementation for the current host now, instead of on the first call.
+       * @return The selected implementation.
+       */
+      static inline fn_type resolve() noexcept { return table::resolve(); }
+
+      /**
+       * @brief Gets the implementation calls are currently routed to, resolving it if needed.
+       */
+      static inline fn_type get() noexcept {
+         const fn_type fn = table::target.load(std::memory_order_relaxed);
+         return fn == &table::trampoline ? table::resolve() : fn;
+      }
+
+      /**
+       * @brief Forgets the cached selection so the next call resolves again, e.g. after mask_cpu_features().
+       */
+      static inline void reset() noexcept { table::target.store(&table::trampoline, std::memory_order_relaxed); }
+   };
+
+} // namespace versa::util
+
+/**
+ * Defines NAME as a GNU indirect function whose implementation is chosen by the dynamic loader from
+ * the candidates of DISPATCHER, so calls go straight to the selected kernel through the PLT/GOT.
+ * Must be used at namespace scope in exactly one translation unit, and only when VERSA_HAS_IFUNC is 1.
+ *
+ * ```
+ * using sum_dispatch = versa::util::dispatcher<...>;
+ * VERSA_DEFINE_IFUNC(int, sum, (const int*, std::size_t), sum_dispatch)
+ * ```
+ */
+#define VERSA_DEFINE_IFUNC(RET, NAME, PARAMS, DISPATCHER)                                          \
+   extern "C" [[gnu::used]] DISPATCHER::fn_type NAME##_versa_resolver() noexcept {          \
+      return DISPATCHER::select(::versa::info::host_cpu_features());                               \
+   }                                                                                              \
+   RET NAME PARAMS __attribute__((ifunc(#NAME "_versa_resolver")));
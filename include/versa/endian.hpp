@@ -0,0 +1,261 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+#include <bit>
+#include <concepts>
+#include <span>
+#include <type_traits>
+
+#include "constants.hpp"
+#include "cpu_features.hpp"
+#include "dispatch.hpp"
+#include "fixed_string.hpp"
+#include "utils.hpp"
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+   #include <immintrin.h>
+#elif defined(__ARM_NEON)
+   #include <arm_neon.h>
+#endif
+
+namespace versa::util {
+   /**
+    * @brief Reverses the bytes of an integer; std::byteswap before C++23.
+    */
+   template <std::integral T>
+   constexpr inline T byteswap(T value) noexcept {
+      using U = std::make_unsigned_t<T>;
+      U v = static_cast<U>(value);
+      if constexpr (sizeof(T) == 1) {
+         return value;
+      } else if (std::is_constant_evaluated()) {
+         U r = 0;
+         for (std::size_t i = 0; i < sizeof(T); ++i, v >>= 8)
+            r = static_cast<U>((r << 8) | (v & 0xFF));
+         return static_cast<T>(r);
+#if defined(_MSC_VER) && !defined(__clang__)
+      } else if constexpr (sizeof(T) == 2) {
+         return static_cast<T>(_byteswap_ushort(v));
+      } else if constexpr (sizeof(T) == 4) {
+         return static_cast<T>(_byteswap_ulong(v));
+      } else {
+         return static_cast<T>(_byteswap_uint64(v));
+#else
+      } else if constexpr (sizeof(T) == 2) {
+         return static_cast<T>(__builtin_bswap16(v));
+      } else if constexpr (sizeof(T) == 4) {
+         return static_cast<T>(__builtin_bswap32(v));
+      } else {
+         return static_cast<T>(__builtin_bswap64(v));
+#endif
+      }
+   }
+
+   /**
+    * @brief Loads a T stored in byte order `Order` at any alignment; a plain load when that is the host order.
+    */
+   template <std::integral T, std::endian Order>
+   inline T load_endian(const std::byte* ptr) noexcept {
+      T value;
+      std::memcpy(&value, ptr, sizeof(T));
+      if constexpr (Order != std::endian::native)
+         value = byteswap(value);
+      return value;
+   }
+
+   template <std::integral T, std::endian Order>
+   inline void store_endian(std::byte* ptr, T value) noexcept {
+      if constexpr (Order != std::endian::native)
+         value = byteswap(value);
+      std::memcpy(ptr, &value, sizeof(T));
+   }
+
+   /**
+    * @brief A T of byte order `Order` in place in a buffer, such as a field of a received wire record.
+    *
+    * It holds a pointer, not the value: reads load and swap, writes swap and store, and nothing is
+    * copied out beforehand. A const T gives a read only view. See be and le.
+    * ```
+    * const be<const uint32_t> length(packet, 4);
+    * if (length > max_length) ...
+    * ```
+    */
+   template <typename T, std::endian Order>
+   requires std::integral<std::remove_const_t<T>>
+   class endian_view {
+      public:
+         using value_type = std::remove_const_t<T>;
+         using byte_type  = std::conditional_t<std::is_const_v<T>, const std::byte, std::byte>;
+
+         explicit constexpr inline endian_view(byte_type* ptr) noexcept : _ptr(ptr) {}
+
+         /**
+          * @brief Views the field at `offset` in `bytes`, checking that it fits.
+          */
+         inline endian_view(std::span<byte_type> bytes, std::size_t offset) : _ptr(bytes.data() + offset) {
+            util::check(offset <= bytes.size() && bytes.size() - offset >= sizeof(value_type), "Field is out of range of the buffer");
+         }
+
+         endian_view(const endian_view&) = default;
+         endian_view& operator=(const endian_view&) = delete;
+
+         /**
+          * @brief Views the field at `Offset` in a fixed_bytes, checked at compile time.
+          */
+         template <std::size_t Offset, std::size_t N, typename B>
+         requires (Offset + sizeof(value_type) <= N && std::is_const_v<T>)
+         inline static endian_view at(const fixed_bytes<N,B>& data) noexcept {
+            return endian_view(data.bytes() + Offset);
+         }
+
+         template <std::size_t Offset, std::size_t N, typename B>
+         requires (Offset + sizeof(value_type) <= N && !std::is_const_v<T>)
+         inline static endian_view at(fixed_bytes<N,B>& data) noexcept {
+            return endian_view(reinterpret_cast<std::byte*>(data._data) + Offset);
+         }
+
+         inline value_type load() const noexcept { return load_endian<value_type, Order>(_ptr); }
+         inline operator value_type() const noexcept { return load(); }
+
+         inline void store(value_type value) const noexcept requires (!std::is_const_v<T>) {
+            store_endian<value_type, Order>(_ptr, value);
+         }
+
+         inline const endian_view& operator=(value_type value) const noexcept requires (!std::is_const_v<T>) {
+            store(value);
+            return *this;
+         }
+
+         constexpr inline byte_type* data() const noexcept { return _ptr; }
+
+      private:
+         byte_type* _ptr;
+   };
+
+   template <typename T>
+   using be = endian_view<T, std::endian::big>;
+
+   template <typename T>
+   using le = endian_view<T, std::endian::little>;
+
+   namespace detail {
+      template <std::size_t W>
+      using byteswap_fn = void(*)(std::byte*, std::size_t) noexcept;
+
+      template <std::size_t W>
+      using swap_word_t = std::conditional_t<W == 2, uint16_t, std::conditional_t<W == 4, uint32_t, uint64_t>>;
+
+      template <std::size_t W>
+      inline void byteswap_portable(std::byte* data, std::size_t count) noexcept {
+         for (std::size_t i = 0; i < count; ++i) {
+            swap_word_t<W> v;
+            std::memcpy(&v, data + i * W, W);
+            v = util::byteswap(v);
+            std::memcpy(data + i * W, &v, W);
+         }
+      }
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      // The shuffle that reverses every W byte lane of a 16 byte vector.
+      template <std::size_t W>
+      constexpr inline auto byteswap_shuffle = []() {
+         std::array<int8_t, 16> indices = {};
+         for (std::size_t i = 0; i < 16; ++i)
+            indices[i] = static_cast<int8_t>((i / W) * W + (W - 1 - i % W));
+         return indices;
+      }();
+
+      template <std::size_t W>
+      VERSA_TARGET("ssse3")
+      void byteswap_ssse3(std::byte* data, std::size_t count) noexcept {
+         const __m128i shuffle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(byteswap_shuffle<W>.data()));
+         const std::size_t size = count * W;
+         std::size_t i = 0;
+         for (; i + 16 <= size; i += 16) {
+            __m128i* p = reinterpret_cast<__m128i*>(data + i);
+            _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), shuffle));
+         }
+         byteswap_portable<W>(data + i, (size - i) / W);
+      }
+
+      template <std::size_t W>
+      VERSA_TARGET("avx2")
+      void byteswap_avx2(std::byte* data, std::size_t count) noexcept {
+         const __m256i shuffle = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(byteswap_shuffle<W>.data())));
+         const std::size_t size = count * W;
+         std::size_t i = 0;
+         for (; i + 64 <= size; i += 64) {
+            __m256i* p = reinterpret_cast<__m256i*>(data + i);
+            const __m256i a = _mm256_loadu_si256(p), b = _mm256_loadu_si256(p + 1);
+            _mm256_storeu_si256(p, _mm256_shuffle_epi8(a, shuffle));
+            _mm256_storeu_si256(p + 1, _mm256_shuffle_epi8(b, shuffle));
+         }
+         for (; i + 16 <= size; i += 16) {
+            __m128i* p = reinterpret_cast<__m128i*>(data + i);
+            _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), _mm256_castsi256_si128(shuffle)));
+         }
+         byteswap_portable<W>(data + i, (size - i) / W);
+      }
+
+      template <std::size_t W>
+      using byteswap_dispatch = dispatcher<
+         implementation<static_cast<byteswap_fn<W>>(&byteswap_avx2<W>), info::cpu_features::avx2, info::architectures::x64 | info::architectures::x86>,
+         implementation<static_cast<byteswap_fn<W>>(&byteswap_ssse3<W>), info::cpu_features::ssse3, info::architectures::x64 | info::architectures::x86>,
+         implementation<static_cast<byteswap_fn<W>>(&byteswap_portable<W>)>>;
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+      template <std::size_t W>
+      inline void byteswap_neon(std::byte* data, std::size_t count) noexcept {
+         const std::size_t size = count * W;
+         std::size_t i = 0;
+         for (; i + 16 <= size; i += 16) {
+            uint8_t* p = reinterpret_cast<uint8_t*>(data + i);
+            const uint8x16_t v = vld1q_u8(p);
+            if constexpr (W == 2)
+               vst1q_u8(p, vrev16q_u8(v));
+            else if constexpr (W == 4)
+               vst1q_u8(p, vrev32q_u8(v));
+            else
+               vst1q_u8(p, vrev64q_u8(v));
+         }
+         byteswap_portable<W>(data + i, (size - i) / W);
+      }
+#endif
+
+      /**
+       * @brief The bulk byteswap kernel for W byte words on this host.
+       */
+      template <std::size_t W>
+      inline byteswap_fn<W> byteswapper() noexcept {
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+         return byteswap_dispatch<W>::get();
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+         return &byteswap_neon<W>;
+#else
+         return &byteswap_portable<W>;
+#endif
+      }
+   } // namespace detail
+
+   /**
+    * @brief Reverses the bytes of every value in place, with PSHUFB on x86 and REV on ARM64.
+    */
+   template <std::integral T>
+   requires (sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)
+   inline void byteswap(std::span<T> values) noexcept {
+      detail::byteswapper<sizeof(T)>()(reinterpret_cast<std::byte*>(values.data()), values.size());
+   }
+
+   /**
+    * @brief Converts values between byte order `Order` and the host order in place; nothing happens
+    * when they are the same.
+    */
+   template <std::endian Order, std::integral T>
+   inline void convert_endian(std::span<T> values) noexcept {
+      if constexpr (Order != std::endian::native && sizeof(T) > 1)
+         byteswap(values);
+   }
+} // namespace versa::util
@@ -5,152 +5,548 @@
 #include <cstring>
 
 #include <array>
+#include <bit>
+#include <compare>
 #include <concepts>
 #include <limits>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <string_view>
 #include <type_traits>
 #include <vector>
 
+#include "constants.hpp"
+#include "cpu_features.hpp"
+#include "dispatch.hpp"
 #include "utils.hpp"
 
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+   #include <immintrin.h>
+#elif defined(__ARM_NEON)
+   #include <arm_neon.h>
+#endif
+
 namespace versa::util {
    namespace detail {
       template <typename T>
-      concept byte_type = std::is_same_v<T, std::byte> || 
-                          std::is_same_v<T, uint8_t>   || 
+      concept byte_type = std::is_same_v<T, std::byte> ||
+                          std::is_same_v<T, uint8_t>   ||
                           std::is_same_v<T, int8_t>    ||
                           std::is_same_v<T, char>      ||
                           std::is_same_v<T, unsigned char>;
 
-      template <template<typename> class T, typename B>
-      concept valid_type = std::is_same_v< T<B>, std::vector<B> > ||
-                           std::is_same_v< T<B>, std::basic_string<B> > ||
-                           std::is_same_v< T<B>, std::basic_string_view<B> >;
+      template <typename T>
+      concept valid_type = requires(const T& t) {
+                              { t.size() } -> std::convertible_to<std::size_t>;
+                              { t.data() };
+                           } && byte_type<std::remove_cvref_t<decltype(*std::declval<const T&>().data())>>;
+
+      template <typename T>
+      constexpr inline bool is_std_array_v = false;
+
+      template <typename T, std::size_t N>
+      constexpr inline bool is_std_array_v<std::array<T,N>> = true;
 
-      constexpr static inline std::size_t dynamic_extent_v = std::numeric_limits<std::size_t>::max();
+      template <typename D, typename T>
+      constexpr inline void copy_bytes(D* dst, const T* src, std::size_t size) noexcept {
+         if (std::is_constant_evaluated()) {
+            for (std::size_t i = 0; i < size; ++i)
+               dst[i] = static_cast<D>(src[i]);
+         } else {
+            std::memcpy(dst, src, size);
+         }
+      }
 
-      template <std::size_t M, std::size_t N>
-      consteval static inline std::size_t which() noexcept { 
-         if constexpr (M==-1) return N; 
-         else return M;
+      inline uint64_t load_u64(const std::byte* ptr) noexcept {
+         uint64_t v;
+         std::memcpy(&v, ptr, sizeof(v));
+         return v;
       }
 
-      template <std::size_t M, typename T, std::size_t N>
-      constexpr static inline std::size_t extent(std::array<T,N>) noexcept { which<M,N*sizeof(T)>(); }
+      inline uint64_t byteswap(uint64_t v) noexcept {
+#if defined(_MSC_VER) && !defined(__clang__)
+         return _byteswap_uint64(v);
+#else
+         return __builtin_bswap64(v);
+#endif
+      }
 
-      template <std::size_t M, typename T, std::size_t N>
-      constexpr static inline std::size_t extent(T(&)[N]) noexcept { return which<M,N*sizeof(T)>(); }
+      // Loads 8 bytes such that comparing the results as integers orders them like memcmp.
+      inline uint64_t load_u64_be(const std::byte* ptr) noexcept {
+         if constexpr (std::endian::native == std::endian::little)
+            return byteswap(load_u64(ptr));
+         else
+            return load_u64(ptr);
+      }
 
-      template <std::size_t M, std::size_t N>
-      constexpr static inline std::size_t extent(const char(&)[N]) noexcept { return which<M, N-1>(); }
+      constexpr inline std::strong_ordering to_ordering(int cmp) noexcept { return cmp <=> 0; }
 
-      template <std::size_t M, template <typename> class T, typename B>
-      constexpr static inline std::size_t extent(T<B> data) noexcept { 
-         return M*3; 
+      // The constant evaluation fallback of compare_bytes; memcpy and intrinsics are not available there.
+      template <typename B>
+      constexpr inline std::strong_ordering compare_bytes_constexpr(const B* a, const B* b, std::size_t size) noexcept {
+         for (std::size_t i = 0; i < size; ++i)
+            if (static_cast<uint8_t>(a[i]) != static_cast<uint8_t>(b[i]))
+               return static_cast<uint8_t>(a[i]) <=> static_cast<uint8_t>(b[i]);
+         return std::strong_ordering::equal;
       }
-      
-      template <std::size_t M, typename T, typename...>
-      constexpr static inline std::size_t extent(T&&) noexcept { 
-         return which<M, dynamic_extent_v>(); 
-      } 
 
-      template <typename T, std::size_t N>
-      struct wrapper {
-         constexpr inline wrapper(const T(&data)[N]) : _data(data) {}
-         constexpr inline wrapper(const std::array<T,N>& data) : _data(data) {}
-         constexpr inline auto data() noexcept { return _data; }
-         T _data[N];
-      };
-   }
+      /**
+       * @brief Equality of two N byte buffers without calling into libc.
+       *
+       * Sizes of up to 64 bytes compare whole words or vectors and fold the differences together
+       * without early exits; a size that is not a multiple of 8 finishes with an overlapping load
+       * of the last word so nothing past the buffers is read.
+       */
+      template <std::size_t N>
+      inline bool equal_bytes(const std::byte* a, const std::byte* b) noexcept {
+         if constexpr (N > 64) {
+            return std::memcmp(a, b, N) == 0;
+#if defined(__AVX512BW__)
+         } else if constexpr (N == 64) {
+            return _mm512_cmpneq_epi8_mask(_mm512_loadu_si512(a), _mm512_loadu_si512(b)) == 0;
+#endif
+#if defined(__AVX2__)
+         } else if constexpr (N == 32 || N == 64) {
+            __m256i eq = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a)),
+                                           _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b)));
+            if constexpr (N == 64)
+               eq = _mm256_and_si256(eq, _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + 32)),
+                                                          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + 32))));
+            return static_cast<uint32_t>(_mm256_movemask_epi8(eq)) == 0xFFFFFFFFu;
+#endif
+#if defined(__SSE2__)
+         } else if constexpr (N == 16 || N == 32 || N == 64) {
+            __m128i eq = _mm_set1_epi8(-1);
+            for (std::size_t i = 0; i < N; i += 16)
+               eq = _mm_and_si128(eq, _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                                     _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))));
+            return _mm_movemask_epi8(eq) == 0xFFFF;
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+         } else if constexpr (N == 16 || N == 32 || N == 64) {
+            uint8x16_t eq = vdupq_n_u8(0xFF);
+            for (std::size_t i = 0; i < N; i += 16)
+               eq = vandq_u8(eq, vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(a + i)),
+                                          vld1q_u8(reinterpret_cast<const uint8_t*>(b + i))));
+            return vminvq_u8(eq) == 0xFF;
+#endif
+         } else if constexpr (N >= 8) {
+            uint64_t diff = 0;
+            for (std::size_t i = 0; i + 8 <= N; i += 8)
+               diff |= load_u64(a + i) ^ load_u64(b + i);
+            if constexpr (N % 8 != 0)
+               diff |= load_u64(a + N - 8) ^ load_u64(b + N - 8);
+            return diff == 0;
+         } else {
+            uint64_t x = 0, y = 0;
+            std::memcpy(&x, a, N);
+            std::memcpy(&y, b, N);
+            return x == y;
+         }
+      }
 
-   template <std::size_t M=-1, typename B=std::byte, std::size_t N=detail::extent<M>(B{}) >
+      /**
+       * @brief Lexicographic (memcmp order) comparison of two N byte buffers.
+       *
+       * The vector sizes locate the first differing byte from an equality mask; the other sizes up to
+       * 64 bytes compare big-endian words, so the first differing word decides without a byte loop.
+       */
+      template <std::size_t N>
+      inline std::strong_ordering compare_bytes(const std::byte* a, const std::byte* b) noexcept {
+         if constexpr (N > 64) {
+            return to_ordering(std::memcmp(a, b, N));
+#if defined(__SSE2__)
+         } else if constexpr (N == 16 || N == 32 || N == 64) {
+            for (std::size_t i = 0; i < N; i += 16) {
+               const uint32_t ne = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i))))) & 0xFFFFu;
+               if (ne) {
+                  const std::size_t at = i + std::countr_zero(ne);
+                  return static_cast<uint8_t>(a[at]) <=> static_cast<uint8_t>(b[at]);
+               }
+            }
+            return std::strong_ordering::equal;
+#endif
+         } else if constexpr (N >= 8) {
+            for (std::size_t i = 0; i + 8 <= N; i += 8) {
+               const uint64_t x = load_u64_be(a + i), y = load_u64_be(b + i);
+               if (x != y)
+                  return x <=> y;
+            }
+            if constexpr (N % 8 != 0)
+               return load_u64_be(a + N - 8) <=> load_u64_be(b + N - 8);
+            return std::strong_ordering::equal;
+         } else {
+            uint64_t x = 0, y = 0;
+            std::memcpy(&x, a, N);
+            std::memcpy(&y, b, N);
+            if constexpr (std::endian::native == std::endian::little)
+               return byteswap(x) <=> byteswap(y);
+            else
+               return x <=> y;
+         }
+      }
+   } // namespace detail
+
+   /**
+    * @brief N bytes held inline, compared like memcmp.
+    *
+    * B is the storage type. The default std::byte suits binary values such as hashes. With char,
+    * the text accessors need no casts, so a fixed_bytes<N,char> (see fixed_string) can be
+    * constructed, compared, hashed and read in constant expressions.
+    */
+   template <std::size_t N, typename B=std::byte>
    class fixed_bytes {
       public:
          fixed_bytes() = default;
          fixed_bytes(const fixed_bytes&) = default;
          fixed_bytes(fixed_bytes&&) = default;
 
-         template <typename T=B>
-         constexpr inline fixed_bytes(T&& data) noexcept { 
-            std::memcpy(_data, detail::wrapper(std::forward<T>(data)).data(), N); 
+         constexpr inline fixed_bytes(const char(&data)[N+1]) noexcept {
+            detail::copy_bytes(_data, data, N);
          }
 
-         constexpr inline fixed_bytes(const B(&data)[M]) { 
-            std::memcpy(_data, detail::wrapper(data), sizeof(B)*N); 
+         template <detail::byte_type T>
+         constexpr inline fixed_bytes(const T(&data)[N]) noexcept {
+            detail::copy_bytes(_data, data, N);
          }
 
-         template <std::size_t X=M>
-         constexpr inline fixed_bytes(const std::array<B,X>& data) { 
-            static_assert(X != N, "Size of data does not match size of fixed_string");
-            std::memcpy(_data, detail::wrapper(data).data(), sizeof(B)*M); 
+         template <detail::byte_type T, std::size_t X>
+         requires (X * sizeof(T) == N)
+         constexpr inline fixed_bytes(const std::array<T,X>& data) noexcept {
+            detail::copy_bytes(_data, data.data(), N);
          }
 
-         template <template <typename> class T, typename B>
-         requires detail::valid_type<T<B>> && detail::byte_type<B>
-         constexpr inline fixed_bytes(const T<B>& data) {
+         template <detail::valid_type T>
+         requires (!detail::is_std_array_v<T>)
+         constexpr inline fixed_bytes(const T& data) {
             util::check(data.size() == N, "Size of data does not match size of fixed_string");
-            std::memcpy(_data, data.data(), N); 
+            detail::copy_bytes(_data, data.data(), N);
          }
 
          fixed_bytes& operator=(const fixed_bytes&) = default;
          fixed_bytes& operator=(fixed_bytes&&) = default;
 
-         template <typename T=B>
-         constexpr inline fixed_bytes& operator=(T&& data) noexcept { 
-            std::memcpy(_data, detail::wrapper(std::forward<T>(data)).data(), N); 
-            return *this;
-         }
-         template <template <typename> class T, typename B>
-         requires detail::valid_type<T<B>> && detail::byte_type<B>
-         constexpr inline fixed_bytes& operator=(const T<B>& data) {
+         template <detail::valid_type T>
+         requires (!detail::is_std_array_v<T>)
+         constexpr inline fixed_bytes& operator=(const T& data) {
             util::check(data.size() == N, "Size of data does not match size of fixed_string");
-            std::memcpy(_data, data.data(), N); 
+            detail::copy_bytes(_data, data.data(), N);
+            return *this;
          }
 
          ~fixed_bytes() = default;
 
-         constexpr inline char& operator[](std::size_t index) noexcept { return reinterpret_cast<char*>(_data)[index]; }
+         constexpr inline char& operator[](std::size_t index) noexcept { return data()[index]; }
 
-         constexpr inline const char& operator[](std::size_t index) const noexcept { return reinterpret_cast<const char*>(data)[index]; }
+         constexpr inline const char& operator[](std::size_t index) const noexcept { return data()[index]; }
 
-         constexpr inline char& at(std::size_t index) { 
+         constexpr inline char& at(std::size_t index) {
             util::check(index < N, "Index out of range");
-            return reinterpret_cast<char*>(_data)[index];
+            return data()[index];
          }
 
-         constexpr inline const char& at(std::size_t index) const { 
+         constexpr inline const char& at(std::size_t index) const {
             util::check(index < N, "Index out of range");
-            return reinterpret_cast<const char*>(_data)[index];
+            return data()[index];
          }
 
-         constexpr inline char* begin() noexcept { return reinterpret_cast<char*>(_data); }
-         constexpr inline const char* begin() const noexcept { return reinterpret_cast<const char*>(_data); }
-         constexpr inline char* end() noexcept { return reinterpret_cast<char*>(_data) + N; }
-         constexpr inline const char* end() const noexcept { return reinterpret_cast<const char*>(_data) + N; }
+         constexpr inline char* begin() noexcept { return data(); }
+         constexpr inline const char* begin() const noexcept { return data(); }
+         constexpr inline char* end() noexcept { return data() + N; }
+         constexpr inline const char* end() const noexcept { return data() + N; }
 
          constexpr inline std::size_t size() const noexcept { return N; }
-         constexpr inline char* data() noexcept { return reinterpret_cast<char*>(_data); }
-         constexpr inline const char* data() const noexcept { return reinterpret_cast<char*>(_data); }
-         constexpr inline char& ref() noexcept { return *reinterpret_cast<char*>(_data); }
-         constexpr inline const char& ref() const noexcept { return *reinterpret_cast<const char*>(_data); }
+
+         constexpr inline char* data() noexcept {
+            if constexpr (std::is_same_v<B, char>)
+               return _data;
+            else
+               return reinterpret_cast<char*>(_data);
+         }
+
+         constexpr inline const char* data() const noexcept {
+            if constexpr (std::is_same_v<B, char>)
+               return _data;
+            else
+               return reinterpret_cast<const char*>(_data);
+         }
+
+         constexpr inline char& ref() noexcept { return *data(); }
+         constexpr inline const char& ref() const noexcept { return *data(); }
+
+         constexpr inline const std::byte* bytes() const noexcept {
+            if constexpr (std::is_same_v<B, std::byte>)
+               return _data;
+            else
+               return reinterpret_cast<const std::byte*>(_data);
+         }
+
+         constexpr inline bool operator==(const fixed_bytes& other) const noexcept {
+            if (std::is_constant_evaluated())
+               return detail::compare_bytes_constexpr(_data, other._data, N) == 0;
+            return detail::equal_bytes<N>(bytes(), other.bytes());
+         }
 
          constexpr inline std::strong_ordering operator<=>(const fixed_bytes& other) const noexcept {
-            return std::memcmp(_data, other._data, N);
+            if (std::is_constant_evaluated())
+               return detail::compare_bytes_constexpr(_data, other._data, N);
+            return detail::compare_bytes<N>(bytes(), other.bytes());
          }
-      private:
-         alignas(uint64_t) std::byte _data[N];
+
+         // Public so that fixed_bytes is a structural type and can be used as a template argument.
+         alignas(uint64_t) B _data[N];
    };
 
    template <std::size_t N>
-   constexpr static inline std::string to_string(const fixed_bytes<N>& data) {
+   fixed_bytes(const char(&)[N]) -> fixed_bytes<N-1>;
+
+   template <detail::byte_type T, std::size_t N>
+   fixed_bytes(const std::array<T,N>&) -> fixed_bytes<N*sizeof(T)>;
+
+   /**
+    * @brief Text of N characters that is usable as a template argument, e.g. `template <fixed_string S>`.
+    */
+   template <std::size_t N>
+   struct fixed_string : fixed_bytes<N, char> {
+      using fixed_bytes<N, char>::fixed_bytes;
+
+      constexpr inline operator std::string_view() const noexcept { return std::string_view(this->data(), N); }
+   };
+
+   template <std::size_t N>
+   fixed_string(const char(&)[N]) -> fixed_string<N-1>;
+
+   namespace detail {
+      template <std::size_t N, typename B>
+      using fixed_bytes_find_fn = std::size_t(*)(const fixed_bytes<N,B>*, std::size_t, const fixed_bytes<N,B>&) noexcept;
+
+      // Tests four keys per iteration and branches once on the combined result. Keys wider than a
+      // word are filtered on their first 8 bytes and only candidates get the full comparison.
+      template <std::size_t N, typename B>
+      std::size_t find_portable(const fixed_bytes<N,B>* keys, std::size_t size, const fixed_bytes<N,B>& key) noexcept {
+         auto matches = [&](const fixed_bytes<N,B>& k) -> uint32_t {
+            if constexpr (N > 8)
+               return load_u64(k.bytes()) == load_u64(key.bytes());
+            else
+               return k == key;
+         };
+         std::size_t i = 0;
+         for (; i + 4 <= size; i += 4) {
+            uint32_t hits = matches(keys[i])           |
+                            matches(keys[i + 1]) << 1  |
+                            matches(keys[i + 2]) << 2  |
+                            matches(keys[i + 3]) << 3;
+            for (; hits; hits &= hits - 1) {
+               const std::size_t at = i + std::countr_zero(hits);
+               if (N <= 8 || keys[at] == key)
+                  return at;
+            }
+         }
+         for (; i < size; ++i)
+            if (keys[i] == key)
+               return i;
+         return size;
+      }
+
+      // The vector kernels compare 8 byte keys two to a 16 byte vector, and keys of 16 bytes or more
+      // on their first 16 (or, with AVX2, 32) bytes; only keys wider than that need a full comparison
+      // of the candidates. Other sizes carry padding in their last vector and use find_portable.
+      template <std::size_t N>
+      constexpr inline bool has_find_vector = N == 8 || N >= 16;
+
+      template <std::size_t N, typename B>
+      inline std::size_t find_tail(const fixed_bytes<N,B>* keys, std::size_t i, std::size_t size, const fixed_bytes<N,B>& key) noexcept {
+         for (; i < size; ++i)
+            if (keys[i] == key)
+               return i;
+         return size;
+      }
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      // Lambdas do not inherit the target of the kernel they are in, so the per-vector steps are
+      // targeted helpers; these return a bit per key, for the four keys at k, whose prefix matches.
+      VERSA_TARGET("sse2")
+      inline uint32_t equal_mask_128(const std::byte* p, __m128i needle) noexcept {
+         return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)), needle)));
+      }
+
+      template <std::size_t N, typename B>
+      VERSA_TARGET("sse2")
+      inline uint32_t prefix_hits_128(const fixed_bytes<N,B>* k, __m128i needle) noexcept {
+         return uint32_t{equal_mask_128(k[0].bytes(), needle) == 0xFFFFu} | uint32_t{equal_mask_128(k[1].bytes(), needle) == 0xFFFFu} << 1 |
+                uint32_t{equal_mask_128(k[2].bytes(), needle) == 0xFFFFu} << 2 | uint32_t{equal_mask_128(k[3].bytes(), needle) == 0xFFFFu} << 3;
+      }
+
+      VERSA_TARGET("avx2")
+      inline uint32_t equal_mask_256(const std::byte* p, __m256i needle) noexcept {
+         return static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), needle)));
+      }
+
+      template <std::size_t N, typename B>
+      VERSA_TARGET("avx2")
+      inline uint32_t prefix_hits_256(const fixed_bytes<N,B>* k, __m256i needle) noexcept {
+         return uint32_t{equal_mask_256(k[0].bytes(), needle) == 0xFFFFFFFFu} | uint32_t{equal_mask_256(k[1].bytes(), needle) == 0xFFFFFFFFu} << 1 |
+                uint32_t{equal_mask_256(k[2].bytes(), needle) == 0xFFFFFFFFu} << 2 | uint32_t{equal_mask_256(k[3].bytes(), needle) == 0xFFFFFFFFu} << 3;
+      }
+
+      template <std::size_t N, typename B>
+      VERSA_TARGET("sse2")
+      std::size_t find_sse2(const fixed_bytes<N,B>* keys, std::size_t size, const fixed_bytes<N,B>& key) noexcept {
+         static_assert(has_find_vector<N> && (N != 8 || sizeof(fixed_bytes<N,B>) == N));
+         std::size_t i = 0;
+         if constexpr (N == 8) {
+            const __m128i needle = _mm_set1_epi64x(static_cast<long long>(load_u64(key.bytes())));
+            auto pair = [](uint32_t eq) -> uint32_t { return uint32_t{(eq & 0xFFu) == 0xFFu} | uint32_t{(eq >> 8) == 0xFFu} << 1; };
+            for (; i + 4 <= size; i += 4) {
+               const uint32_t hits = pair(equal_mask_128(keys[i].bytes(), needle)) | pair(equal_mask_128(keys[i + 2].bytes(), needle)) << 2;
+               if (hits)
+                  return i + std::countr_zero(hits);
+            }
+         } else {
+            const __m128i needle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(key.bytes()));
+            for (; i + 4 <= size; i += 4) {
+               uint32_t hits = prefix_hits_128(keys + i, needle);
+               for (; hits; hits &= hits - 1) {
+                  const std::size_t at = i + std::countr_zero(hits);
+                  if (N == 16 || keys[at] == key)
+                     return at;
+               }
+            }
+         }
+         return find_tail(keys, i, size, key);
+      }
+
+      // Adds a kernel for 8 and 16 byte keys that tests four keys per pair of instructions, and one for
+      // keys of 32 bytes or more that filters on their first 32 bytes.
+      template <std::size_t N>
+      constexpr inline bool has_find_avx2 = N == 8 || N == 16 || N >= 32;
+
+      template <std::size_t N, typename B>
+      VERSA_TARGET("avx2")
+      std::size_t find_avx2(const fixed_bytes<N,B>* keys, std::size_t size, const fixed_bytes<N,B>& key) noexcept {
+         static_assert(has_find_avx2<N> && (N > 16 || sizeof(fixed_bytes<N,B>) == N));
+         std::size_t i = 0;
+         if constexpr (N == 8) {
+            const __m256i needle = _mm256_set1_epi64x(static_cast<long long>(load_u64(key.bytes())));
+            for (; i + 4 <= size; i += 4) {
+               const __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i));
+               const uint32_t hits = static_cast<uint32_t>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(block, needle))));
+               if (hits)
+                  return i + std::countr_zero(hits);
+            }
+         } else if constexpr (N == 16) {
+            const __m256i needle = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(key.bytes())));
+            auto pair = [](uint32_t eq) -> uint32_t { return uint32_t{(eq & 0xFFFFu) == 0xFFFFu} | uint32_t{(eq >> 16) == 0xFFFFu} << 1; };
+            for (; i + 4 <= size; i += 4) {
+               const uint32_t lo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                                      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i)), needle)));
+               const uint32_t hi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                                      _mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys + i + 2)), needle)));
+               const uint32_t hits = pair(lo) | pair(hi) << 2;
+               if (hits)
+                  return i + std::countr_zero(hits);
+            }
+         } else {
+            const __m256i needle = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(key.bytes()));
+            for (; i + 4 <= size; i += 4) {
+               uint32_t hits = prefix_hits_256(keys + i, needle);
+               for (; hits; hits &= hits - 1) {
+                  const std::size_t at = i + std::countr_zero(hits);
+                  if (N == 32 || keys[at] == key)
+                     return at;
+               }
+            }
+         }
+         return find_tail(keys, i, size, key);
+      }
+
+      template <std::size_t N, typename B, bool Avx2 = has_find_avx2<N>>
+      struct find_dispatch_for {
+         using type = dispatcher<
+            implementation<static_cast<fixed_bytes_find_fn<N,B>>(&find_sse2<N,B>), info::cpu_features::sse2, info::architectures::x64 | info::architectures::x86>,
+            implementation<static_cast<fixed_bytes_find_fn<N,B>>(&find_portable<N,B>)>>;
+      };
+
+      template <std::size_t N, typename B>
+      struct find_dispatch_for<N, B, true> {
+         using type = dispatcher<
+            implementation<static_cast<fixed_bytes_find_fn<N,B>>(&find_avx2<N,B>), info::cpu_features::avx2, info::architectures::x64 | info::architectures::x86>,
+            implementation<static_cast<fixed_bytes_find_fn<N,B>>(&find_sse2<N,B>), info::cpu_features::sse2, info::architectures::x64 | info::architectures::x86>,
+            implementation<static_cast<fixed_bytes_find_fn<N,B>>(&find_portable<N,B>)>>;
+      };
+
+      template <std::size_t N, typename B>
+      using find_dispatch = typename find_dispatch_for<N,B>::type;
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+      template <std::size_t N, typename B>
+      inline std::size_t find_neon(const fixed_bytes<N,B>* keys, std::size_t size, const fixed_bytes<N,B>& key) noexcept {
+         static_assert(has_find_vector<N> && (N != 8 || sizeof(fixed_bytes<N,B>) == N));
+         auto load = [](const fixed_bytes<N,B>* k) { return vld1q_u8(reinterpret_cast<const uint8_t*>(k->bytes())); };
+         std::size_t i = 0;
+         if constexpr (N == 8) {
+            const uint64x2_t needle = vdupq_n_u64(load_u64(key.bytes()));
+            for (; i + 4 <= size; i += 4) {
+               const uint64x2_t lo = vceqq_u64(vreinterpretq_u64_u8(load(keys + i)), needle);
+               const uint64x2_t hi = vceqq_u64(vreinterpretq_u64_u8(load(keys + i + 2)), needle);
+               // One bit per key out of the all ones or all zeros lanes.
+               const uint32_t hits = static_cast<uint32_t>(vgetq_lane_u64(lo, 0) & 1) | static_cast<uint32_t>(vgetq_lane_u64(lo, 1) & 2) |
+                                     static_cast<uint32_t>(vgetq_lane_u64(hi, 0) & 4) | static_cast<uint32_t>(vgetq_lane_u64(hi, 1) & 8);
+               if (hits)
+                  return i + std::countr_zero(hits);
+            }
+         } else {
+            const uint8x16_t needle = load(&key);
+            auto match = [&](const fixed_bytes<N,B>* k) -> uint32_t { return vminvq_u8(vceqq_u8(load(k), needle)) == 0xFF; };
+            for (; i + 4 <= size; i += 4) {
+               uint32_t hits = match(keys + i) | match(keys + i + 1) << 1 | match(keys + i + 2) << 2 | match(keys + i + 3) << 3;
+               for (; hits; hits &= hits - 1) {
+                  const std::size_t at = i + std::countr_zero(hits);
+                  if (N == 16 || keys[at] == key)
+                     return at;
+               }
+            }
+         }
+         return find_tail(keys, i, size, key);
+      }
+#endif
+   } // namespace detail
+
+   /**
+    * @brief Finds the first occurrence of `key` in an array of keys.
+    *
+    * Keys are tested four at a time. With SSE2, AVX2 or NEON, 8 byte keys are compared two or four to
+    * a vector and keys of 16 bytes or more on their first 16 or 32 bytes, so 20 and 32 byte digests
+    * only get a full comparison when that prefix matches. Other sizes are filtered on their first word.
+    * @param keys The keys to scan.
+    * @param key The key to look for.
+    * @return An iterator to the first match, or keys.end().
+    */
+   template <std::size_t N, typename B>
+   inline auto find(std::span<const fixed_bytes<N,B>> keys, const fixed_bytes<N,B>& key) noexcept {
+      std::size_t index;
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      if constexpr (detail::has_find_vector<N>)
+         index = detail::find_dispatch<N,B>{}(keys.data(), keys.size(), key);
+      else
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+      if constexpr (detail::has_find_vector<N>)
+         index = detail::find_neon(keys.data(), keys.size(), key);
+      else
+#endif
+         index = detail::find_portable(keys.data(), keys.size(), key);
+      return keys.begin() + index;
+   }
+
+   template <std::size_t N, typename B>
+   constexpr static inline std::string to_string(const fixed_bytes<N,B>& data) {
       return std::string(data.data(), N);
    }
-   
-   template <std::size_t N>
-   constexpr static inline std::string_view to_string_view(const fixed_bytes<N>& data) {
+
+   template <std::size_t N, typename B>
+   constexpr static inline std::string_view to_string_view(const fixed_bytes<N,B>& data) {
       return std::string_view(data.data(), N);
    }
 
-} // namespace versa::util
\ No newline at end of file
+} // namespace versa::util
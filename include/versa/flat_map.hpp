@@ -0,0 +1,469 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <bit>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#include "constants.hpp"
+#include "hash.hpp"
+#include "utils.hpp"
+
+#if defined(__SSE2__)
+   #include <emmintrin.h>
+#endif
+
+namespace versa::util {
+   namespace detail {
+      /**
+       * @brief Control byte values of a flat_map slot. A full slot stores the low 7 bits of its hash.
+       */
+      enum class ctrl_t : int8_t {
+         empty   = -128, /**< Never used */
+         deleted = -2    /**< Erased, probing continues past it */
+      };
+
+      /**
+       * @brief A group of 16 control bytes probed together.
+       *
+       * Matching produces a 16-bit mask with one bit per slot; SSE2 builds it with a byte compare and
+       * movemask, other targets with SWAR arithmetic on two 64-bit words.
+       */
+      struct ctrl_group {
+         constexpr static inline std::size_t width = 16;
+
+#if defined(__SSE2__)
+         inline explicit ctrl_group(const int8_t* ctrl) noexcept
+            : _ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))) {}
+
+         inline uint32_t match(int8_t h2) const noexcept {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_ctrl, _mm_set1_epi8(h2))));
+         }
+
+         inline uint32_t match_empty() const noexcept { return match(static_cast<int8_t>(ctrl_t::empty)); }
+
+         inline uint32_t match_empty_or_deleted() const noexcept {
+            return static_cast<uint32_t>(_mm_movemask_epi8(_ctrl));
+         }
+
+         __m128i _ctrl;
+#else
+         inline explicit ctrl_group(const int8_t* ctrl) noexcept {
+            std::memcpy(_words, ctrl, sizeof(_words));
+         }
+
+         constexpr static inline uint64_t lsbs = 0x0101010101010101ull;
+         constexpr static inline uint64_t msbs = 0x8080808080808080ull;
+
+         // Collects the high bit of every byte of `m` into the low 8 bits.
+         static inline uint32_t gather(uint64_t m) noexcept {
+            if constexpr (std::endian::native == std::endian::big)
+               m = __builtin_bswap64(m);
+            return static_cast<uint32_t>(((m >> 7) * 0x0102040810204080ull) >> 56);
+         }
+
+         // May report a false positive right after a true match, the caller always verifies the key.
+         inline uint32_t match(int8_t h2) const noexcept {
+            uint32_t mask = 0;
+            for (std::size_t i = 0; i < 2; ++i) {
+               const uint64_t x = _words[i] ^ (lsbs * static_cast<uint8_t>(h2));
+               mask |= gather((x - lsbs) & ~x & msbs) << (8 * i);
+            }
+            return mask;
+         }
+
+         inline uint32_t match_empty() const noexcept {
+            // Only empty (0x80) has the high bit set and bit 1 clear.
+            uint32_t mask = 0;
+            for (std::size_t i = 0; i < 2; ++i)
+               mask |= gather(_words[i] & ~(_words[i] << 6) & msbs) << (8 * i);
+            return mask;
+         }
+
+         inline uint32_t match_empty_or_deleted() const noexcept {
+            uint32_t mask = 0;
+            for (std::size_t i = 0; i < 2; ++i)
+               mask |= gather(_words[i] & msbs) << (8 * i);
+            return mask;
+         }
+
+         uint64_t _words[2];
+#endif
+      };
+
+      // Extra mixing so that identity hashes like std::hash<int> still spread their top and bottom bits.
+      inline uint64_t flat_map_mix(uint64_t h) noexcept { return hash_mix(h, 0x9E3779B97F4A7C15ull); }
+   } // namespace detail
+
+   /**
+    * @brief An open addressing hash map with SwissTable style control bytes.
+    *
+    * Keys and values live in separate arrays next to a byte array of control bytes, so a lookup probes
+    * 16 slots with one vector compare over a single cache line and only touches the key array for
+    * slots whose 7-bit hash tag matches. Keys and values are never moved once inserted until the table
+    * grows; growing or rehashing invalidates iterators and references.
+    *
+    * @tparam K The key type, e.g. fixed_bytes<N>.
+    * @tparam V The mapped type.
+    * @tparam Hash The hasher, std::hash<fixed_bytes<N>> is provided by versa/hash.hpp.
+    * @tparam KeyEqual The key equality predicate.
+    */
+   template <typename K, typename V, typename Hash = std::hash<K>, typename KeyEqual = std::equal_to<K>>
+   class flat_map {
+      using group = detail::ctrl_group;
+
+      public:
+         using key_type    = K;
+         using mapped_type = V;
+         using size_type   = std::size_t;
+
+         /**
+          * @brief What iterators dereference to; keys and values are stored apart so this is a pair of references.
+          */
+         template <bool Const>
+         struct basic_reference {
+            const K& first;
+            std::conditional_t<Const, const V&, V&> second;
+            inline const basic_reference* operator->() const noexcept { return this; }
+         };
+
+         template <bool Const>
+         class basic_iterator {
+            using map_type = std::conditional_t<Const, const flat_map, flat_map>;
+            public:
+               using iterator_category = std::forward_iterator_tag;
+               using value_type        = std::pair<K, V>;
+               using difference_type   = std::ptrdiff_t;
+               using reference         = basic_reference<Const>;
+               using pointer           = basic_reference<Const>;
+
+               basic_iterator() = default;
+               inline basic_iterator(map_type* map, size_type index) noexcept : _map(map), _index(index) { skip(); }
+               template <bool C = Const>
+               requires C
+               inline basic_iterator(const basic_iterator<false>& other) noexcept : _map(other._map), _index(other._index) {}
+
+               inline reference operator*() const noexcept { return {_map->_keys[_index], _map->_values[_index]}; }
+               inline pointer operator->() const noexcept { return **this; }
+
+               inline const K& key() const noexcept { return _map->_keys[_index]; }
+               inline auto& value() const noexcept { return _map->_values[_index]; }
+
+               inline basic_iterator& operator++() noexcept { ++_index; skip(); return *this; }
+               inline basic_iterator operator++(int) noexcept { auto it = *this; ++*this; return it; }
+
+               inline bool operator==(const basic_iterator& other) const noexcept { return _index == other._index; }
+
+            private:
+               friend class flat_map;
+               template <bool> friend class basic_iterator;
+
+               inline void skip() noexcept {
+                  while (_index < _map->_capacity && _map->_ctrl[_index] < 0) ++_index;
+               }
+
+               map_type* _map   = nullptr;
+               size_type _index = 0;
+         };
+
+         using iterator       = basic_iterator<false>;
+         using const_iterator = basic_iterator<true>;
+
+         flat_map() = default;
+
+         inline flat_map(std::initializer_list<std::pair<K, V>> init) {
+            reserve(init.size());
+            for (const auto& [k, v] : init) emplace(k, v);
+         }
+
+         inline flat_map(const flat_map& other) : _hash(other._hash), _eq(other._eq) {
+            reserve(other._size);
+            for (const auto& [k, v] : other) emplace(k, v);
+         }
+
+         inline flat_map(flat_map&& other) noexcept { swap(other); }
+
+         inline flat_map& operator=(const flat_map& other) {
+            if (this != &other) {
+               flat_map copy(other);
+               swap(copy);
+            }
+            return *this;
+         }
+
+         inline flat_map& operator=(flat_map&& other) noexcept {
+            flat_map moved(std::move(other));
+            swap(moved);
+            return *this;
+         }
+
+         inline ~flat_map() { destroy(); }
+
+         inline void swap(flat_map& other) noexcept {
+            std::swap(_ctrl, other._ctrl);
+            std::swap(_keys, other._keys);
+            std::swap(_values, other._values);
+            std::swap(_capacity, other._capacity);
+            std::swap(_size, other._size);
+            std::swap(_growth_left, other._growth_left);
+            std::swap(_hash, other._hash);
+            std::swap(_eq, other._eq);
+         }
+
+         inline iterator begin() noexcept { return {this, 0}; }
+         inline iterator end() noexcept { return {this, _capacity}; }
+         inline const_iterator begin() const noexcept { return {this, 0}; }
+         inline const_iterator end() const noexcept { return {this, _capacity}; }
+
+         inline size_type size() const noexcept { return _size; }
+         inline bool empty() const noexcept { return _size == 0; }
+         inline size_type capacity() const noexcept { return _capacity; }
+
+         /**
+          * @brief Finds the slot holding `key`.
+          * @return An iterator to the entry, or end().
+          */
+         inline iterator find(const K& key) noexcept { return {this, find_index(key)}; }
+         inline const_iterator find(const K& key) const noexcept { return {this, find_index(key)}; }
+
+         inline bool contains(const K& key) const noexcept { return find_index(key) != _capacity; }
+
+         /**
+          * @brief Gets the value for `key`.
+          * @throws std::runtime_error if the key is not present.
+          */
+         inline V& at(const K& key) {
+            const size_type index = find_index(key);
+            util::check(index != _capacity, "Key not found in flat_map");
+            return _values[index];
+         }
+
+         inline const V& at(const K& key) const {
+            const size_type index = find_index(key);
+            util::check(index != _capacity, "Key not found in flat_map");
+            return _values[index];
+         }
+
+         inline V& operator[](const K& key) { return try_emplace(key).first.value(); }
+
+         /**
+          * @brief Inserts `key` with a value constructed from `args` unless the key is already present.
+          * @return The entry for `key` and whether it was inserted.
+          */
+         template <typename... Args>
+         inline std::pair<iterator, bool> try_emplace(const K& key, Args&&... args) {
+            const uint64_t h = hash_of(key);
+            if (const size_type index = find_index(key, h); index != _capacity)
+               return {iterator{this, index}, false};
+            const size_type index = prepare_insert(h);
+            std::construct_at(_keys + index, key);
+            try {
+               std::construct_at(_values + index, std::forward<Args>(args)...);
+            } catch (...) {
+               std::destroy_at(_keys + index);
+               throw;
+            }
+            commit_insert(index, h);
+            return {iterator{this, index}, true};
+         }
+
+         template <typename... Args>
+         inline std::pair<iterator, bool> emplace(const K& key, Args&&... args) {
+            return try_emplace(key, std::forward<Args>(args)...);
+         }
+
+         inline std::pair<iterator, bool> insert(const std::pair<K, V>& entry) { return try_emplace(entry.first, entry.second); }
+
+         template <typename M>
+         inline std::pair<iterator, bool> insert_or_assign(const K& key, M&& value) {
+            auto result = try_emplace(key, std::forward<M>(value));
+            if (!result.second)
+               result.first.value() = std::forward<M>(value);
+            return result;
+         }
+
+         /**
+          * @brief Removes `key` if present.
+          * @return The number of removed entries, 0 or 1.
+          */
+         inline size_type erase(const K& key) {
+            const size_type index = find_index(key);
+            if (index == _capacity)
+               return 0;
+            erase_at(index);
+            return 1;
+         }
+
+         inline iterator erase(iterator pos) {
+            erase_at(pos._index);
+            return ++pos;
+         }
+
+         inline void clear() noexcept {
+            for (size_type i = 0; i < _capacity; ++i) {
+               if (_ctrl[i] >= 0) {
+                  std::destroy_at(_keys + i);
+                  std::destroy_at(_values + i);
+               }
+            }
+            if (_capacity)
+               std::memset(_ctrl, static_cast<int8_t>(detail::ctrl_t::empty), _capacity + group::width);
+            _size        = 0;
+            _growth_left = max_load(_capacity);
+         }
+
+         /**
+          * @brief Makes room for at least `count` entries without growing.
+          */
+         inline void reserve(size_type count) {
+            size_type capacity = group::width;
+            while (max_load(capacity) < count) capacity *= 2;
+            if (capacity > _capacity)
+               rehash(capacity);
+         }
+
+      private:
+         constexpr static inline size_type max_load(size_type capacity) noexcept { return capacity - capacity / 8; }
+
+         inline uint64_t hash_of(const K& key) const noexcept { return detail::flat_map_mix(static_cast<uint64_t>(_hash(key))); }
+
+         constexpr static inline size_type h1(uint64_t h) noexcept { return static_cast<size_type>(h >> 7); }
+         constexpr static inline int8_t h2(uint64_t h) noexcept { return static_cast<int8_t>(h & 0x7F); }
+
+         inline size_type find_index(const K& key) const noexcept { return find_index(key, hash_of(key)); }
+
+         inline size_type find_index(const K& key, uint64_t h) const noexcept {
+            if (_capacity == 0)
+               return _capacity;
+            const size_type mask = _capacity - 1;
+            size_type pos = h1(h) & mask;
+            for (size_type step = group::width;; step += group::width) {
+               const group g(_ctrl + pos);
+               for (uint32_t m = g.match(h2(h)); m; m &= m - 1) {
+                  const size_type index = (pos + std::countr_zero(m)) & mask;
+                  if (_eq(_keys[index], key)) [[likely]]
+                     return index;
+               }
+               if (g.match_empty())
+                  return _capacity;
+               pos = (pos + step) & mask;
+            }
+         }
+
+         inline size_type find_free(uint64_t h) const noexcept {
+            const size_type mask = _capacity - 1;
+            size_type pos = h1(h) & mask;
+            for (size_type step = group::width;; step += group::width) {
+               if (const uint32_t m = group(_ctrl + pos).match_empty_or_deleted())
+                  return (pos + std::countr_zero(m)) & mask;
+               pos = (pos + step) & mask;
+            }
+         }
+
+         // The first group::width - 1 control bytes are mirrored past the end so a group load never wraps.
+         inline void set_ctrl(size_type index, int8_t value) noexcept {
+            _ctrl[index] = value;
+            if (index < group::width - 1)
+               _ctrl[_capacity + index] = value;
+         }
+
+         // Finds the slot for a new entry; it only counts as full once commit_insert() marks it, after the
+         // key and value are constructed, so a throwing constructor leaves the map as it was.
+         inline size_type prepare_insert(uint64_t h) {
+            if (_growth_left == 0)
+               rehash(_capacity == 0 ? group::width : (_size + 1 > max_load(_capacity) / 2 ? _capacity * 2 : _capacity));
+            return find_free(h);
+         }
+
+         inline void commit_insert(size_type index, uint64_t h) noexcept {
+            if (_ctrl[index] == static_cast<int8_t>(detail::ctrl_t::empty))
+               --_growth_left;
+            set_ctrl(index, h2(h));
+            ++_size;
+         }
+
+         inline void erase_at(size_type index) {
+            std::destroy_at(_keys + index);
+            std::destroy_at(_values + index);
+            set_ctrl(index, static_cast<int8_t>(detail::ctrl_t::deleted));
+            --_size;
+         }
+
+         // Moves every entry into fresh arrays of `capacity` slots, which also drops tombstones.
+         inline void rehash(size_type capacity) {
+            // Owned until all three are allocated, so a failed allocation frees the earlier ones.
+            auto ctrl_owner   = allocate<int8_t>(capacity + group::width, group::width);
+            auto keys_owner   = allocate<K>(capacity * sizeof(K), alignof(K));
+            auto values_owner = allocate<V>(capacity * sizeof(V), alignof(V));
+            int8_t* ctrl = ctrl_owner.release();
+            K* keys      = keys_owner.release();
+            V* values    = values_owner.release();
+            std::memset(ctrl, static_cast<int8_t>(detail::ctrl_t::empty), capacity + group::width);
+
+            int8_t* old_ctrl         = std::exchange(_ctrl, ctrl);
+            K* old_keys              = std::exchange(_keys, keys);
+            V* old_values            = std::exchange(_values, values);
+            const size_type old_capacity = std::exchange(_capacity, capacity);
+
+            _growth_left = max_load(capacity) - _size;
+            for (size_type i = 0; i < old_capacity; ++i) {
+               if (old_ctrl[i] < 0)
+                  continue;
+               const uint64_t h = hash_of(old_keys[i]);
+               const size_type index = find_free(h);
+               set_ctrl(index, h2(h));
+               std::construct_at(_keys + index, std::move(old_keys[i]));
+               std::construct_at(_values + index, std::move(old_values[i]));
+               std::destroy_at(old_keys + i);
+               std::destroy_at(old_values + i);
+            }
+            release(old_ctrl, old_keys, old_values);
+         }
+
+         struct aligned_delete {
+            std::align_val_t align;
+            inline void operator()(void* p) const noexcept { ::operator delete(p, align); }
+         };
+
+         template <typename T>
+         static inline std::unique_ptr<T, aligned_delete> allocate(std::size_t bytes, std::size_t align) {
+            return {static_cast<T*>(::operator new(bytes, std::align_val_t{align})), aligned_delete{std::align_val_t{align}}};
+         }
+
+         static inline void release(int8_t* ctrl, K* keys, V* values) noexcept {
+            if (!ctrl)
+               return;
+            ::operator delete(ctrl, std::align_val_t{group::width});
+            ::operator delete(keys, std::align_val_t{alignof(K)});
+            ::operator delete(values, std::align_val_t{alignof(V)});
+         }
+
+         inline void destroy() noexcept {
+            if (_capacity)
+               clear();
+            release(_ctrl, _keys, _values);
+            _ctrl = nullptr;
+            _keys = nullptr;
+            _values = nullptr;
+            _capacity = _growth_left = 0;
+         }
+
+         int8_t* _ctrl          = nullptr;
+         K* _keys               = nullptr;
+         V* _values             = nullptr;
+         size_type _capacity    = 0;
+         size_type _size        = 0;
+         size_type _growth_left = 0;
+         [[no_unique_address]] Hash _hash;
+         [[no_unique_address]] KeyEqual _eq;
+   };
+
+} // namespace versa::util
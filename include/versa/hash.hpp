@@ -0,0 +1,172 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <bit>
+#include <functional>
+#include <string_view>
+#include <type_traits>
+
+#include "fixed_string.hpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+   #include <intrin.h>
+#endif
+
+namespace versa::util {
+   namespace detail {
+      // Constants and structure follow wyhash (public domain, Wang Yi).
+      constexpr inline uint64_t hash_secret[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+                                                  0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+
+      /**
+       * @brief Computes the full 128-bit product of a and b, low half into a and high half into b.
+       */
+      constexpr inline void mum(uint64_t& a, uint64_t& b) noexcept {
+#if defined(__SIZEOF_INT128__)
+         const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+         a = static_cast<uint64_t>(r);
+         b = static_cast<uint64_t>(r >> 64);
+#else
+   #if defined(_MSC_VER) && defined(_M_X64)
+         if (!std::is_constant_evaluated()) {
+            a = _umul128(a, b, &b);
+            return;
+         }
+   #endif
+         const uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+         const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32);
+         const uint64_t lo = t + (rm1 << 32);
+         b = rh + (rm0 >> 32) + (rm1 >> 32) + (t < rl) + (lo < t);
+         a = lo;
+#endif
+      }
+
+      /**
+       * @brief Folds the 128-bit product of a and b into 64 bits.
+       */
+      constexpr inline uint64_t hash_mix(uint64_t a, uint64_t b) noexcept {
+         mum(a, b);
+         return a ^ b;
+      }
+
+      /**
+       * @brief Loads a native endian T; constant evaluation assembles them one at a time, so
+       * hashes computed at compile time match the ones computed at run time.
+       */
+      template <typename T, typename C>
+      constexpr inline uint64_t hash_load(const C* p) noexcept {
+         if (std::is_constant_evaluated()) {
+            T v = 0;
+            for (std::size_t i = 0; i < sizeof(T); ++i) {
+               const std::size_t shift = std::endian::native == std::endian::little ? i : sizeof(T) - 1 - i;
+               v |= static_cast<T>(static_cast<uint8_t>(p[i])) << (8 * shift);
+            }
+            return v;
+         }
+         T v;
+         std::memcpy(&v, p, sizeof(v));
+         return v;
+      }
+
+      template <typename C>
+      constexpr inline uint64_t hash_load_u32(const C* p) noexcept { return hash_load<uint32_t>(p); }
+
+      template <typename C>
+      constexpr inline uint64_t hash_load_u64(const C* p) noexcept { return hash_load<uint64_t>(p); }
+
+      /**
+       * @brief The hash kernel. It is always inlined so a constant `size` removes every length branch,
+       * which is how hash<fixed_bytes<N>> ends up specialised on N. It is constexpr over any byte sized
+       * character type, so compile time tables can be keyed by the same hash that is used at run time.
+       *
+       * Inputs over 48 bytes run three independent multiply chains per 48 byte block, so the
+       * multiplies of one block overlap instead of serialising on a single accumulator.
+       */
+      template <typename C>
+      [[gnu::always_inline]] constexpr inline uint64_t hash_bytes(const C* p, std::size_t size, uint64_t seed) noexcept {
+         seed ^= hash_mix(seed ^ hash_secret[0], hash_secret[1]);
+         uint64_t a, b;
+         if (size <= 16) {
+            if (size >= 4) {
+               const std::size_t mid = (size >> 3) << 2;
+               a = (hash_load_u32(p) << 32) | hash_load_u32(p + mid);
+               b = (hash_load_u32(p + size - 4) << 32) | hash_load_u32(p + size - 4 - mid);
+            } else if (size > 0) {
+               a = (uint64_t{static_cast<uint8_t>(p[0])} << 16) |
+                   (uint64_t{static_cast<uint8_t>(p[size >> 1])} << 8) |
+                   uint64_t{static_cast<uint8_t>(p[size - 1])};
+               b = 0;
+            } else {
+               a = b = 0;
+            }
+         } else {
+            std::size_t i = size;
+            if (i >= 48) {
+               uint64_t see1 = seed, see2 = seed;
+               do {
+                  seed = hash_mix(hash_load_u64(p) ^ hash_secret[1], hash_load_u64(p + 8) ^ seed);
+                  see1 = hash_mix(hash_load_u64(p + 16) ^ hash_secret[2], hash_load_u64(p + 24) ^ see1);
+                  see2 = hash_mix(hash_load_u64(p + 32) ^ hash_secret[3], hash_load_u64(p + 40) ^ see2);
+                  p += 48;
+                  i -= 48;
+               } while (i >= 48);
+               seed ^= see1 ^ see2;
+            }
+            while (i > 16) {
+               seed = hash_mix(hash_load_u64(p) ^ hash_secret[1], hash_load_u64(p + 8) ^ seed);
+               p += 16;
+               i -= 16;
+            }
+            a = hash_load_u64(p + i - 16);
+            b = hash_load_u64(p + i - 8);
+         }
+         a ^= hash_secret[1];
+         b ^= seed;
+         mum(a, b);
+         return hash_mix(a ^ hash_secret[0] ^ size, b ^ hash_secret[1]);
+      }
+   } // namespace detail
+
+   /**
+    * @brief Hashes a byte range.
+    * @param data The bytes to hash.
+    * @param size The number of bytes.
+    * @param seed An optional seed.
+    * @return The 64-bit hash.
+    */
+   inline uint64_t hash_bytes(const void* data, std::size_t size, uint64_t seed = 0) noexcept {
+      return detail::hash_bytes(static_cast<const std::byte*>(data), size, seed);
+   }
+
+   /**
+    * @brief Hashes a fixed_bytes value; the length is a compile time constant so the kernel is specialised on N.
+    * @param data The value to hash.
+    * @param seed An optional seed.
+    * @return The 64-bit hash.
+    */
+   template <std::size_t N, typename B>
+   constexpr inline uint64_t hash(const fixed_bytes<N,B>& data, uint64_t seed = 0) noexcept {
+      return detail::hash_bytes(data._data, N, seed);
+   }
+
+   /**
+    * @brief Hashes text; the result equals hash() of a fixed_bytes holding the same characters.
+    * @param text The text to hash.
+    * @param seed An optional seed.
+    * @return The 64-bit hash.
+    */
+   constexpr inline uint64_t hash_string(std::string_view text, uint64_t seed = 0) noexcept {
+      return detail::hash_bytes(text.data(), text.size(), seed);
+   }
+
+} // namespace versa::util
+
+template <std::size_t N, typename B>
+struct std::hash<versa::util::fixed_bytes<N,B>> {
+   inline std::size_t operator()(const versa::util::fixed_bytes<N,B>& data) const noexcept {
+      return static_cast<std::size_t>(versa::util::hash(data));
+   }
+};
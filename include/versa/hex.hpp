@@ -0,0 +1,349 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "constants.hpp"
+#include "cpu_features.hpp"
+#include "dispatch.hpp"
+#include "fixed_string.hpp"
+#include "utils.hpp"
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+   #include <immintrin.h>
+#elif defined(__ARM_NEON)
+   #include <arm_neon.h>
+#endif
+
+namespace versa::util {
+   namespace detail {
+      constexpr inline char hex_digits[] = "0123456789abcdef";
+
+      // Two output characters per input byte.
+      constexpr inline auto hex_encode_table = []() {
+         std::array<char, 512> table = {};
+         for (std::size_t i = 0; i < 256; ++i) {
+            table[2 * i]     = hex_digits[i >> 4];
+            table[2 * i + 1] = hex_digits[i & 0xF];
+         }
+         return table;
+      }();
+
+      // Nibble value of every character, or 0xFF if the character is not a hex digit.
+      constexpr inline auto hex_decode_table = []() {
+         std::array<uint8_t, 256> table = {};
+         for (std::size_t i = 0; i < 256; ++i) {
+            if (i >= '0' && i <= '9')      table[i] = static_cast<uint8_t>(i - '0');
+            else if (i >= 'a' && i <= 'f') table[i] = static_cast<uint8_t>(i - 'a' + 10);
+            else if (i >= 'A' && i <= 'F') table[i] = static_cast<uint8_t>(i - 'A' + 10);
+            else                           table[i] = 0xFF;
+         }
+         return table;
+      }();
+
+      using hex_encode_fn = void(*)(char*, const std::byte*, std::size_t) noexcept;
+      using hex_decode_fn = bool(*)(std::byte*, const char*, std::size_t) noexcept;
+
+      /**
+       * @brief Writes the 2 * size lowercase hex characters of `in` to `out`.
+       */
+      constexpr inline void hex_encode_scalar(char* out, const std::byte* in, std::size_t size) noexcept {
+         for (std::size_t i = 0; i < size; ++i) {
+            const auto b = static_cast<std::size_t>(in[i]);
+            out[2 * i]     = hex_encode_table[2 * b];
+            out[2 * i + 1] = hex_encode_table[2 * b + 1];
+         }
+      }
+
+      /**
+       * @brief Decodes 2 * size hex characters of either case from `in` into `size` bytes at `out`.
+       * @return false if any character is not a hex digit, `out` is then unspecified.
+       */
+      constexpr inline bool hex_decode_scalar(std::byte* out, const char* in, std::size_t size) noexcept {
+         uint8_t invalid = 0;
+         for (std::size_t i = 0; i < size; ++i) {
+            const uint8_t hi = hex_decode_table[static_cast<uint8_t>(in[2 * i])];
+            const uint8_t lo = hex_decode_table[static_cast<uint8_t>(in[2 * i + 1])];
+            invalid |= hi | lo;
+            out[i] = static_cast<std::byte>((hi << 4) | (lo & 0xF));
+         }
+         return !(invalid & 0x80);
+      }
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      // The x86 kernels map nibbles to characters with pshufb, and characters to nibbles with a
+      // range check per class: c - '0' < 10 for digits, (c | 0x20) - 'a' < 6 for letters.
+      VERSA_TARGET("ssse3")
+      inline __m128i hex_digits_ssse3(__m128i nibbles) noexcept {
+         return _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex_digits)), nibbles);
+      }
+
+      VERSA_TARGET("ssse3")
+      inline void hex_encode_16_ssse3(char* out, const std::byte* in) noexcept {
+         const __m128i x  = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+         const __m128i m  = _mm_set1_epi8(0x0F);
+         const __m128i hi = hex_digits_ssse3(_mm_and_si128(_mm_srli_epi16(x, 4), m));
+         const __m128i lo = hex_digits_ssse3(_mm_and_si128(x, m));
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(out),      _mm_unpacklo_epi8(hi, lo));
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(out + 16), _mm_unpackhi_epi8(hi, lo));
+      }
+
+      // Converts 16 characters to nibbles, and clears `valid` if any of them is not a hex digit.
+      VERSA_TARGET("ssse3")
+      inline __m128i hex_nibbles_ssse3(__m128i c, __m128i& valid) noexcept {
+         const __m128i digit  = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+         const __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+         const __m128i is_digit  = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+         const __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+         valid = _mm_and_si128(valid, _mm_or_si128(is_digit, is_letter));
+         return _mm_or_si128(_mm_and_si128(is_digit, digit),
+                             _mm_andnot_si128(is_digit, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+      }
+
+      // Folds each pair of nibbles into a byte with one multiply-add: hi * 16 + lo.
+      VERSA_TARGET("ssse3")
+      inline bool hex_decode_16_ssse3(std::byte* out, const char* in) noexcept {
+         __m128i valid = _mm_set1_epi8(-1);
+         const __m128i a = hex_nibbles_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in)), valid);
+         const __m128i b = hex_nibbles_ssse3(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 16)), valid);
+         const __m128i weights = _mm_set1_epi16(0x0110);
+         _mm_storeu_si128(reinterpret_cast<__m128i*>(out),
+                          _mm_packus_epi16(_mm_maddubs_epi16(a, weights), _mm_maddubs_epi16(b, weights)));
+         return _mm_movemask_epi8(valid) == 0xFFFF;
+      }
+
+      VERSA_TARGET("ssse3")
+      inline void hex_encode_ssse3(char* out, const std::byte* in, std::size_t size) noexcept {
+         std::size_t i = 0;
+         for (; i + 16 <= size; i += 16)
+            hex_encode_16_ssse3(out + 2 * i, in + i);
+         hex_encode_scalar(out + 2 * i, in + i, size - i);
+      }
+
+      VERSA_TARGET("ssse3")
+      inline bool hex_decode_ssse3(std::byte* out, const char* in, std::size_t size) noexcept {
+         bool valid = true;
+         std::size_t i = 0;
+         for (; i + 16 <= size; i += 16)
+            valid &= hex_decode_16_ssse3(out + i, in + 2 * i);
+         return hex_decode_scalar(out + i, in + 2 * i, size - i) && valid;
+      }
+
+      VERSA_TARGET("avx2")
+      inline __m256i hex_nibbles_avx2(__m256i c, __m256i& valid) noexcept {
+         const __m256i digit  = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+         const __m256i letter = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+         const __m256i is_digit  = _mm256_cmpeq_epi8(_mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+         const __m256i is_letter = _mm256_cmpeq_epi8(_mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+         valid = _mm256_and_si256(valid, _mm256_or_si256(is_digit, is_letter));
+         return _mm256_blendv_epi8(_mm256_add_epi8(letter, _mm256_set1_epi8(10)), digit, is_digit);
+      }
+
+      // unpack and pack work within 128-bit lanes, so each kernel ends with a cross-lane permute.
+      VERSA_TARGET("avx2")
+      inline void hex_encode_avx2(char* out, const std::byte* in, std::size_t size) noexcept {
+         const __m256i digits = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(hex_digits)));
+         const __m256i m      = _mm256_set1_epi8(0x0F);
+         std::size_t i = 0;
+         for (; i + 32 <= size; i += 32) {
+            const __m256i x  = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+            const __m256i hi = _mm256_shuffle_epi8(digits, _mm256_and_si256(_mm256_srli_epi16(x, 4), m));
+            const __m256i lo = _mm256_shuffle_epi8(digits, _mm256_and_si256(x, m));
+            const __m256i a  = _mm256_unpacklo_epi8(hi, lo);
+            const __m256i b  = _mm256_unpackhi_epi8(hi, lo);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i),      _mm256_permute2x128_si256(a, b, 0x20));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i + 32), _mm256_permute2x128_si256(a, b, 0x31));
+         }
+         for (; i + 16 <= size; i += 16)
+            hex_encode_16_ssse3(out + 2 * i, in + i);
+         hex_encode_scalar(out + 2 * i, in + i, size - i);
+      }
+
+      VERSA_TARGET("avx2")
+      inline bool hex_decode_avx2(std::byte* out, const char* in, std::size_t size) noexcept {
+         const __m256i weights = _mm256_set1_epi16(0x0110);
+         __m256i valid = _mm256_set1_epi8(-1);
+         std::size_t i = 0;
+         for (; i + 32 <= size; i += 32) {
+            const __m256i a = hex_nibbles_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i)), valid);
+            const __m256i b = hex_nibbles_avx2(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + 2 * i + 32)), valid);
+            const __m256i packed = _mm256_packus_epi16(_mm256_maddubs_epi16(a, weights), _mm256_maddubs_epi16(b, weights));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permute4x64_epi64(packed, 0xD8));
+         }
+         bool ok = static_cast<uint32_t>(_mm256_movemask_epi8(valid)) == 0xFFFFFFFFu;
+         for (; i + 16 <= size; i += 16)
+            ok &= hex_decode_16_ssse3(out + i, in + 2 * i);
+         return hex_decode_scalar(out + i, in + 2 * i, size - i) && ok;
+      }
+
+      using hex_encode_dispatch = dispatcher<
+         implementation<&hex_encode_avx2, info::cpu_features::avx2, info::architectures::x64 | info::architectures::x86>,
+         implementation<&hex_encode_ssse3, info::cpu_features::ssse3, info::architectures::x64 | info::architectures::x86>,
+         implementation<static_cast<hex_encode_fn>(&hex_encode_scalar)>>;
+
+      using hex_decode_dispatch = dispatcher<
+         implementation<&hex_decode_avx2, info::cpu_features::avx2, info::architectures::x64 | info::architectures::x86>,
+         implementation<&hex_decode_ssse3, info::cpu_features::ssse3, info::architectures::x64 | info::architectures::x86>,
+         implementation<static_cast<hex_decode_fn>(&hex_decode_scalar)>>;
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+      // NEON's structured loads and stores interleave and deinterleave the character pairs for free.
+      inline void hex_encode_neon(char* out, const std::byte* in, std::size_t size) noexcept {
+         const uint8x16_t digits = vld1q_u8(reinterpret_cast<const uint8_t*>(hex_digits));
+         std::size_t i = 0;
+         for (; i + 16 <= size; i += 16) {
+            const uint8x16_t x = vld1q_u8(reinterpret_cast<const uint8_t*>(in + i));
+            uint8x16x2_t pairs;
+            pairs.val[0] = vqtbl1q_u8(digits, vshrq_n_u8(x, 4));
+            pairs.val[1] = vqtbl1q_u8(digits, vandq_u8(x, vdupq_n_u8(0x0F)));
+            vst2q_u8(reinterpret_cast<uint8_t*>(out + 2 * i), pairs);
+         }
+         hex_encode_scalar(out + 2 * i, in + i, size - i);
+      }
+
+      inline uint8x16_t hex_nibbles_neon(uint8x16_t c, uint8x16_t& valid) noexcept {
+         const uint8x16_t digit     = vsubq_u8(c, vdupq_n_u8('0'));
+         const uint8x16_t letter    = vsubq_u8(vorrq_u8(c, vdupq_n_u8(0x20)), vdupq_n_u8('a'));
+         const uint8x16_t is_digit  = vcltq_u8(digit, vdupq_n_u8(10));
+         const uint8x16_t is_letter = vcltq_u8(letter, vdupq_n_u8(6));
+         valid = vandq_u8(valid, vorrq_u8(is_digit, is_letter));
+         return vbslq_u8(is_digit, digit, vaddq_u8(letter, vdupq_n_u8(10)));
+      }
+
+      inline bool hex_decode_neon(std::byte* out, const char* in, std::size_t size) noexcept {
+         uint8x16_t valid = vdupq_n_u8(0xFF);
+         std::size_t i = 0;
+         for (; i + 16 <= size; i += 16) {
+            const uint8x16x2_t pairs = vld2q_u8(reinterpret_cast<const uint8_t*>(in + 2 * i));
+            const uint8x16_t hi = hex_nibbles_neon(pairs.val[0], valid);
+            const uint8x16_t lo = hex_nibbles_neon(pairs.val[1], valid);
+            vst1q_u8(reinterpret_cast<uint8_t*>(out + i), vorrq_u8(vshlq_n_u8(hi, 4), lo));
+         }
+         return hex_decode_scalar(out + i, in + 2 * i, size - i) && vminvq_u8(valid) == 0xFF;
+      }
+#endif
+
+      /**
+       * @brief The encode kernel for this host, looked up once per call so batch loops can hoist it.
+       */
+      inline hex_encode_fn hex_encoder() noexcept {
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+         return hex_encode_dispatch::get();
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+         return &hex_encode_neon;
+#else
+         return &hex_encode_scalar;
+#endif
+      }
+
+      inline hex_decode_fn hex_decoder() noexcept {
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+         return hex_decode_dispatch::get();
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+         return &hex_decode_neon;
+#else
+         return &hex_decode_scalar;
+#endif
+      }
+   } // namespace detail
+
+   /**
+    * @brief Encodes `size` bytes as 2 * size lowercase hex characters.
+    * @param out Receives the characters, no terminator is written.
+    * @param in The bytes to encode.
+    * @param size The number of bytes.
+    */
+   inline void hex_encode(char* out, const void* in, std::size_t size) noexcept {
+      detail::hex_encoder()(out, static_cast<const std::byte*>(in), size);
+   }
+
+   /**
+    * @brief Decodes 2 * size hex characters, of either case, into `size` bytes.
+    * @param out Receives the bytes.
+    * @param in The characters to decode.
+    * @param size The number of bytes to produce.
+    * @return false if a character is not a hex digit, the contents of `out` are then unspecified.
+    */
+   inline bool hex_decode(void* out, const char* in, std::size_t size) noexcept {
+      return detail::hex_decoder()(static_cast<std::byte*>(out), in, size);
+   }
+
+   /**
+    * @brief Encodes a fixed_bytes value as hex into a caller provided buffer.
+    * @param data The value to encode.
+    * @param out Receives exactly 2 * N characters.
+    */
+   template <std::size_t N, typename B>
+   inline void to_hex(const fixed_bytes<N,B>& data, char* out) noexcept {
+      hex_encode(out, data.bytes(), N);
+   }
+
+   /**
+    * @brief Encodes a fixed_bytes value as a lowercase hex string, e.g. a git hash held as fixed_bytes<20>.
+    */
+   template <std::size_t N, typename B>
+   inline std::string to_hex(const fixed_bytes<N,B>& data) {
+      std::string result(2 * N, '\0');
+      hex_encode(result.data(), data.bytes(), N);
+      return result;
+   }
+
+   /**
+    * @brief Encodes a span of values into one packed run of 2 * N characters per value.
+    * @param data The values to encode.
+    * @param out Receives the characters, it must hold at least 2 * N * data.size() of them.
+    */
+   template <std::size_t N, typename B>
+   inline void to_hex(std::span<const fixed_bytes<N,B>> data, std::span<char> out) {
+      util::check(out.size() >= 2 * N * data.size(), "Output buffer too small for hex encoding");
+      const auto encode = detail::hex_encoder();
+      for (std::size_t i = 0; i < data.size(); ++i)
+         encode(out.data() + 2 * N * i, data[i].bytes(), N);
+   }
+
+   /**
+    * @brief Decodes a hex string into a fixed_bytes value.
+    * @param hex Exactly 2 * N hex characters, of either case.
+    * @param out Receives the value.
+    * @return false if `hex` has the wrong length or contains a non hex character.
+    */
+   template <std::size_t N, typename B>
+   inline bool from_hex(std::string_view hex, fixed_bytes<N,B>& out) noexcept {
+      return hex.size() == 2 * N && hex_decode(out.data(), hex.data(), N);
+   }
+
+   /**
+    * @brief Decodes a hex string into a fixed_bytes value.
+    * @tparam N The number of bytes, e.g. from_hex<20>(git_hash).
+    * @throws std::runtime_error if `hex` is not exactly 2 * N hex characters.
+    */
+   template <std::size_t N, typename B = std::byte>
+   inline fixed_bytes<N,B> from_hex(std::string_view hex) {
+      fixed_bytes<N,B> result;
+      util::check(from_hex(hex, result), "Invalid hex string for fixed_bytes");
+      return result;
+   }
+
+   /**
+    * @brief Decodes a packed run of 2 * N characters per value, as written by the batch to_hex.
+    * @param hex The characters, exactly 2 * N * out.size() of them.
+    * @param out Receives the values.
+    * @return The number of values decoded before the first invalid one, out.size() if all are valid.
+    */
+   template <std::size_t N, typename B>
+   inline std::size_t from_hex(std::string_view hex, std::span<fixed_bytes<N,B>> out) {
+      util::check(hex.size() == 2 * N * out.size(), "Hex input does not match the number of outputs");
+      const auto decode = detail::hex_decoder();
+      for (std::size_t i = 0; i < out.size(); ++i)
+         if (!decode(reinterpret_cast<std::byte*>(out[i].data()), hex.data() + 2 * N * i, N))
+            return i;
+      return out.size();
+   }
+
+} // namespace versa::util
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+#include <utility>
+
+#include "constants.hpp"
+
+/**
+ * VERSA_HAS_MMAP is set to 1 where the POSIX open(), fstat() and mmap() family is available, in which
+ * case their headers are included. Elsewhere files are read with the C standard library instead.
+ */
+#if VERSA_LINUX_BUILD || VERSA_UNIX_BUILD || defined(__APPLE__)
+   #include <fcntl.h>
+   #include <sys/mman.h>
+   #include <sys/stat.h>
+   #include <unistd.h>
+   #define VERSA_HAS_MMAP 1
+#else
+   #define VERSA_HAS_MMAP 0
+#endif
+
+#if VERSA_HAS_MMAP
+namespace versa::util::detail {
+   /**
+    * @brief Unmaps a mapping when it goes out of scope, unless release() was called.
+    */
+   struct unmap_guard {
+      void* addr;
+      std::size_t size;
+
+      inline unmap_guard(void* map, std::size_t length) noexcept : addr(map), size(length) {}
+      unmap_guard(const unmap_guard&) = delete;
+      unmap_guard& operator=(const unmap_guard&) = delete;
+
+      inline ~unmap_guard() {
+         if (addr)
+            ::munmap(addr, size);
+      }
+
+      inline void* release() noexcept { return std::exchange(addr, nullptr); }
+   };
+} // namespace versa::util::detail
+#endif
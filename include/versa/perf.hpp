@@ -0,0 +1,317 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <ratio>
+#include <vector>
+
+#include "constants.hpp"
+#include "cpu_features.hpp"
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+   #if defined(_MSC_VER)
+      #include <intrin.h>
+   #else
+      #include <x86intrin.h>
+   #endif
+#endif
+
+namespace versa::perf {
+   namespace detail {
+      /**
+       * @brief Reads the raw hardware counter of the target: the TSC on x86, the virtual counter on
+       * ARM64, the time CSR on RISC-V (cycle is not readable from user mode on current kernels), or the
+       * monotonic clock in nanoseconds elsewhere.
+       */
+      inline uint64_t read_counter() noexcept {
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+         return __rdtsc();
+#elif (VERSA_ARM64_BUILD) && (defined(__GNUC__) || defined(__clang__))
+         uint64_t value;
+         __asm__ volatile("mrs %0, cntvct_el0" : "=r"(value));
+         return value;
+#elif (VERSA_RISCV64_BUILD || VERSA_RISCV32_BUILD) && (defined(__GNUC__) || defined(__clang__)) && __riscv_xlen == 64
+         uint64_t value;
+         __asm__ volatile("rdtime %0" : "=r"(value));
+         return value;
+#else
+         return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+      }
+
+      /**
+       * @brief Like read_counter(), but waits for earlier instructions to finish first (rdtscp, or an
+       * isb on ARM64), so the code being timed cannot leak past the end of the measurement.
+       */
+      inline uint64_t read_counter_ordered() noexcept {
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+         unsigned int aux;
+         return __rdtscp(&aux);
+#elif (VERSA_ARM64_BUILD) && (defined(__GNUC__) || defined(__clang__))
+         uint64_t value;
+         __asm__ volatile("isb\n\tmrs %0, cntvct_el0" : "=r"(value) : : "memory");
+         return value;
+#else
+         return read_counter();
+#endif
+      }
+
+      /**
+       * @brief The counter frequency when the hardware reports it, 0 when it has to be measured.
+       */
+      inline uint64_t reported_counter_frequency() noexcept {
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+         // Leaf 0x15 gives the TSC as a ratio of the crystal clock; many hypervisors leave it empty.
+         if (info::detail::cpuid(0)[0] >= 0x15) {
+            const auto leaf = info::detail::cpuid(0x15);
+            if (leaf[0] != 0 && leaf[1] != 0 && leaf[2] != 0)
+               return uint64_t{leaf[2]} * leaf[1] / leaf[0];
+         }
+         return 0;
+#elif (VERSA_ARM64_BUILD) && (defined(__GNUC__) || defined(__clang__))
+         uint64_t value;
+         __asm__ volatile("mrs %0, cntfrq_el0" : "=r"(value));
+         return value;
+#elif (VERSA_RISCV64_BUILD || VERSA_RISCV32_BUILD) && (defined(__GNUC__) || defined(__clang__)) && __riscv_xlen == 64
+         return 0;
+#else
+         return 1000000000;
+#endif
+      }
+
+      /**
+       * @brief Measures the counter frequency against the steady clock over about `window`.
+       */
+      inline uint64_t measure_counter_frequency(std::chrono::nanoseconds window) noexcept {
+         using clock = std::chrono::steady_clock;
+         const auto start_time = clock::now();
+         const uint64_t start = read_counter_ordered();
+         auto end_time = clock::now();
+         while (end_time - start_time < window)
+            end_time = clock::now();
+         const uint64_t end = read_counter_ordered();
+         const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+         return static_cast<uint64_t>(static_cast<double>(end - start) / seconds);
+      }
+
+      inline uint64_t mul_shift_32(uint64_t a, uint64_t b) noexcept {
+#if defined(__SIZEOF_INT128__)
+         return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 32);
+#else
+         const uint64_t hi = (a >> 32) * b, lo = (a & 0xFFFFFFFFu) * b;
+         return hi + (lo >> 32);
+#endif
+      }
+   } // namespace detail
+
+   /**
+    * @brief A clock on the native counter of the target, for timing intervals down to a few cycles.
+    *
+    * ticks() costs one counter read, a fraction of a steady_clock call. Ticks become nanoseconds with
+    * one multiply by a factor found on first use, or earlier by calling calibrate() at startup. Also
+    * usable as a std::chrono clock through now().
+    */
+   class cycle_clock {
+      public:
+         using rep        = int64_t;
+         using period     = std::nano;
+         using duration   = std::chrono::duration<rep, period>;
+         using time_point = std::chrono::time_point<cycle_clock>;
+         constexpr static inline bool is_steady = true;
+
+         inline static uint64_t ticks() noexcept { return detail::read_counter(); }
+
+         /**
+          * @brief Reads the counter after all earlier instructions completed; use it to end a measurement.
+          */
+         inline static uint64_t ticks_ordered() noexcept { return detail::read_counter_ordered(); }
+
+         inline static time_point now() noexcept {
+            return time_point(duration(static_cast<rep>(to_nanoseconds(ticks()))));
+         }
+
+         /**
+          * @brief Whether the counter runs at a constant rate whatever the power state, so that ticks
+          * convert to time. On x86 this is the invariant TSC flag; the other counters always are.
+          */
+         inline static bool is_invariant() noexcept {
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+            if (info::detail::cpuid(0x80000000)[0] < 0x80000007)
+               return false;
+            return (info::detail::cpuid(0x80000007)[3] & (1u << 8)) != 0;
+#else
+            return true;
+#endif
+         }
+
+         /**
+          * @brief Determines the tick rate, measuring it if the hardware does not report it. Called on
+          * first use otherwise, which then takes about 10ms.
+          * @return The number of ticks per second.
+          */
+         inline static uint64_t calibrate() noexcept { return calibration().frequency; }
+
+         inline static uint64_t frequency() noexcept { return calibration().frequency; }
+
+         inline static uint64_t to_nanoseconds(uint64_t ticks) noexcept {
+            return detail::mul_shift_32(ticks, calibration().ns_per_tick_q32);
+         }
+
+         inline static duration to_duration(uint64_t ticks) noexcept {
+            return duration(static_cast<rep>(to_nanoseconds(ticks)));
+         }
+
+      private:
+         struct calibration_data {
+            uint64_t frequency;
+            uint64_t ns_per_tick_q32; /**< Nanoseconds per tick as 32.32 fixed point */
+         };
+
+         inline static const calibration_data& calibration() noexcept {
+            static const calibration_data data = [] {
+               uint64_t frequency = detail::reported_counter_frequency();
+               if (frequency == 0)
+                  frequency = detail::measure_counter_frequency(std::chrono::milliseconds(10));
+               frequency = std::max<uint64_t>(frequency, 1);
+               return calibration_data{frequency, static_cast<uint64_t>(1e9 * 4294967296.0 / static_cast<double>(frequency))};
+            }();
+            return data;
+         }
+   };
+
+   /**
+    * @brief An HDR style histogram: values below 2^(S+1) are counted exactly, larger ones in buckets
+    * 2^-S wide relative to their magnitude, so any recorded value is reported within that precision.
+    *
+    * Recording is an index computation and an increment with no atomics; give each thread its own
+    * histogram and merge() them for reporting.
+    * @tparam SubBucketBits S; the default of 7 keeps the relative error under 0.8%.
+    */
+   template <unsigned SubBucketBits = 7>
+   class log_linear_histogram {
+      static_assert(SubBucketBits >= 1 && SubBucketBits <= 16);
+
+      public:
+         constexpr static inline uint64_t sub_buckets = uint64_t{1} << SubBucketBits;
+         constexpr static inline std::size_t bucket_count = static_cast<std::size_t>((65 - SubBucketBits) * sub_buckets);
+
+         inline log_linear_histogram() : _counts(bucket_count, 0) {}
+
+         /**
+          * @brief The bucket of a value: the position of its top bit picks the power of two, the next S
+          * bits the linear sub bucket.
+          */
+         constexpr inline static std::size_t index_of(uint64_t value) noexcept {
+            const unsigned width = static_cast<unsigned>(std::bit_width(value));
+            const unsigned shift = width > SubBucketBits + 1 ? width - SubBucketBits - 1 : 0;
+            return static_cast<std::size_t>((uint64_t{shift} << SubBucketBits) + (value >> shift));
+         }
+
+         constexpr inline static uint64_t lowest_value(std::size_t index) noexcept {
+            const uint64_t shift = index < 2 * sub_buckets ? 0 : (index >> SubBucketBits) - 1;
+            return (index - (shift << SubBucketBits)) << shift;
+         }
+
+         constexpr inline static uint64_t highest_value(std::size_t index) noexcept {
+            const uint64_t shift = index < 2 * sub_buckets ? 0 : (index >> SubBucketBits) - 1;
+            return lowest_value(index) + ((uint64_t{1} << shift) - 1);
+         }
+
+         inline void record(uint64_t value, uint64_t count = 1) noexcept {
+            _counts[index_of(value)] += count;
+            _total += count;
+            _min = std::min(_min, value);
+            _max = std::max(_max, value);
+            _sum += static_cast<double>(value) * static_cast<double>(count);
+         }
+
+         inline void merge(const log_linear_histogram& other) noexcept {
+            for (std::size_t i = 0; i < bucket_count; ++i)
+               _counts[i] += other._counts[i];
+            _total += other._total;
+            _min = std::min(_min, other._min);
+            _max = std::max(_max, other._max);
+            _sum += other._sum;
+         }
+
+         inline void reset() noexcept {
+            std::fill(_counts.begin(), _counts.end(), 0);
+            _total = 0;
+            _min = ~uint64_t{0};
+            _max = 0;
+            _sum = 0;
+         }
+
+         inline uint64_t count() const noexcept { return _total; }
+         inline uint64_t min() const noexcept { return _total ? _min : 0; }
+         inline uint64_t max() const noexcept { return _max; }
+         inline double mean() const noexcept { return _total ? _sum / static_cast<double>(_total) : 0.0; }
+
+         /**
+          * @brief The value below which `percentile` percent of the recorded values fall, reported as the
+          * highest value of its bucket and capped at max().
+          * @param percentile From 0 to 100.
+          */
+         inline uint64_t value_at_percentile(double percentile) const noexcept {
+            if (_total == 0)
+               return 0;
+            const double clamped = std::clamp(percentile, 0.0, 100.0);
+            const uint64_t target = std::max<uint64_t>(1, static_cast<uint64_t>(clamped / 100.0 * static_cast<double>(_total) + 0.5));
+            uint64_t seen = 0;
+            for (std::size_t i = 0; i < bucket_count; ++i) {
+               seen += _counts[i];
+               if (seen >= target)
+                  return std::min(highest_value(i), _max);
+            }
+            return _max;
+         }
+
+      private:
+         std::vector<uint64_t> _counts;
+         uint64_t _total = 0;
+         uint64_t _min = ~uint64_t{0};
+         uint64_t _max = 0;
+         double _sum = 0;
+   };
+
+   using latency_histogram = log_linear_histogram<>;
+
+   /**
+    * @brief Times its own lifetime on the cycle_clock and adds the nanoseconds to a histogram or a
+    * counter when it ends.
+    */
+   class scoped_stopwatch {
+      public:
+         explicit inline scoped_stopwatch(latency_histogram& histogram) noexcept
+            : _histogram(&histogram), _start(cycle_clock::ticks()) {}
+
+         explicit inline scoped_stopwatch(uint64_t& nanoseconds) noexcept
+            : _nanoseconds(&nanoseconds), _start(cycle_clock::ticks()) {}
+
+         scoped_stopwatch(const scoped_stopwatch&) = delete;
+         scoped_stopwatch& operator=(const scoped_stopwatch&) = delete;
+
+         inline ~scoped_stopwatch() {
+            const uint64_t elapsed = cycle_clock::to_nanoseconds(cycle_clock::ticks_ordered() - _start);
+            if (_histogram)
+               _histogram->record(elapsed);
+            else
+               *_nanoseconds += elapsed;
+         }
+
+         /**
+          * @brief The nanoseconds since construction.
+          */
+         inline uint64_t elapsed() const noexcept { return cycle_clock::to_nanoseconds(cycle_clock::ticks_ordered() - _start); }
+
+      private:
+         latency_histogram* _histogram = nullptr;
+         uint64_t* _nanoseconds = nullptr;
+         uint64_t _start;
+   };
+} // namespace versa::perf
@@ -0,0 +1,622 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+#include <algorithm>
+#include <bit>
+#include <queue>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "constants.hpp"
+#include "endian.hpp"
+#include "fixed_string.hpp"
+#include "mmap.hpp"
+#include "utils.hpp"
+
+#if defined(_MSC_VER) && ((VERSA_X64_BUILD) || (VERSA_X86_BUILD))
+   #include <immintrin.h>
+#endif
+
+namespace versa::util {
+   /**
+    * @brief The order of the records in a table file.
+    */
+   enum class record_layout : uint32_t {
+      sorted    = 0, /**< Ascending keys, so records() can be scanned in order */
+      eytzinger = 1  /**< The implicit search tree in breadth first order: the first levels share cache lines */
+   };
+
+   namespace detail {
+      template <typename T>
+      constexpr inline bool is_fixed_bytes_v = false;
+
+      template <std::size_t N, typename B>
+      constexpr inline bool is_fixed_bytes_v<fixed_bytes<N,B>> = true;
+
+      template <typename T>
+      constexpr inline std::size_t fixed_bytes_size_v = 0;
+
+      template <std::size_t N, typename B>
+      constexpr inline std::size_t fixed_bytes_size_v<fixed_bytes<N,B>> = N;
+
+      inline void prefetch(const void* ptr) noexcept {
+#if defined(__GNUC__) || defined(__clang__)
+         __builtin_prefetch(ptr);
+#elif defined(_MSC_VER) && ((VERSA_X64_BUILD) || (VERSA_X86_BUILD))
+         _mm_prefetch(static_cast<const char*>(ptr), _MM_HINT_T0);
+#else
+         (void)ptr;
+#endif
+      }
+
+      /**
+       * @brief The 64 byte header of a table file, little endian on every host. The records follow it,
+       * so they are as aligned as the mapping.
+       *
+       * | Offset | Field |
+       * |--------|-------|
+       * | 0  | "VRSATBL\0" |
+       * | 8  | u32 format version |
+       * | 12 | u32 record_layout |
+       * | 16 | u32 key size, u32 value size, u32 record size, u32 record alignment |
+       * | 32 | u64 record count |
+       * | 40 | u64 offset of the first record |
+       */
+      struct record_table_header {
+         constexpr static inline std::size_t size    = 64;
+         constexpr static inline uint32_t    version = 1;
+         constexpr static inline char        magic[8] = {'V', 'R', 'S', 'A', 'T', 'B', 'L', '\0'};
+
+         record_layout layout = record_layout::sorted;
+         uint32_t key_size = 0;
+         uint32_t value_size = 0;
+         uint32_t record_size = 0;
+         uint32_t record_align = 0;
+         uint64_t count = 0;
+
+         inline void write(std::byte* out) const noexcept {
+            std::memset(out, 0, size);
+            std::memcpy(out, magic, sizeof(magic));
+            le<uint32_t>(out + 8)  = version;
+            le<uint32_t>(out + 12) = static_cast<uint32_t>(layout);
+            le<uint32_t>(out + 16) = key_size;
+            le<uint32_t>(out + 20) = value_size;
+            le<uint32_t>(out + 24) = record_size;
+            le<uint32_t>(out + 28) = record_align;
+            le<uint64_t>(out + 32) = count;
+            le<uint64_t>(out + 40) = uint64_t{size};
+         }
+
+         inline static record_table_header read(std::span<const std::byte> image) {
+            util::check(image.size() >= size && std::memcmp(image.data(), magic, sizeof(magic)) == 0, "Not a record table");
+            util::check(le<const uint32_t>(image, 8) == version, "Unsupported record table version");
+            util::check(le<const uint64_t>(image, 40) == size, "Unsupported record table layout");
+            record_table_header h;
+            h.layout       = static_cast<record_layout>(le<const uint32_t>(image, 12).load());
+            h.key_size     = le<const uint32_t>(image, 16);
+            h.value_size   = le<const uint32_t>(image, 20);
+            h.record_size  = le<const uint32_t>(image, 24);
+            h.record_align = le<const uint32_t>(image, 28);
+            h.count        = le<const uint64_t>(image, 32);
+            util::check(h.layout == record_layout::sorted || h.layout == record_layout::eytzinger, "Unknown record table layout");
+            return h;
+         }
+      };
+
+      /**
+       * @brief The leftmost node of an Eytzinger tree of n >= 1 nodes numbered from 1, i.e. the smallest key.
+       */
+      constexpr inline uint64_t eytzinger_first(uint64_t n) noexcept {
+         return std::bit_floor(n);
+      }
+
+      /**
+       * @brief The node after k in key order, 0 after the last.
+       */
+      constexpr inline uint64_t eytzinger_next(uint64_t k, uint64_t n) noexcept {
+         if (2 * k + 1 <= n) {
+            k = 2 * k + 1;
+            while (2 * k <= n)
+               k *= 2;
+            return k;
+         }
+         return k >> (std::countr_one(k) + 1);
+      }
+   } // namespace detail
+
+   /**
+    * @brief A read only table of fixed size records sorted by key, used in place in a mapped file.
+    *
+    * Opening maps the file and checks its 64 byte header; nothing is parsed or copied, and pages are
+    * read on first touch, so a table of hundreds of millions of records is usable at once and shares
+    * the page cache between processes. Files come from record_table_builder.
+    * ```
+    * record_table<fixed_bytes<32>, fixed_bytes<16>> digests("digests.tbl");
+    * if (const auto* meta = digests.find(digest)) ...
+    * ```
+    */
+   template <typename Key, typename Value>
+   requires (detail::is_fixed_bytes_v<Key> && detail::is_fixed_bytes_v<Value>)
+   class record_table {
+      public:
+         using key_type    = Key;
+         using mapped_type = Value;
+
+         /**
+          * @brief The on disk record: the key, then the value, padded to the 8 byte alignment of fixed_bytes.
+          */
+         struct record {
+            Key key;
+            Value value;
+         };
+         static_assert(std::is_trivially_copyable_v<record> && std::is_standard_layout_v<record>);
+
+         /**
+          * @brief The number of lookups find_batch() runs in lock step.
+          */
+         constexpr static inline std::size_t batch_width = 16;
+
+         record_table() = default;
+
+         /**
+          * @brief Maps a table file, reading it into memory where mmap is unavailable.
+          */
+         explicit inline record_table(const char* path) {
+#if VERSA_HAS_MMAP
+            const int fd = ::open(path, O_RDONLY | O_CLOEXEC);
+            util::check(fd >= 0, "Cannot open record table");
+            struct stat st;
+            const bool ok = ::fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size >= static_cast<off_t>(detail::record_table_header::size);
+            void* map = ok ? ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+            ::close(fd);
+            util::check(map != MAP_FAILED, "Cannot map record table");
+            _map = map;
+            _map_size = static_cast<std::size_t>(st.st_size);
+            try {
+               attach(std::span<const std::byte>(static_cast<const std::byte*>(map), _map_size));
+            } catch (...) {
+               unmap();
+               throw;
+            }
+#else
+            std::FILE* file = std::fopen(path, "rb");
+            util::check(file != nullptr, "Cannot open record table");
+            std::byte chunk[65536];
+            for (std::size_t read; (read = std::fread(chunk, 1, sizeof(chunk), file)) > 0;)
+               _owned.insert(_owned.end(), chunk, chunk + read);
+            std::fclose(file);
+            attach(_owned);
+#endif
+         }
+
+         /**
+          * @brief Uses a table image already in memory, which has to outlive the table.
+          */
+         explicit inline record_table(std::span<const std::byte> image) { attach(image); }
+
+         inline record_table(record_table&& other) noexcept { swap(other); }
+
+         inline record_table& operator=(record_table&& other) noexcept {
+            record_table(std::move(other)).swap(*this);
+            return *this;
+         }
+
+         record_table(const record_table&) = delete;
+         record_table& operator=(const record_table&) = delete;
+
+         inline ~record_table() { unmap(); }
+
+         inline void swap(record_table& other) noexcept {
+            std::swap(_records, other._records);
+            std::swap(_count, other._count);
+            std::swap(_layout, other._layout);
+            std::swap(_map, other._map);
+            std::swap(_map_size, other._map_size);
+            _owned.swap(other._owned);
+         }
+
+         inline std::size_t size() const noexcept { return static_cast<std::size_t>(_count); }
+         inline bool empty() const noexcept { return _count == 0; }
+         inline record_layout layout() const noexcept { return _layout; }
+
+         /**
+          * @brief The records in file order, ascending keys for record_layout::sorted.
+          */
+         inline std::span<const record> records() const noexcept { return {_records, size()}; }
+
+         /**
+          * @brief The value of `key`, pointing into the mapping, or nullptr.
+          */
+         inline const Value* find(const Key& key) const noexcept {
+            if (_layout == record_layout::eytzinger) {
+               uint64_t k = 1;
+               while (k <= _count)
+                  k = 2 * k + (_records[k - 1].key < key);
+               return eytzinger_match(k, key);
+            }
+            if (_count == 0)
+               return nullptr;
+            const record* base = _records;
+            for (uint64_t n = _count; n > 1;) {
+               const uint64_t half = n / 2;
+               base = base[half].key < key ? base + half : base;
+               n -= half;
+            }
+            return sorted_match(base, key);
+         }
+
+         inline bool contains(const Key& key) const noexcept { return find(key) != nullptr; }
+
+         /**
+          * @brief Looks up many keys at once, setting `out[i]` to find(keys[i]).
+          *
+          * Lookups into a large table wait on memory at every step. Here batch_width of them advance
+          * together, each prefetching its next probe, so the misses of one overlap the others' work.
+          */
+         inline void find_batch(std::span<const Key> keys, std::span<const Value*> out) const {
+            util::check(out.size() >= keys.size(), "find_batch needs a result for every key");
+            for (std::size_t start = 0; start < keys.size(); start += batch_width) {
+               const std::size_t m = std::min(batch_width, keys.size() - start);
+               const Key* batch = keys.data() + start;
+               if (_layout == record_layout::eytzinger) {
+                  uint64_t k[batch_width];
+                  std::fill_n(k, m, uint64_t{1});
+                  // Every path ends in one of the last two levels, so all but a few steps run for all.
+                  for (bool active = _count > 0; active;) {
+                     active = false;
+                     for (std::size_t j = 0; j < m; ++j) {
+                        if (k[j] <= _count) {
+                           k[j] = 2 * k[j] + (_records[k[j] - 1].key < batch[j]);
+                           if (k[j] <= _count) {
+                              detail::prefetch(_records + (k[j] - 1));
+                              active = true;
+                           }
+                        }
+                     }
+                  }
+                  for (std::size_t j = 0; j < m; ++j)
+                     out[start + j] = eytzinger_match(k[j], batch[j]);
+               } else {
+                  if (_count == 0) {
+                     std::fill_n(out.begin() + start, m, nullptr);
+                     continue;
+                  }
+                  const record* base[batch_width];
+                  std::fill_n(base, m, _records);
+                  // A search over n records takes the same steps for every key, so they share n.
+                  for (uint64_t n = _count; n > 1;) {
+                     const uint64_t half = n / 2;
+                     n -= half;
+                     for (std::size_t j = 0; j < m; ++j) {
+                        base[j] = base[j][half].key < batch[j] ? base[j] + half : base[j];
+                        detail::prefetch(base[j] + n / 2);
+                     }
+                  }
+                  for (std::size_t j = 0; j < m; ++j)
+                     out[start + j] = sorted_match(base[j], batch[j]);
+               }
+            }
+         }
+
+      private:
+         inline void attach(std::span<const std::byte> image) {
+            const auto header = detail::record_table_header::read(image);
+            util::check(header.key_size == detail::fixed_bytes_size_v<Key> && header.value_size == detail::fixed_bytes_size_v<Value> &&
+                        header.record_size == sizeof(record) && header.record_align == alignof(record),
+                        "Record table was written for other key or value types");
+            util::check(header.count <= (image.size() - detail::record_table_header::size) / sizeof(record), "Record table is truncated");
+            const std::byte* data = image.data() + detail::record_table_header::size;
+            util::check(reinterpret_cast<uintptr_t>(data) % alignof(record) == 0, "Record table image is misaligned");
+            _records = reinterpret_cast<const record*>(data);
+            _count = header.count;
+            _layout = header.layout;
+         }
+
+         inline void unmap() noexcept {
+#if VERSA_HAS_MMAP
+            if (_map)
+               ::munmap(_map, _map_size);
+#endif
+            _map = nullptr;
+         }
+
+         // k has walked off the tree; dropping the right turns after the last left one leads back to
+         // the first node not less than the key.
+         inline const Value* eytzinger_match(uint64_t k, const Key& key) const noexcept {
+            k >>= std::countr_one(k) + 1;
+            if (k == 0)
+               return nullptr;
+            const record& r = _records[k - 1];
+            return r.key == key ? &r.value : nullptr;
+         }
+
+         inline const Value* sorted_match(const record* base, const Key& key) const noexcept {
+            base += base->key < key;
+            return base != _records + _count && base->key == key ? &base->value : nullptr;
+         }
+
+         const record* _records = nullptr;
+         uint64_t _count = 0;
+         record_layout _layout = record_layout::sorted;
+         void* _map = nullptr;
+         std::size_t _map_size = 0;
+         std::vector<std::byte> _owned;
+   };
+
+   struct record_table_options {
+      record_layout layout = record_layout::eytzinger;
+      std::size_t memory_budget = std::size_t{256} << 20; /**< Bytes of records held before a sorted run goes to disk */
+   };
+
+   /**
+    * @brief Writes a record_table file from records added in any order, with bounded memory.
+    *
+    * Records collect in memory up to the budget, then are sorted and written to a temporary run
+    * file; finish() merges the runs. Tables far larger than memory build this way. When a key is
+    * added more than once the first record wins.
+    */
+   template <typename Key, typename Value>
+   class record_table_builder {
+      public:
+         using table_type = record_table<Key, Value>;
+         using record     = typename table_type::record;
+
+         explicit inline record_table_builder(std::string path, record_table_options options = {})
+            : _path(std::move(path)), _options(options),
+              _run_capacity(std::max<std::size_t>(options.memory_budget / sizeof(record), 1024)) {
+            _buffer.reserve(std::min<std::size_t>(_run_capacity, 1 << 16));
+         }
+
+         record_table_builder(const record_table_builder&) = delete;
+         record_table_builder& operator=(const record_table_builder&) = delete;
+
+         inline ~record_table_builder() {
+            for (auto& run : _runs)
+               std::fclose(run.file);
+         }
+
+         inline void add(const Key& key, const Value& value) {
+            util::check(!_finished, "record_table_builder is finished");
+            _buffer.push_back(record{key, value});
+            if (_buffer.size() >= _run_capacity)
+               spill();
+         }
+
+         /**
+          * @brief The number of runs written to disk so far.
+          */
+         inline std::size_t runs() const noexcept { return _runs.size(); }
+
+         /**
+          * @brief Writes the table file.
+          * @return The number of records in it, after dropping repeated keys.
+          */
+         inline uint64_t finish() {
+            util::check(!_finished, "record_table_builder is finished");
+            _finished = true;
+            std::FILE* out = std::fopen(_path.c_str(), "wb+");
+            util::check(out != nullptr, "Cannot create record table");
+            try {
+               const uint64_t count = write(out);
+               util::check(std::fclose(out) == 0, "Cannot write record table");
+               return count;
+            } catch (...) {
+               std::fclose(out);
+               std::remove(_path.c_str());
+               throw;
+            }
+         }
+
+      private:
+         struct run {
+            std::FILE* file;
+            uint64_t count;
+         };
+
+         inline static bool key_less(const record& a, const record& b) noexcept { return a.key < b.key; }
+         inline static bool key_equal(const record& a, const record& b) noexcept { return a.key == b.key; }
+
+         inline void sort_buffer() {
+            std::stable_sort(_buffer.begin(), _buffer.end(), key_less);
+            _buffer.erase(std::unique(_buffer.begin(), _buffer.end(), key_equal), _buffer.end());
+         }
+
+         inline void spill() {
+            sort_buffer();
+            std::FILE* file = std::tmpfile();
+            util::check(file != nullptr, "Cannot create a record table run file");
+            _runs.push_back(run{file, _buffer.size()});
+            write_records(file, _buffer.data(), _buffer.size());
+            util::check(std::fseek(file, 0, SEEK_SET) == 0, "Cannot rewind a record table run file");
+            _buffer.clear();
+         }
+
+         inline static void write_records(std::FILE* file, const record* records, std::size_t count) {
+            util::check(std::fwrite(records, sizeof(record), count, file) == count, "Cannot write record table");
+         }
+
+         /**
+          * @brief Reads a file of records in chunks.
+          */
+         struct reader {
+            std::FILE* file;
+            uint64_t remaining;
+            std::vector<record> chunk;
+            std::size_t pos = 0;
+
+            inline bool next() {
+               if (++pos < chunk.size())
+                  return true;
+               const std::size_t n = static_cast<std::size_t>(std::min<uint64_t>(remaining, chunk.capacity()));
+               chunk.resize(n);
+               util::check(std::fread(chunk.data(), sizeof(record), n, file) == n, "Cannot read a record table run file");
+               remaining -= n;
+               pos = 0;
+               return n > 0;
+            }
+
+            inline const record& current() const noexcept { return chunk[pos]; }
+         };
+
+         /**
+          * @brief Calls `f(const record&)` on the merged runs in key order, once per key.
+          */
+         template <typename F>
+         inline void merge_runs(F&& f) {
+            const std::size_t chunk_records = std::max<std::size_t>(_run_capacity / (_runs.size() + 1), 256);
+            std::vector<reader> readers;
+            readers.reserve(_runs.size());
+            for (const auto& r : _runs) {
+               readers.push_back(reader{r.file, r.count, {}, 0});
+               readers.back().chunk.reserve(chunk_records);
+               readers.back().pos = static_cast<std::size_t>(-1);
+            }
+            // Earlier runs hold earlier records, so on equal keys the lower run index comes first.
+            auto later = [&](std::size_t a, std::size_t b) {
+               const auto order = readers[a].current().key <=> readers[b].current().key;
+               return order > 0 || (order == 0 && a > b);
+            };
+            std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(later)> heap(later);
+            for (std::size_t i = 0; i < readers.size(); ++i)
+               if (readers[i].next())
+                  heap.push(i);
+            record last;
+            bool first = true;
+            while (!heap.empty()) {
+               const std::size_t i = heap.top();
+               heap.pop();
+               const record& r = readers[i].current();
+               if (first || !(r.key == last.key)) {
+                  f(r);
+                  last = r;
+                  first = false;
+               }
+               if (readers[i].next())
+                  heap.push(i);
+            }
+         }
+
+         /**
+          * @brief Calls `f(const record&)` on every record in key order, once per key.
+          * @return The number of records.
+          */
+         template <typename F>
+         inline uint64_t sorted_records(F&& f) {
+            if (_runs.empty()) {
+               sort_buffer();
+               for (const auto& r : _buffer)
+                  f(r);
+               return _buffer.size();
+            }
+            spill();
+            std::vector<record>().swap(_buffer);
+            uint64_t count = 0;
+            merge_runs([&](const record& r) {
+               f(r);
+               ++count;
+            });
+            return count;
+         }
+
+         inline uint64_t write(std::FILE* out) {
+            detail::record_table_header header;
+            header.layout       = _options.layout;
+            header.key_size     = detail::fixed_bytes_size_v<Key>;
+            header.value_size   = detail::fixed_bytes_size_v<Value>;
+            header.record_size  = sizeof(record);
+            header.record_align = alignof(record);
+            std::byte header_bytes[detail::record_table_header::size];
+
+            if (_options.layout == record_layout::sorted) {
+               header.write(header_bytes);
+               util::check(std::fwrite(header_bytes, 1, sizeof(header_bytes), out) == sizeof(header_bytes), "Cannot write record table");
+               std::vector<record> chunk;
+               chunk.reserve(4096);
+               header.count = sorted_records([&](const record& r) {
+                  chunk.push_back(r);
+                  if (chunk.size() == chunk.capacity()) {
+                     write_records(out, chunk.data(), chunk.size());
+                     chunk.clear();
+                  }
+               });
+               write_records(out, chunk.data(), chunk.size());
+               header.write(header_bytes);
+               util::check(std::fseek(out, 0, SEEK_SET) == 0, "Cannot write record table");
+               util::check(std::fwrite(header_bytes, 1, sizeof(header_bytes), out) == sizeof(header_bytes), "Cannot write record table");
+               return header.count;
+            }
+
+            // The Eytzinger position of a record depends on the final count, so merged runs go
+            // through one more sorted temporary file first.
+            std::FILE* sorted = nullptr;
+            if (!_runs.empty()) {
+               sorted = std::tmpfile();
+               util::check(sorted != nullptr, "Cannot create a record table run file");
+            }
+            try {
+               header.count = _runs.empty() ? (sort_buffer(), _buffer.size()) : sorted_records([&](const record& r) { write_records(sorted, &r, 1); });
+               header.write(header_bytes);
+               util::check(std::fwrite(header_bytes, 1, sizeof(header_bytes), out) == sizeof(header_bytes), "Cannot write record table");
+               if (sorted) {
+                  util::check(std::fseek(sorted, 0, SEEK_SET) == 0, "Cannot rewind a record table run file");
+                  reader source{sorted, header.count, {}, static_cast<std::size_t>(-1)};
+                  source.chunk.reserve(4096);
+                  place_eytzinger(out, header.count, [&]() -> const record& {
+                     source.next();
+                     return source.current();
+                  });
+                  std::fclose(sorted);
+               } else {
+                  std::size_t i = 0;
+                  place_eytzinger(out, header.count, [&]() -> const record& { return _buffer[i++]; });
+               }
+            } catch (...) {
+               if (sorted)
+                  std::fclose(sorted);
+               throw;
+            }
+            return header.count;
+         }
+
+         /**
+          * @brief Writes `count` records, taken in key order from `next()`, to their Eytzinger positions
+          * after the header. The writes land all over the file, so they go through a shared mapping.
+          */
+         template <typename F>
+         inline static void place_eytzinger(std::FILE* out, uint64_t count, F&& next) {
+            if (count == 0)
+               return;
+            const uint64_t size = detail::record_table_header::size + count * sizeof(record);
+#if VERSA_HAS_MMAP
+            util::check(std::fflush(out) == 0 && ::ftruncate(::fileno(out), static_cast<off_t>(size)) == 0, "Cannot write record table");
+            void* map = ::mmap(nullptr, static_cast<std::size_t>(size), PROT_READ | PROT_WRITE, MAP_SHARED, ::fileno(out), 0);
+            util::check(map != MAP_FAILED, "Cannot map record table for writing");
+            // next() checks what it reads and may throw.
+            const detail::unmap_guard guard{map, static_cast<std::size_t>(size)};
+            record* records = reinterpret_cast<record*>(static_cast<std::byte*>(map) + detail::record_table_header::size);
+            for (uint64_t k = detail::eytzinger_first(count); k != 0; k = detail::eytzinger_next(k, count))
+               records[k - 1] = next();
+#else
+            for (uint64_t k = detail::eytzinger_first(count); k != 0; k = detail::eytzinger_next(k, count)) {
+               util::check(std::fseek(out, static_cast<long>(detail::record_table_header::size + (k - 1) * sizeof(record)), SEEK_SET) == 0,
+                           "Cannot write record table");
+               write_records(out, &next(), 1);
+            }
+#endif
+         }
+
+         std::string _path;
+         record_table_options _options;
+         std::size_t _run_capacity;
+         std::vector<record> _buffer;
+         std::vector<run> _runs;
+         bool _finished = false;
+   };
+} // namespace versa::util
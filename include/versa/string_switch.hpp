@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <bit>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+#include "fixed_string.hpp"
+#include "hash.hpp"
+
+namespace versa::util {
+   namespace detail {
+      struct perfect_hash_params {
+         uint64_t seed;
+         std::size_t bits; /**< The table has 1 << bits slots */
+      };
+
+      /**
+       * @brief Searches for a seed under which the low bits of hash_string() give every key its own slot,
+       * starting with the smallest power of two table and growing it if no seed is found.
+       */
+      template <std::size_t Count>
+      consteval perfect_hash_params find_perfect_hash(const std::array<std::string_view, Count>& keys) {
+         for (std::size_t i = 0; i < Count; ++i)
+            for (std::size_t j = i + 1; j < Count; ++j)
+               if (keys[i] == keys[j])
+                  throw std::invalid_argument("string_switch keys must be unique");
+
+         const std::size_t min_bits = std::bit_width(Count - 1);
+         for (std::size_t bits = min_bits; bits <= min_bits + 3; ++bits) {
+            const uint64_t mask = (uint64_t{1} << bits) - 1;
+            for (uint64_t seed = 0; seed < 1024; ++seed) {
+               std::array<bool, std::bit_ceil(Count) * 8> used = {};
+               bool collision = false;
+               for (std::size_t i = 0; i < Count && !collision; ++i) {
+                  const uint64_t slot = hash_string(keys[i], seed) & mask;
+                  collision = used[slot];
+                  used[slot] = true;
+               }
+               if (!collision)
+                  return {seed, bits};
+            }
+         }
+         throw std::invalid_argument("no perfect hash found for the string_switch keys");
+      }
+
+      template <std::size_t Count, std::size_t Bits>
+      consteval auto build_perfect_hash_slots(const std::array<std::string_view, Count>& keys, uint64_t seed) {
+         using index_type = std::conditional_t<(Count < 0xFF), uint8_t, uint16_t>;
+         std::array<index_type, std::size_t{1} << Bits> slots = {};
+         for (auto& s : slots)
+            s = static_cast<index_type>(Count);
+         for (std::size_t i = 0; i < Count; ++i)
+            slots[hash_string(keys[i], seed) & ((uint64_t{1} << Bits) - 1)] = static_cast<index_type>(i);
+         return slots;
+      }
+
+      template <fixed_string... Keys>
+      struct string_switch_table {
+         static_assert(sizeof...(Keys) > 0, "string_switch needs at least one key");
+
+         constexpr static inline std::size_t count = sizeof...(Keys);
+         constexpr static inline std::array<std::string_view, count> keys = {std::string_view(Keys)...};
+         constexpr static inline perfect_hash_params params = find_perfect_hash(keys);
+         constexpr static inline uint64_t mask = (uint64_t{1} << params.bits) - 1;
+         constexpr static inline auto slots = build_perfect_hash_slots<count, params.bits>(keys, params.seed);
+      };
+   } // namespace detail
+
+   /**
+    * @brief Maps a run time string to its position in a compile time list of strings.
+    *
+    * A perfect hash over the keys is found during compilation, so a lookup costs one hash, one table
+    * load and one comparison against the single candidate, however many keys there are.
+    * ```
+    * switch (versa::util::string_switch<"get", "put", "del">(command)) {
+    *    case 0: ... // get
+    *    case 1: ... // put
+    *    case 2: ... // del
+    *    default: ... // not a known command
+    * }
+    * ```
+    * @tparam Keys The strings to match, they have to be unique.
+    * @param text The string to look up.
+    * @return The index of `text` in Keys, or sizeof...(Keys) if it is not one of them.
+    */
+   template <fixed_string... Keys>
+   constexpr inline std::size_t string_switch(std::string_view text) noexcept {
+      using table = detail::string_switch_table<Keys...>;
+      const std::size_t index = table::slots[hash_string(text, table::params.seed) & table::mask];
+      return index < table::count && table::keys[index] == text ? index : table::count;
+   }
+
+} // namespace versa::util
@@ -0,0 +1,352 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "constants.hpp"
+#include "cpu_features.hpp"
+
+namespace versa::info {
+   /**
+    * @brief The distance in bytes that keeps two objects from sharing a cache line, including the
+    * neighbour some cores prefetch along with it, so that writes to one do not slow readers of the other.
+    */
+   constexpr inline std::size_t destructive_interference_size(architectures arch) noexcept {
+      switch (arch) {
+         case architectures::x86:
+         case architectures::x64:
+         case architectures::arm64:
+            return 128; // 64 byte lines fetched in adjacent pairs
+         case architectures::ppc32:
+         case architectures::ppc64:
+            return 128;
+         case architectures::s390:
+         case architectures::s390x:
+            return 256;
+         case architectures::mips32:
+         case architectures::mips64:
+            return 32;
+         default:
+            return 64;
+      }
+   }
+
+   /**
+    * @brief The largest size in bytes of memory that can be expected to fit in one cache line, so
+    * that objects used together are loaded together.
+    */
+   constexpr inline std::size_t constructive_interference_size(architectures arch) noexcept {
+      switch (arch) {
+         case architectures::ppc32:
+         case architectures::ppc64:
+            return 128;
+         case architectures::s390:
+         case architectures::s390x:
+            return 256;
+         case architectures::mips32:
+         case architectures::mips64:
+            return 32;
+         default:
+            return 64;
+      }
+   }
+
+   constexpr inline std::size_t hardware_destructive_interference_size  = destructive_interference_size(build_architecture);
+   constexpr inline std::size_t hardware_constructive_interference_size = constructive_interference_size(build_architecture);
+
+   enum class cache_types : uint8_t {
+      unknown     = 0x0, /**< Unknown cache type */
+      data        = 0x1, /**< Data cache */
+      instruction = 0x2, /**< Instruction cache */
+      unified     = 0x3  /**< Unified data and instruction cache */
+   };
+
+   struct cache_info {
+      uint32_t level = 0;
+      cache_types type = cache_types::unknown;
+      std::size_t size = 0;       /**< Bytes */
+      std::size_t line_size = 0;  /**< Bytes */
+      uint32_t ways = 0;          /**< Associativity, 0 if unknown */
+      uint32_t shared_by = 1;     /**< Logical cores sharing one instance of this cache */
+   };
+
+   /**
+    * @brief The caches, cores and NUMA nodes of the machine the process is running on.
+    *
+    * Unlike build_info this is discovered at run time: from sysfs on Linux, with cpuid filling in the
+    * caches on x86 when sysfs lacks them, and from std::thread and the constexpr interference sizes
+    * otherwise. get() reads it once and caches it; load() reads it from any sysfs tree, e.g. a fake
+    * one in tests.
+    */
+   struct host_topology {
+      std::size_t cache_line_size = hardware_constructive_interference_size;
+      std::vector<cache_info> caches;  /**< Ordered by level, data caches before instruction caches */
+      uint32_t logical_cores = 1;
+      uint32_t physical_cores = 1;
+      uint32_t packages = 1;
+      uint32_t numa_nodes = 1;
+
+      /**
+       * @brief Logical cores per physical core, e.g. 2 with hyper-threading.
+       */
+      inline uint32_t smt_width() const noexcept { return std::max<uint32_t>(1, logical_cores / std::max<uint32_t>(1, physical_cores)); }
+
+      /**
+       * @brief The data or unified cache of the given level, nullptr if there is none.
+       */
+      inline const cache_info* data_cache(uint32_t level) const noexcept {
+         for (const auto& c : caches)
+            if (c.level == level && (c.type == cache_types::data || c.type == cache_types::unified))
+               return &c;
+         return nullptr;
+      }
+
+      inline std::size_t l1d_size() const noexcept { return cache_size(1); }
+      inline std::size_t l2_size() const noexcept { return cache_size(2); }
+      inline std::size_t l3_size() const noexcept { return cache_size(3); }
+
+      inline static host_topology load(std::string_view sysfs_root = "/sys");
+      inline static const host_topology& get();
+      inline static const host_topology& reload(std::string_view sysfs_root = "/sys");
+
+      private:
+         inline std::size_t cache_size(uint32_t level) const noexcept {
+            const cache_info* c = data_cache(level);
+            return c ? c->size : 0;
+         }
+   };
+
+   namespace detail {
+      /**
+       * @brief Reads a small text file such as a sysfs attribute, without the trailing newline.
+       * @return false if the file could not be read.
+       */
+      inline bool read_small_file(const std::string& path, std::string& out) {
+         out.clear();
+         std::FILE* file = std::fopen(path.c_str(), "r");
+         if (!file)
+            return false;
+         char buffer[4096];
+         std::size_t n;
+         while ((n = std::fread(buffer, 1, sizeof(buffer), file)) > 0)
+            out.append(buffer, n);
+         std::fclose(file);
+         while (!out.empty() && (out.back() == '\n' || out.back() == ' '))
+            out.pop_back();
+         return true;
+      }
+
+      inline bool parse_unsigned(std::string_view text, uint64_t& value) {
+         const auto result = std::from_chars(text.data(), text.data() + text.size(), value);
+         return result.ec == std::errc{} && result.ptr == text.data() + text.size();
+      }
+
+      /**
+       * @brief Parses a kernel cpu list, like "0-3,8,10-11", into the ids it names.
+       */
+      inline std::vector<uint32_t> parse_cpu_list(std::string_view text) {
+         std::vector<uint32_t> ids;
+         while (!text.empty()) {
+            const std::size_t comma = text.find(',');
+            const std::string_view item = text.substr(0, comma);
+            text = comma == std::string_view::npos ? std::string_view{} : text.substr(comma + 1);
+            const std::size_t dash = item.find('-');
+            uint64_t first = 0, last = 0;
+            if (!parse_unsigned(item.substr(0, dash), first))
+               continue;
+            if (dash == std::string_view::npos)
+               last = first;
+            else if (!parse_unsigned(item.substr(dash + 1), last) || last < first)
+               continue;
+            for (uint64_t id = first; id <= last; ++id)
+               ids.push_back(static_cast<uint32_t>(id));
+         }
+         return ids;
+      }
+
+      /**
+       * @brief Parses a sysfs cache size, like "48K" or "2M".
+       */
+      inline std::size_t parse_cache_size(std::string_view text) {
+         uint64_t scale = 1;
+         if (!text.empty()) {
+            switch (text.back()) {
+               case 'K': scale = uint64_t{1} << 10; break;
+               case 'M': scale = uint64_t{1} << 20; break;
+               case 'G': scale = uint64_t{1} << 30; break;
+               default: break;
+            }
+            if (scale != 1)
+               text.remove_suffix(1);
+         }
+         uint64_t value = 0;
+         return parse_unsigned(text, value) ? static_cast<std::size_t>(value * scale) : 0;
+      }
+
+      inline bool read_sysfs_number(const std::string& path, uint64_t& value) {
+         std::string text;
+         return read_small_file(path, text) && parse_unsigned(text, value);
+      }
+
+      inline void sort_caches(std::vector<cache_info>& caches) {
+         std::sort(caches.begin(), caches.end(), [](const cache_info& a, const cache_info& b) {
+            return std::pair(a.level, a.type) < std::pair(b.level, b.type);
+         });
+      }
+
+      /**
+       * @brief Fills `topology` from `<root>/devices/system`.
+       * @return false if the tree has no cpu list, in which case `topology` is unchanged.
+       */
+      inline bool read_sysfs_topology(std::string_view root, host_topology& topology) {
+         const std::string system = std::string(root) + "/devices/system";
+         std::string text;
+         if (!read_small_file(system + "/cpu/online", text))
+            return false;
+         const std::vector<uint32_t> cpus = parse_cpu_list(text);
+         if (cpus.empty())
+            return false;
+
+         std::vector<std::pair<uint64_t, uint64_t>> cores; // (package, core)
+         std::vector<uint64_t> packages;
+         for (const uint32_t cpu : cpus) {
+            const std::string dir = system + "/cpu/cpu" + std::to_string(cpu) + "/topology/";
+            uint64_t package = 0, core = cpu;
+            read_sysfs_number(dir + "physical_package_id", package);
+            read_sysfs_number(dir + "core_id", core);
+            cores.emplace_back(package, core);
+            packages.push_back(package);
+         }
+         std::sort(cores.begin(), cores.end());
+         std::sort(packages.begin(), packages.end());
+
+         std::vector<cache_info> caches;
+         const std::string cache_dir = system + "/cpu/cpu" + std::to_string(cpus.front()) + "/cache/index";
+         for (uint32_t index = 0;; ++index) {
+            const std::string dir = cache_dir + std::to_string(index) + "/";
+            uint64_t level = 0;
+            if (!read_sysfs_number(dir + "level", level))
+               break;
+            cache_info cache;
+            cache.level = static_cast<uint32_t>(level);
+            if (read_small_file(dir + "type", text))
+               cache.type = text == "Data" ? cache_types::data : text == "Instruction" ? cache_types::instruction
+                          : text == "Unified" ? cache_types::unified : cache_types::unknown;
+            if (read_small_file(dir + "size", text))
+               cache.size = parse_cache_size(text);
+            uint64_t value = 0;
+            if (read_sysfs_number(dir + "coherency_line_size", value))
+               cache.line_size = static_cast<std::size_t>(value);
+            if (read_sysfs_number(dir + "ways_of_associativity", value))
+               cache.ways = static_cast<uint32_t>(value);
+            if (read_small_file(dir + "shared_cpu_list", text))
+               cache.shared_by = std::max<uint32_t>(1, static_cast<uint32_t>(parse_cpu_list(text).size()));
+            caches.push_back(cache);
+         }
+         sort_caches(caches);
+
+         topology.logical_cores  = static_cast<uint32_t>(cpus.size());
+         topology.physical_cores = static_cast<uint32_t>(std::unique(cores.begin(), cores.end()) - cores.begin());
+         topology.packages       = static_cast<uint32_t>(std::unique(packages.begin(), packages.end()) - packages.begin());
+         topology.caches         = std::move(caches);
+         if (const cache_info* l1 = topology.data_cache(1); l1 && l1->line_size)
+            topology.cache_line_size = l1->line_size;
+         if (read_small_file(system + "/node/online", text))
+            topology.numa_nodes = std::max<uint32_t>(1, static_cast<uint32_t>(parse_cpu_list(text).size()));
+         return true;
+      }
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      /**
+       * @brief Fills the caches of `topology` from the deterministic cache parameters of cpuid, leaf 4
+       * on Intel and leaf 0x8000001D on AMD, which share a layout.
+       */
+      inline void read_cpuid_caches(host_topology& topology) noexcept {
+         uint32_t leaf = 0;
+         if (cpuid(0)[0] >= 4 && (cpuid(4, 0)[0] & 0x1F) != 0)
+            leaf = 4;
+         else if (cpuid(0x80000000)[0] >= 0x8000001D)
+            leaf = 0x8000001D;
+         if (leaf == 0)
+            return;
+
+         std::vector<cache_info> caches;
+         for (uint32_t sub = 0; sub < 16; ++sub) {
+            const auto regs = cpuid(leaf, sub);
+            const uint32_t type = regs[0] & 0x1F;
+            if (type == 0)
+               break;
+            cache_info cache;
+            cache.level     = (regs[0] >> 5) & 0x7;
+            cache.type      = type <= 3 ? static_cast<cache_types>(type) : cache_types::unknown;
+            cache.line_size = (regs[1] & 0xFFF) + 1;
+            cache.ways      = ((regs[1] >> 22) & 0x3FF) + 1;
+            cache.size      = std::size_t{cache.ways} * (((regs[1] >> 12) & 0x3FF) + 1) * cache.line_size * (std::size_t{regs[2]} + 1);
+            cache.shared_by = ((regs[0] >> 14) & 0xFFF) + 1;
+            caches.push_back(cache);
+         }
+         sort_caches(caches);
+         topology.caches = std::move(caches);
+         if (const cache_info* l1 = topology.data_cache(1); l1 && l1->line_size)
+            topology.cache_line_size = l1->line_size;
+      }
+#endif
+
+      inline std::atomic<const host_topology*> cached_topology{nullptr};
+      inline std::mutex topology_mutex;
+   } // namespace detail
+
+   /**
+    * @brief Reads the topology without caching it.
+    * @param sysfs_root Where sysfs is mounted; a directory holding `devices/system/...` in tests.
+    */
+   inline host_topology host_topology::load(std::string_view sysfs_root) {
+      host_topology topology;
+      topology.logical_cores = topology.physical_cores = std::max(1u, std::thread::hardware_concurrency());
+      detail::read_sysfs_topology(sysfs_root, topology);
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      // Some virtual machines and containers expose the cpus but not their caches.
+      if (topology.caches.empty())
+         detail::read_cpuid_caches(topology);
+#endif
+      return topology;
+   }
+
+   /**
+    * @brief The topology of the host, read on the first call and then a single atomic load.
+    */
+   inline const host_topology& host_topology::get() {
+      const host_topology* topology = detail::cached_topology.load(std::memory_order_acquire);
+      if (topology) [[likely]]
+         return *topology;
+      std::lock_guard<std::mutex> lock(detail::topology_mutex);
+      topology = detail::cached_topology.load(std::memory_order_relaxed);
+      if (!topology) {
+         topology = new host_topology(load());
+         detail::cached_topology.store(topology, std::memory_order_release);
+      }
+      return *topology;
+   }
+
+   /**
+    * @brief Reads the topology again, from `sysfs_root`, and makes it the one get() returns. Earlier
+    * results are never freed, so references to them stay valid; meant for tests and for hot-plug.
+    */
+   inline const host_topology& host_topology::reload(std::string_view sysfs_root) {
+      std::lock_guard<std::mutex> lock(detail::topology_mutex);
+      const host_topology* topology = new host_topology(load(sysfs_root));
+      detail::cached_topology.store(topology, std::memory_order_release);
+      return *topology;
+   }
+} // namespace versa::info
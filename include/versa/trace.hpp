@@ -0,0 +1,379 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <thread>
+
+#include "constants.hpp"
+#include "utils.hpp"
+
+/**
+ * VERSA_TRACING turns VERSA_TRACE_SCOPE and VERSA_TRACE_COUNTER on. It defaults to 1 in trace and
+ * profile builds (VERSA_TRACE_BUILD, VERSA_PROFILE_BUILD) and to 0 otherwise, where the macros expand
+ * to nothing. The classes below are always available, so translation units may differ.
+ *
+ * VERSA_TRACE_BUFFER_EVENTS is the capacity, a power of two, of each thread's event ring.
+ */
+#ifndef VERSA_TRACING
+   #if VERSA_TRACE_BUILD || VERSA_PROFILE_BUILD
+      #define VERSA_TRACING 1
+   #else
+      #define VERSA_TRACING 0
+   #endif
+#endif
+
+#ifndef VERSA_TRACE_BUFFER_EVENTS
+   #define VERSA_TRACE_BUFFER_EVENTS 16384
+#endif
+
+namespace versa::trace {
+   enum class event_kind : uint32_t {
+      scope   = 0x1, /**< A completed scope, `value` is its duration in nanoseconds */
+      counter = 0x2  /**< A counter sample, `value` is the sample */
+   };
+
+   /**
+    * @brief One recorded event. `name` has to outlive the trace, e.g. a string literal.
+    */
+   struct event {
+      const char* name;
+      uint64_t timestamp; /**< Nanoseconds on the steady clock */
+      uint64_t value;
+      uint32_t thread;
+      event_kind kind;
+   };
+
+   inline uint64_t now() noexcept {
+      return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+         std::chrono::steady_clock::now().time_since_epoch()).count());
+   }
+
+   namespace detail {
+      /**
+       * @brief A single producer, single consumer ring of events owned by one thread at a time.
+       *
+       * The owning thread is the only writer of `head` and the flusher the only writer of `tail`, so
+       * recording is a plain store and a release store; a full ring drops the event and counts it.
+       */
+      struct thread_buffer {
+         constexpr static inline std::size_t capacity = VERSA_TRACE_BUFFER_EVENTS;
+         static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "VERSA_TRACE_BUFFER_EVENTS must be a power of two");
+
+         inline void push(const event& e) noexcept {
+            const uint64_t h = head.load(std::memory_order_relaxed);
+            if (h - tail.load(std::memory_order_acquire) == capacity) [[unlikely]] {
+               dropped.fetch_add(1, std::memory_order_relaxed);
+               return;
+            }
+            events[h & (capacity - 1)] = e;
+            head.store(h + 1, std::memory_order_release);
+         }
+
+         template <typename F>
+         inline std::size_t drain(F&& f) {
+            const uint64_t h = head.load(std::memory_order_acquire);
+            uint64_t t = tail.load(std::memory_order_relaxed);
+            const std::size_t count = static_cast<std::size_t>(h - t);
+            for (; t != h; ++t)
+               f(static_cast<const event&>(events[t & (capacity - 1)]));
+            tail.store(h, std::memory_order_release);
+            return count;
+         }
+
+         alignas(64) std::atomic<uint64_t> head{0};
+         alignas(64) std::atomic<uint64_t> tail{0};
+         std::atomic<uint64_t> dropped{0};
+         std::atomic<bool> in_use{true};
+         uint32_t thread = 0;
+         thread_buffer* next = nullptr;
+         std::array<event, capacity> events;
+      };
+
+      /**
+       * @brief Every thread buffer ever created. Buffers are never freed, so events recorded during
+       * static destruction are still safe; the buffer of a finished thread goes to the next new thread,
+       * and events that thread records after releasing it are dropped.
+       */
+      struct buffer_registry {
+         std::atomic<thread_buffer*> buffers{nullptr};
+         std::atomic<uint32_t> threads{0};
+         std::atomic<uint64_t> unbuffered{0}; /**< Events of threads without a buffer, see local_buffer() */
+         std::mutex flush_mutex; /**< Serializes consumers only, recording never takes it */
+      };
+
+      inline buffer_registry registry;
+
+      inline thread_local thread_buffer* current_buffer = nullptr;
+      inline thread_local bool buffer_released = false;
+
+      // Once the buffer goes back to the pool another thread may take it, so this thread stops
+      // recording; thread_local destructors that run later only count their events as dropped.
+      struct thread_release {
+         thread_buffer* buffer = nullptr;
+         ~thread_release() {
+            if (buffer) {
+               current_buffer = nullptr;
+               buffer_released = true;
+               buffer->in_use.store(false, std::memory_order_release);
+            }
+         }
+      };
+
+      inline thread_buffer* acquire_buffer() noexcept {
+         if (buffer_released)
+            return nullptr;
+         thread_buffer* buffer = nullptr;
+         for (thread_buffer* b = registry.buffers.load(std::memory_order_acquire); b && !buffer; b = b->next)
+            if (!b->in_use.load(std::memory_order_relaxed) && !b->in_use.exchange(true, std::memory_order_acquire))
+               buffer = b;
+         if (!buffer) {
+            buffer = new (std::nothrow) thread_buffer;
+            if (!buffer)
+               return nullptr;
+            thread_buffer* head = registry.buffers.load(std::memory_order_relaxed);
+            do {
+               buffer->next = head;
+            } while (!registry.buffers.compare_exchange_weak(head, buffer, std::memory_order_release, std::memory_order_relaxed));
+         }
+         buffer->thread = registry.threads.fetch_add(1, std::memory_order_relaxed) + 1;
+         thread_local thread_release release;
+         release.buffer = buffer;
+         return buffer;
+      }
+
+      /**
+       * @brief The calling thread's buffer; only the first event of a thread takes the slow path.
+       * @return nullptr if a buffer could not be allocated or the thread has already released its
+       * buffer, in which case the event is counted as dropped.
+       */
+      inline thread_buffer* local_buffer() noexcept {
+         thread_buffer* buffer = current_buffer;
+         if (!buffer) [[unlikely]] {
+            current_buffer = buffer = acquire_buffer();
+            if (!buffer)
+               registry.unbuffered.fetch_add(1, std::memory_order_relaxed);
+         }
+         return buffer;
+      }
+
+      inline void append_json_string(std::string& out, const char* text) {
+         out += '"';
+         for (; *text; ++text) {
+            const char c = *text;
+            if (c == '"' || c == '\\') {
+               out += '\\';
+               out += c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+               char escaped[8];
+               std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned>(c));
+               out += escaped;
+            } else {
+               out += c;
+            }
+         }
+         out += '"';
+      }
+
+      inline void append_microseconds(std::string& out, uint64_t ns) {
+         char buffer[32];
+         const int size = std::snprintf(buffer, sizeof(buffer), "%llu.%03u", static_cast<unsigned long long>(ns / 1000),
+                                        static_cast<unsigned>(ns % 1000));
+         out.append(buffer, static_cast<std::size_t>(size));
+      }
+   } // namespace detail
+
+   /**
+    * @brief Records a counter sample on the calling thread.
+    */
+   inline void counter(const char* name, uint64_t value) noexcept {
+      if (detail::thread_buffer* buffer = detail::local_buffer())
+         buffer->push({name, now(), value, buffer->thread, event_kind::counter});
+   }
+
+   /**
+    * @brief Records the time from construction to destruction as one event.
+    */
+   class scope {
+      public:
+         explicit inline scope(const char* name) noexcept : _name(name), _start(now()) {}
+         scope(const scope&) = delete;
+         scope& operator=(const scope&) = delete;
+
+         inline ~scope() {
+            const uint64_t end = now();
+            if (detail::thread_buffer* buffer = detail::local_buffer())
+               buffer->push({_name, _start, end - _start, buffer->thread, event_kind::scope});
+         }
+
+      private:
+         const char* _name;
+         uint64_t _start;
+   };
+
+   /**
+    * @brief Hands every event recorded so far, on all threads, to `f(const event&)`; events of one
+    * thread arrive in the order they were recorded.
+    * @return The number of events.
+    */
+   template <typename F>
+   inline std::size_t drain(F&& f) {
+      std::lock_guard<std::mutex> lock(detail::registry.flush_mutex);
+      std::size_t count = 0;
+      for (detail::thread_buffer* b = detail::registry.buffers.load(std::memory_order_acquire); b; b = b->next)
+         count += b->drain(f);
+      return count;
+   }
+
+   /**
+    * @brief The number of events lost since the start of the process, to full rings or to threads
+    * that had no buffer.
+    */
+   inline uint64_t dropped() noexcept {
+      uint64_t count = detail::registry.unbuffered.load(std::memory_order_relaxed);
+      for (detail::thread_buffer* b = detail::registry.buffers.load(std::memory_order_acquire); b; b = b->next)
+         count += b->dropped.load(std::memory_order_relaxed);
+      return count;
+   }
+
+   /**
+    * @brief Appends one event in the Chrome trace event format, which chrome://tracing and Perfetto load.
+    */
+   inline void append_chrome_json(std::string& out, const event& e) {
+      out += "{\"name\":";
+      detail::append_json_string(out, e.name);
+      if (e.kind == event_kind::scope) {
+         out += ",\"ph\":\"X\",\"ts\":";
+         detail::append_microseconds(out, e.timestamp);
+         out += ",\"dur\":";
+         detail::append_microseconds(out, e.value);
+      } else {
+         out += ",\"ph\":\"C\",\"ts\":";
+         detail::append_microseconds(out, e.timestamp);
+         out += ",\"args\":{\"value\":";
+         out += std::to_string(e.value);
+         out += '}';
+      }
+      out += ",\"pid\":1,\"tid\":";
+      out += std::to_string(e.thread);
+      out += '}';
+   }
+
+   /**
+    * @brief Writes drained events to a file as a Chrome trace (`{"traceEvents":[...]}`).
+    */
+   class chrome_json_writer {
+      public:
+         /**
+          * @param file An open file, not closed by the writer.
+          */
+         explicit inline chrome_json_writer(std::FILE* file) : _file(file) {
+            util::check(file != nullptr, "chrome_json_writer needs an open file");
+            std::fputs("{\"traceEvents\":[\n", _file);
+         }
+
+         chrome_json_writer(const chrome_json_writer&) = delete;
+         chrome_json_writer& operator=(const chrome_json_writer&) = delete;
+
+         inline ~chrome_json_writer() { close(); }
+
+         /**
+          * @brief Drains all threads' events into the file.
+          * @return The number of events written.
+          */
+         inline std::size_t flush() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (_closed)
+               return 0;
+            _text.clear();
+            const std::size_t count = drain([&](const event& e) {
+               if (!_first)
+                  _text += ",\n";
+               _first = false;
+               append_chrome_json(_text, e);
+            });
+            std::fwrite(_text.data(), 1, _text.size(), _file);
+            std::fflush(_file);
+            return count;
+         }
+
+         /**
+          * @brief Flushes the remaining events and terminates the JSON.
+          */
+         inline void close() {
+            flush();
+            std::lock_guard<std::mutex> lock(_mutex);
+            if (!_closed) {
+               std::fputs("\n]}\n", _file);
+               std::fflush(_file);
+               _closed = true;
+            }
+         }
+
+      private:
+         std::FILE* _file;
+         std::mutex _mutex;
+         std::string _text;
+         bool _first = true;
+         bool _closed = false;
+   };
+
+   /**
+    * @brief Flushes a writer periodically from a thread of its own until destroyed.
+    */
+   class background_flusher {
+      public:
+         inline background_flusher(chrome_json_writer& writer, std::chrono::milliseconds period)
+            : _thread([this, &writer, period] {
+                 std::unique_lock<std::mutex> lock(_mutex);
+                 while (!_stop) {
+                    _wake.wait_for(lock, period, [this] { return _stop; });
+                    lock.unlock();
+                    writer.flush();
+                    lock.lock();
+                 }
+              }) {}
+
+         background_flusher(const background_flusher&) = delete;
+         background_flusher& operator=(const background_flusher&) = delete;
+
+         inline ~background_flusher() {
+            {
+               std::lock_guard<std::mutex> lock(_mutex);
+               _stop = true;
+            }
+            _wake.notify_one();
+            _thread.join();
+         }
+
+      private:
+         std::mutex _mutex;
+         std::condition_variable _wake;
+         bool _stop = false;
+         std::thread _thread;
+   };
+} // namespace versa::trace
+
+#define VERSA_TRACE_CONCAT_IMPL(a, b) a##b
+#define VERSA_TRACE_CONCAT(a, b) VERSA_TRACE_CONCAT_IMPL(a, b)
+
+/**
+ * @brief VERSA_TRACE_SCOPE("name") times the enclosing scope; VERSA_TRACE_COUNTER("name", value)
+ * samples a counter. Names have to be string literals. Both expand to nothing unless VERSA_TRACING.
+ */
+#if VERSA_TRACING
+   #define VERSA_TRACE_SCOPE(name) ::versa::trace::scope VERSA_TRACE_CONCAT(versa_trace_scope_, __LINE__){name}
+   #define VERSA_TRACE_COUNTER(name, value) ::versa::trace::counter(name, static_cast<uint64_t>(value))
+#else
+   #define VERSA_TRACE_SCOPE(name) static_cast<void>(0)
+   #define VERSA_TRACE_COUNTER(name, value) static_cast<void>(0)
+#endif
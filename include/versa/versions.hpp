@@ -0,0 +1,592 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <compare>
+#include <span>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "constants.hpp"
+#include "cpu_features.hpp"
+#include "dispatch.hpp"
+#include "fixed_string.hpp"
+#include "hex.hpp"
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+   #include <immintrin.h>
+#elif defined(__ARM_NEON)
+   #include <arm_neon.h>
+#endif
+
+namespace versa::info {
+   /**
+    * @brief The outcome of parse_versions().
+    */
+   struct parse_versions_result {
+      std::size_t parsed   = 0;                      /**< Versions written to the output */
+      std::size_t failed   = 0;                      /**< Non-empty lines that did not parse and were skipped */
+      std::size_t consumed = 0;                      /**< Bytes of input processed; less than the input if the output filled up */
+      std::size_t first_failure = std::string_view::npos; /**< Offset of the first line that did not parse */
+   };
+
+   namespace detail {
+      using parse_versions_fn = parse_versions_result(*)(std::string_view, std::span<version_view>) noexcept;
+
+      // One bit per byte of a 64 byte block that is a '\n'.
+      inline uint64_t newline_mask_portable(const char* p) noexcept {
+         constexpr uint64_t lsbs = 0x0101010101010101ull, msbs = 0x8080808080808080ull;
+         uint64_t mask = 0;
+         for (std::size_t i = 0; i < 64; i += 8) {
+            uint64_t w;
+            std::memcpy(&w, p + i, sizeof(w));
+            if constexpr (std::endian::native == std::endian::big)
+               w = __builtin_bswap64(w);
+            w ^= lsbs * '\n';
+            // Exact zero-byte test, the cheaper (w - lsbs) & ~w form lets borrows leak into the next byte.
+            const uint64_t zero = ~(((w & ~msbs) + ~msbs) | w) & msbs;
+            mask |= ((zero >> 7) * 0x0102040810204080ull >> 56) << i;
+         }
+         return mask;
+      }
+
+      using fast_parse_fn = bool(*)(const char*, std::size_t, version_view&) noexcept;
+
+      // FastParse, when given, handles lines that have 64 readable bytes and declines anything unusual,
+      // which then goes through parse_version() so results and error handling never differ.
+      template <fast_parse_fn FastParse>
+      [[gnu::always_inline]] inline void parse_version_line(std::string_view buffer, std::size_t begin, std::size_t end,
+                                                            std::span<version_view> out, parse_versions_result& result) noexcept {
+         if (end > begin && buffer[end - 1] == '\r')
+            --end;
+         if (end == begin)
+            return;
+         if constexpr (FastParse != nullptr) {
+            if (begin + 64 <= buffer.size() && FastParse(buffer.data() + begin, end - begin, out[result.parsed])) [[likely]] {
+               ++result.parsed;
+               return;
+            }
+         }
+         if (parse_version(buffer.substr(begin, end - begin), out[result.parsed]) == std::errc{}) {
+            ++result.parsed;
+         } else {
+            if (result.failed++ == 0)
+               result.first_failure = begin;
+         }
+      }
+
+      /**
+       * @brief The batch driver: finds every newline of a 64 byte block as a bit mask, then parses the
+       * lines between the set bits, so delimiter search costs a few vector instructions per block.
+       */
+      template <uint64_t (*NewlineMask)(const char*), fast_parse_fn FastParse = nullptr>
+      [[gnu::always_inline]] inline parse_versions_result parse_versions_impl(std::string_view buffer, std::span<version_view> out) noexcept {
+         parse_versions_result result;
+         const char* data = buffer.data();
+         const std::size_t size = buffer.size();
+         std::size_t line = 0;
+
+         auto scan = [&](uint64_t mask, std::size_t base) {
+            for (; mask; mask &= mask - 1) {
+               if (result.parsed == out.size())
+                  return false;
+               const std::size_t nl = base + std::countr_zero(mask);
+               parse_version_line<FastParse>(buffer, line, nl, out, result);
+               line = nl + 1;
+            }
+            return true;
+         };
+
+         std::size_t base = 0;
+         bool room = true;
+         for (; room && base + 64 <= size; base += 64)
+            room = scan(NewlineMask(data + base), base);
+         if (room && base < size) {
+            char tail[64] = {};
+            std::memcpy(tail, data + base, size - base);
+            room = scan(NewlineMask(tail), base);
+         }
+         if (room && line < size) {
+            if (result.parsed < out.size()) {
+               parse_version_line<FastParse>(buffer, line, size, out, result);
+               line = size;
+            } else {
+               room = false;
+            }
+         }
+         result.consumed = room ? size : line;
+         return result;
+      }
+
+      inline parse_versions_result parse_versions_portable(std::string_view buffer, std::span<version_view> out) noexcept {
+         return parse_versions_impl<&newline_mask_portable>(buffer, out);
+      }
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      [[gnu::always_inline]] inline uint64_t newline_mask_sse2(const char* p) noexcept {
+         const __m128i nl = _mm_set1_epi8('\n');
+         uint64_t mask = 0;
+         for (std::size_t i = 0; i < 64; i += 16)
+            mask |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(
+                       _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i)), nl)))) << i;
+         return mask;
+      }
+
+      VERSA_TARGET("avx2")
+      inline uint64_t newline_mask_avx2(const char* p) noexcept {
+         const __m256i nl = _mm256_set1_epi8('\n');
+         const uint32_t lo = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), nl)));
+         const uint32_t hi = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 32)), nl)));
+         return (static_cast<uint64_t>(hi) << 32) | lo;
+      }
+
+      /**
+       * @brief Character classes of a 64 byte window, one bit per byte.
+       */
+      struct version_masks {
+         uint64_t digit;
+         uint64_t dot;
+         uint64_t alnum;
+         uint64_t ident;
+      };
+
+      [[gnu::always_inline]] inline uint32_t version_run(uint64_t mask, std::size_t at) noexcept {
+         return at < 64 ? static_cast<uint32_t>(std::countr_one(mask >> at)) : 0;
+      }
+
+      // Converts 1 to 5 ASCII digits at p to their value: the digits are shifted to the top of a word so
+      // the missing ones read as leading zeros, then combined pairwise with three multiplies.
+      [[gnu::always_inline]] inline uint32_t version_digits(const char* p, std::size_t n) noexcept {
+         uint64_t x;
+         std::memcpy(&x, p, sizeof(x));
+         x = (x & 0x0F0F0F0F0F0F0F0Full) << (8 * (8 - n));
+         x = ((x * 2561) >> 8) & 0x00FF00FF00FF00FFull;
+         x = ((x * 6553601) >> 16) & 0x0000FFFF0000FFFFull;
+         return static_cast<uint32_t>((x * 42949672960001ull) >> 32);
+      }
+
+      /**
+       * @brief Parses one line from its character class masks instead of scanning it byte by byte.
+       *
+       * Whether a suffix, build metadata or git hash is present is folded in with conditional moves
+       * rather than branches, since in a real manifest those vary from line to line.
+       * @return false if the line is not a plain well formed version, it is then left to parse_version().
+       */
+      [[gnu::always_inline]] inline bool parse_version_masks(const char* p, std::size_t len, version_masks m, version_view& out) noexcept {
+         // Keeps every p[at + 1] below inside the 64 byte window.
+         if (len > 62)
+            return false;
+         const uint64_t in_line = (uint64_t{1} << len) - 1;
+         m.digit &= in_line;
+         m.dot   &= in_line;
+         m.alnum &= in_line;
+         m.ident &= in_line;
+
+         std::size_t at = (p[0] | 0x20) == 'v';
+         const std::size_t num_end = at + version_run(m.digit | m.dot, at);
+         uint64_t dots = m.dot & ((uint64_t{1} << num_end) - 1);
+
+         uint32_t parts[4] = {};
+         for (std::size_t i = 0; i < 4; ++i) {
+            const std::size_t next = dots ? static_cast<std::size_t>(std::countr_zero(dots)) : num_end;
+            const std::size_t n = next - at;
+            if (n == 0 || n > 5)
+               return false;
+            parts[i] = version_digits(p + at, n);
+            at = next + 1;
+            if (!dots)
+               break;
+            dots &= dots - 1;
+            if (i == 3)
+               return false;
+         }
+         bool bad = (parts[0] | parts[1] | parts[2] | parts[3]) > 0xFFFF;
+         at = num_end;
+
+         const bool has_suffix = p[at] == '-' && at < len;
+         const std::size_t suffix_len = has_suffix ? version_run(m.ident, at + 1) : 0;
+         const std::size_t suffix_at = at + 1;
+         bad |= has_suffix && suffix_len == 0;
+         at += has_suffix ? suffix_len + 1 : 0;
+
+         const bool has_build = p[at] == '+' && at < len;
+         const std::size_t build_len = has_build ? version_run(m.ident, at + 1) : 0;
+         bad |= has_build && build_len == 0;
+         at += has_build ? build_len + 1 : 0;
+
+         const bool has_hash = p[at] == ' ' && at < len;
+         const std::size_t hash_len = has_hash ? version_run(m.alnum, at + 2) : 0;
+         const std::size_t hash_at = at + 2;
+         bad |= has_hash && (p[at + 1] != '(' || hash_len == 0 || hash_at + hash_len + 1 != len || p[len - 1] != ')');
+         at = has_hash ? len : at;
+
+         if (bad || at != len)
+            return false;
+
+         out.major    = parts[0];
+         out.minor    = parts[1];
+         out.patch    = parts[2];
+         out.tweak    = parts[3];
+         out.suffix   = std::string_view(p + suffix_at, suffix_len);
+         out.git_hash = std::string_view(p + hash_at, hash_len);
+         return true;
+      }
+
+      [[gnu::always_inline]] inline version_masks version_masks_sse2(const char* p) noexcept {
+         version_masks m = {};
+         for (std::size_t i = 0; i < 64; i += 16) {
+            const __m128i c     = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+            const __m128i d     = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+            const __m128i a     = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+            const __m128i digit = _mm_cmpeq_epi8(_mm_min_epu8(d, _mm_set1_epi8(9)), d);
+            const __m128i dot   = _mm_cmpeq_epi8(c, _mm_set1_epi8('.'));
+            const __m128i alnum = _mm_or_si128(digit, _mm_cmpeq_epi8(_mm_min_epu8(a, _mm_set1_epi8(25)), a));
+            const __m128i ident = _mm_or_si128(_mm_or_si128(alnum, dot), _mm_or_si128(_mm_cmpeq_epi8(c, _mm_set1_epi8('-')),
+                                                                                       _mm_cmpeq_epi8(c, _mm_set1_epi8('_'))));
+            m.digit |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(digit))) << i;
+            m.dot   |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(dot))) << i;
+            m.alnum |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(alnum))) << i;
+            m.ident |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(ident))) << i;
+         }
+         return m;
+      }
+
+      VERSA_TARGET("avx2")
+      inline version_masks version_masks_avx2(const char* p) noexcept {
+         version_masks m = {};
+         for (std::size_t i = 0; i < 64; i += 32) {
+            const __m256i c     = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+            const __m256i d     = _mm256_sub_epi8(c, _mm256_set1_epi8('0'));
+            const __m256i a     = _mm256_sub_epi8(_mm256_or_si256(c, _mm256_set1_epi8(0x20)), _mm256_set1_epi8('a'));
+            const __m256i digit = _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+            const __m256i dot   = _mm256_cmpeq_epi8(c, _mm256_set1_epi8('.'));
+            const __m256i alnum = _mm256_or_si256(digit, _mm256_cmpeq_epi8(_mm256_min_epu8(a, _mm256_set1_epi8(25)), a));
+            const __m256i ident = _mm256_or_si256(_mm256_or_si256(alnum, dot), _mm256_or_si256(_mm256_cmpeq_epi8(c, _mm256_set1_epi8('-')),
+                                                                                                _mm256_cmpeq_epi8(c, _mm256_set1_epi8('_'))));
+            m.digit |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(digit))) << i;
+            m.dot   |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(dot))) << i;
+            m.alnum |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(alnum))) << i;
+            m.ident |= static_cast<uint64_t>(static_cast<uint32_t>(_mm256_movemask_epi8(ident))) << i;
+         }
+         return m;
+      }
+
+      inline bool parse_version_sse2(const char* p, std::size_t len, version_view& out) noexcept {
+         return parse_version_masks(p, len, version_masks_sse2(p), out);
+      }
+
+      VERSA_TARGET("avx2")
+      inline bool parse_version_avx2(const char* p, std::size_t len, version_view& out) noexcept {
+         return parse_version_masks(p, len, version_masks_avx2(p), out);
+      }
+
+      inline parse_versions_result parse_versions_sse2(std::string_view buffer, std::span<version_view> out) noexcept {
+         return parse_versions_impl<&newline_mask_sse2, &parse_version_sse2>(buffer, out);
+      }
+
+      VERSA_TARGET("avx2")
+      inline parse_versions_result parse_versions_avx2(std::string_view buffer, std::span<version_view> out) noexcept {
+         return parse_versions_impl<&newline_mask_avx2, &parse_version_avx2>(buffer, out);
+      }
+
+      using parse_versions_dispatch = util::dispatcher<
+         util::implementation<&parse_versions_avx2, cpu_features::avx2, architectures::x64 | architectures::x86>,
+         util::implementation<&parse_versions_sse2, cpu_features::sse2, architectures::x64 | architectures::x86>,
+         util::implementation<&parse_versions_portable>>;
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+      inline uint64_t newline_mask_neon(const char* p) noexcept {
+         // Narrowing shift packs each 16 byte compare into 4 bits per byte; keep one bit of each nibble.
+         const uint8x16_t nl = vdupq_n_u8('\n');
+         uint64_t mask = 0;
+         for (std::size_t i = 0; i < 64; i += 16) {
+            const uint8x16_t eq = vceqq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(p + i)), nl);
+            uint64_t nibbles = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+            nibbles &= 0x1111111111111111ull;
+            uint64_t bits = 0;
+            for (; nibbles; nibbles &= nibbles - 1)
+               bits |= uint64_t{1} << (std::countr_zero(nibbles) / 4);
+            mask |= bits << i;
+         }
+         return mask;
+      }
+
+      inline parse_versions_result parse_versions_neon(std::string_view buffer, std::span<version_view> out) noexcept {
+         return parse_versions_impl<&newline_mask_neon>(buffer, out);
+      }
+#endif
+   } // namespace detail
+
+   /**
+    * @brief A fixed size, trivially copyable version for large in-memory or mmapped collections.
+    *
+    * The git hash is held as up to 40 hex digits packed into 20 bytes and the suffix inline, so the
+    * whole version is 48 bytes, owns no heap memory, can be copied with memcpy or written to a file as
+    * is, and is a structural type usable as a template argument. The fields leave no padding and unused
+    * bytes are always zero, so equal versions have equal object representations.
+    */
+   struct packed_version : public version_t {
+      constexpr static inline std::size_t max_suffix_size     = 14;
+      constexpr static inline std::size_t max_git_hash_digits = 40;
+
+      std::byte git_hash_bytes[20];              /**< The git hash digits, two per byte, zero filled */
+      char suffix_chars[max_suffix_size];        /**< The suffix, zero filled */
+      uint8_t suffix_size;                       /**< Used characters of suffix_chars */
+      uint8_t git_hash_digits;                   /**< Hex digits in git_hash_bytes, 0 if there is no hash */
+      uint8_t reserved[4];                       /**< Always zero, fills what would be tail padding */
+
+      /**
+       * @brief Packs a version.
+       * @param v The version, its git hash has to be hex if present.
+       * @param out Receives the packed version; left unchanged on failure.
+       * @return std::errc{} on success, value_too_large if the suffix or hash does not fit, or
+       * invalid_argument if the hash is not hex.
+       */
+      constexpr static inline std::errc from(const version_view& v, packed_version& out) noexcept {
+         if (v.suffix.size() > max_suffix_size || v.git_hash.size() > max_git_hash_digits)
+            return std::errc::value_too_large;
+
+         packed_version result{};
+         result.major = v.major;
+         result.minor = v.minor;
+         result.patch = v.patch;
+         result.tweak = v.tweak;
+         for (std::size_t i = 0; i < v.suffix.size(); ++i)
+            result.suffix_chars[i] = v.suffix[i];
+         result.suffix_size = static_cast<uint8_t>(v.suffix.size());
+
+         // An odd number of digits is padded with a 0 nibble, git_hash_digits keeps the real length.
+         char digits[max_git_hash_digits] = {};
+         for (std::size_t i = 0; i < v.git_hash.size(); ++i)
+            digits[i] = v.git_hash[i];
+         if (v.git_hash.size() % 2)
+            digits[v.git_hash.size()] = '0';
+         if (!util::detail::hex_decode_scalar(result.git_hash_bytes, digits, (v.git_hash.size() + 1) / 2))
+            return std::errc::invalid_argument;
+         result.git_hash_digits = static_cast<uint8_t>(v.git_hash.size());
+
+         out = result;
+         return std::errc{};
+      }
+
+      /**
+       * @brief Packs a version_info, see from(const version_view&, packed_version&).
+       */
+      constexpr static inline std::errc from(const version_info& v, packed_version& out) noexcept {
+         return from(version_view{{v.major, v.minor, v.patch, v.tweak}, v.suffix, v.git_hash}, out);
+      }
+
+      /**
+       * @brief Parses text straight into a packed version, see parse_version() for the accepted formats.
+       */
+      constexpr static inline std::errc parse(std::string_view text, packed_version& out) noexcept {
+         version_view view{};
+         if (const auto ec = parse_version(text, view); ec != std::errc{})
+            return ec;
+         return from(view, out);
+      }
+
+      constexpr inline std::string_view suffix() const noexcept { return std::string_view(suffix_chars, suffix_size); }
+
+      constexpr inline bool has_git_hash() const noexcept { return git_hash_digits != 0; }
+
+      /**
+       * @brief Writes the git hash as hex.
+       * @param out Receives git_hash_digits characters.
+       * @return One past the last character written.
+       */
+      constexpr inline char* git_hash_to(char* out) const noexcept {
+         char digits[max_git_hash_digits];
+         util::detail::hex_encode_scalar(digits, git_hash_bytes, (git_hash_digits + 1) / 2);
+         for (std::size_t i = 0; i < git_hash_digits; ++i)
+            *out++ = digits[i];
+         return out;
+      }
+
+      constexpr inline std::size_t formatted_size() const noexcept {
+         return detail::formatted_version_size(*this, suffix(), {}) + (has_git_hash() ? git_hash_digits + 3 : 0);
+      }
+
+      /**
+       * @brief Writes the version in the version_info::to_string() format without allocating.
+       * @param out Receives formatted_size() characters, no terminator is added.
+       * @return One past the last character written.
+       */
+      constexpr inline char* format_to(char* out) const noexcept {
+         out = detail::format_version(out, *this, suffix(), {});
+         if (has_git_hash()) {
+            *out++ = ' ';
+            *out++ = '(';
+            out = git_hash_to(out);
+            *out++ = ')';
+         }
+         return out;
+      }
+
+      inline std::string to_string() const {
+         std::string result(formatted_size(), '\0');
+         format_to(result.data());
+         return result;
+      }
+
+      inline version_info to_version_info() const {
+         char digits[max_git_hash_digits];
+         git_hash_to(digits);
+         return version_info(major, minor, patch, tweak, suffix(), std::string_view(digits, git_hash_digits));
+      }
+
+      constexpr inline bool operator==(const packed_version& other) const noexcept {
+         if (major != other.major || minor != other.minor || patch != other.patch || tweak != other.tweak ||
+             suffix() != other.suffix() || git_hash_digits != other.git_hash_digits)
+            return false;
+         for (std::size_t i = 0; i < 20; ++i)
+            if (git_hash_bytes[i] != other.git_hash_bytes[i])
+               return false;
+         return true;
+      }
+
+      /**
+       * @brief Orders like version_info: key(), then prerelease precedence, then git hash.
+       */
+      constexpr inline std::strong_ordering operator<=>(const packed_version& other) const noexcept {
+         if (const auto cmp = detail::compare_versions(*this, suffix(), {}, other, other.suffix(), {}); cmp != 0)
+            return cmp;
+         for (std::size_t i = 0; i < 20; ++i)
+            if (git_hash_bytes[i] != other.git_hash_bytes[i])
+               return git_hash_bytes[i] <=> other.git_hash_bytes[i];
+         return git_hash_digits <=> other.git_hash_digits;
+      }
+   };
+
+   static_assert(sizeof(packed_version) == 48);
+   static_assert(std::has_unique_object_representations_v<packed_version>);
+   static_assert(std::is_trivially_copyable_v<packed_version>);
+
+   /**
+    * @brief Renders a constant version at compile time, e.g. the generated `version` object.
+    * @tparam Version A constexpr version with formatted_size() and format_to(), such as a version_view.
+    * @return The to_string() text of the version as a fixed_bytes sized to fit.
+    */
+   template <const auto& Version>
+   consteval inline auto render_version() {
+      constexpr std::size_t size = Version.formatted_size();
+      char text[size + 1] = {};
+      Version.format_to(text);
+      return util::fixed_bytes<size>(text);
+   }
+
+   /**
+    * @brief The rendered text of a constant version, kept in static storage so logging it is a pointer copy.
+    *
+    * ```
+    * constexpr versa::info::version_view v{{1, 2, 3, 4}, "rc1", ""};
+    * std::string_view text = versa::util::to_string_view(versa::info::version_string<v>);
+    * ```
+    */
+   template <const auto& Version>
+   constexpr inline auto version_string = render_version<Version>();
+
+   namespace detail {
+      struct keyed_index {
+         uint64_t key;
+         std::size_t index;
+      };
+
+      /**
+       * @brief LSD radix sort of (key, index) pairs on 8-bit digits.
+       *
+       * All eight histograms are built in one pass over the input and a digit on which every key
+       * agrees is skipped, so sets that only differ in the low fields take far fewer than eight passes.
+       * @return The buffer holding the sorted pairs, either `items` or `scratch`.
+       */
+      inline keyed_index* radix_sort_keys(keyed_index* items, keyed_index* scratch, std::size_t size) noexcept {
+         std::array<std::array<std::size_t, 256>, 8> counts = {};
+         for (std::size_t i = 0; i < size; ++i)
+            for (std::size_t d = 0; d < 8; ++d)
+               ++counts[d][(items[i].key >> (d * 8)) & 0xFF];
+
+         for (std::size_t d = 0; d < 8; ++d) {
+            auto& count = counts[d];
+            if (count[(items[0].key >> (d * 8)) & 0xFF] == size)
+               continue;
+            std::size_t offset = 0;
+            for (auto& c : count)
+               offset += std::exchange(c, offset);
+            for (std::size_t i = 0; i < size; ++i)
+               scratch[count[(items[i].key >> (d * 8)) & 0xFF]++] = items[i];
+            std::swap(items, scratch);
+         }
+         return items;
+      }
+
+      // Below this the histograms cost more than they save.
+      constexpr inline std::size_t radix_sort_threshold = 256;
+   } // namespace detail
+
+   /**
+    * @brief Sorts versions into ascending order, the same order as std::sort with operator<=>.
+    *
+    * The numeric parts are ordered by a radix sort on key() with the elements moved once at the end;
+    * only runs with an equal key, which differ in suffix or git hash, fall back to comparisons.
+    * @tparam Version version_info, version_view, packed_version or any other version_t with operator<=>.
+    * @param versions The versions to sort in place.
+    */
+   template <typename Version>
+   requires std::is_base_of_v<version_t, Version>
+   inline void sort_versions(std::span<Version> versions) {
+      const std::size_t size = versions.size();
+      if (size < detail::radix_sort_threshold) {
+         std::sort(versions.begin(), versions.end());
+         return;
+      }
+
+      std::vector<detail::keyed_index> items(size), scratch(size);
+      for (std::size_t i = 0; i < size; ++i)
+         items[i] = {versions[i].key(), i};
+      const detail::keyed_index* sorted = detail::radix_sort_keys(items.data(), scratch.data(), size);
+
+      std::vector<Version> result;
+      result.reserve(size);
+      for (std::size_t i = 0; i < size; ++i)
+         result.push_back(std::move(versions[sorted[i].index]));
+
+      for (std::size_t first = 0; first < size;) {
+         std::size_t last = first + 1;
+         while (last < size && sorted[last].key == sorted[first].key)
+            ++last;
+         if (last - first > 1)
+            std::sort(result.begin() + first, result.begin() + last);
+         first = last;
+      }
+      std::move(result.begin(), result.end(), versions.begin());
+   }
+
+   /**
+    * @brief Parses a newline separated list of versions, e.g. an mmapped manifest, into an array.
+    *
+    * Each non-empty line must hold exactly one version in a format parse_version() accepts; a trailing
+    * '\r' is ignored. Lines that fail to parse are counted and skipped. Nothing is allocated, the
+    * suffix and git hash views of the results point into `buffer`.
+    * @param buffer The text to parse.
+    * @param out Receives the versions. If it fills up, parsing stops and `consumed` tells where to resume.
+    * @return The number of versions parsed, lines rejected and bytes consumed.
+    */
+   inline parse_versions_result parse_versions(std::string_view buffer, std::span<version_view> out) noexcept {
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      return detail::parse_versions_dispatch{}(buffer, out);
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+      return detail::parse_versions_neon(buffer, out);
+#else
+      return detail::parse_versions_portable(buffer, out);
+#endif
+   }
+
+} // namespace versa::info
@@ -0,0 +1,166 @@
+#include <catch2/catch_all.hpp>
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <versa/atomic.hpp>
+
+using namespace versa::util;
+
+namespace {
+   template <std::size_t N>
+   fixed_bytes<N> filled(uint8_t value) {
+      fixed_bytes<N> bytes;
+      std::memset(bytes._data, value, N);
+      return bytes;
+   }
+
+   template <std::size_t N>
+   bool is_uniform(const fixed_bytes<N>& bytes) {
+      for (std::size_t i = 1; i < N; ++i)
+         if (bytes._data[i] != bytes._data[0])
+            return false;
+      return true;
+   }
+
+   // Readers must never see half of one store and half of another.
+   template <std::size_t N>
+   bool torn_reads_under_contention() {
+      atomic_fixed_bytes<N> shared(filled<N>(0));
+      std::atomic<bool> stop{false}, torn{false};
+      std::vector<std::thread> readers;
+      for (int t = 0; t < 3; ++t)
+         readers.emplace_back([&] {
+            while (!stop.load(std::memory_order_relaxed))
+               if (!is_uniform(shared.load()))
+                  torn.store(true);
+         });
+      for (int i = 0; i < 20000; ++i)
+         shared.store(filled<N>(static_cast<uint8_t>(i)));
+      stop.store(true);
+      for (auto& r : readers)
+         r.join();
+      return torn.load();
+   }
+
+   struct counted {
+      static inline std::atomic<int> live{0};
+      uint64_t a = 0, b = 0;
+      counted() { ++live; }
+      counted(uint64_t v) : a(v), b(~v) { ++live; }
+      counted(const counted& o) : a(o.a), b(o.b) { ++live; }
+      ~counted() { --live; }
+   };
+}
+
+TEST_CASE("Atomic Tests", "[atomic_tests]") {
+   SECTION("Check Lock Freedom") {
+      static_assert(atomic_fixed_bytes<8>::is_always_lock_free);
+      static_assert(atomic_fixed_bytes<16>::is_always_lock_free == (VERSA_HAS_CAS128 == 1));
+      static_assert(!atomic_fixed_bytes<32>::is_always_lock_free);
+      static_assert(alignof(atomic_fixed_bytes<16>) >= 8);
+   }
+
+   SECTION("Check Load Store Exchange") {
+      atomic_fixed_bytes<4> small;
+      CHECK(small.load() == filled<4>(0));
+      small = filled<4>(7);
+      CHECK(small.load() == filled<4>(7));
+      CHECK(small.exchange(filled<4>(9)) == filled<4>(7));
+      CHECK(static_cast<fixed_bytes<4>>(small) == filled<4>(9));
+
+      atomic_fixed_bytes<16> token(fixed_bytes<16>("0123456789abcdef"));
+      CHECK(token.load() == fixed_bytes<16>("0123456789abcdef"));
+      CHECK(token.exchange(filled<16>(1)) == fixed_bytes<16>("0123456789abcdef"));
+      CHECK(token.load() == filled<16>(1));
+
+      atomic_fixed_bytes<12> odd(filled<12>(3));
+      CHECK(odd.load() == filled<12>(3));
+
+      atomic_fixed_bytes<32> digest(filled<32>(5));
+      CHECK(digest.load() == filled<32>(5));
+      CHECK(digest.exchange(filled<32>(6)) == filled<32>(5));
+      CHECK(digest.load() == filled<32>(6));
+
+      atomic_fixed_bytes<20> uneven(filled<20>(4));
+      CHECK(uneven.load() == filled<20>(4));
+   }
+
+   SECTION("Check Compare Exchange") {
+      atomic_fixed_bytes<8> a(filled<8>(1));
+      auto expected = filled<8>(2);
+      CHECK_FALSE(a.compare_exchange(expected, filled<8>(3)));
+      CHECK(expected == filled<8>(1));
+      CHECK(a.compare_exchange(expected, filled<8>(3)));
+      CHECK(a.load() == filled<8>(3));
+
+      atomic_fixed_bytes<16> b(filled<16>(1));
+      auto expected16 = filled<16>(2);
+      CHECK_FALSE(b.compare_exchange(expected16, filled<16>(3)));
+      CHECK(expected16 == filled<16>(1));
+      CHECK(b.compare_exchange(expected16, filled<16>(3)));
+      CHECK(b.load() == filled<16>(3));
+
+      atomic_fixed_bytes<48> c(filled<48>(1));
+      auto expected48 = filled<48>(2);
+      CHECK_FALSE(c.compare_exchange(expected48, filled<48>(3)));
+      CHECK(expected48 == filled<48>(1));
+      CHECK(c.compare_exchange(expected48, filled<48>(3)));
+      CHECK(c.load() == filled<48>(3));
+   }
+
+   SECTION("Check No Torn Reads") {
+      CHECK_FALSE(torn_reads_under_contention<16>());
+      CHECK_FALSE(torn_reads_under_contention<64>());
+
+      // The 16 byte path without the AVX load, as on older processors.
+      versa::info::mask_cpu_features(~versa::info::cpu_features::avx2);
+      CHECK_FALSE(torn_reads_under_contention<16>());
+      versa::info::reset_cpu_features_mask();
+   }
+
+   SECTION("Check Snapshot") {
+      snapshot<versa::info::version_info> active(versa::info::version_info(1, 2, 3, 4, "rc1", ""));
+      {
+         auto v = active.read();
+         CHECK(v->major == 1);
+         CHECK(v->suffix == "rc1");
+      }
+      active.update([](versa::info::version_info& v) { v.minor = 5; });
+      CHECK(active.load().minor == 5);
+      CHECK(active.load().suffix == "rc1");
+      active.store(versa::info::version_info(2, 0, 0, 0, "", "abc"));
+      CHECK(active.read()->git_hash == "abc");
+   }
+
+   SECTION("Check Snapshot Reclamation") {
+      {
+         snapshot<counted> value(counted(1));
+         CHECK(counted::live == 1);
+         std::atomic<bool> stop{false}, inconsistent{false};
+         std::vector<std::thread> readers;
+         for (int t = 0; t < 3; ++t)
+            readers.emplace_back([&] {
+               while (!stop.load(std::memory_order_relaxed)) {
+                  auto g = value.read();
+                  if (g->b != ~g->a)
+                     inconsistent.store(true);
+               }
+            });
+         for (uint64_t i = 2; i < 2000; ++i)
+            value.store(counted(i));
+         stop.store(true);
+         for (auto& r : readers)
+            r.join();
+         CHECK_FALSE(inconsistent.load());
+         CHECK(value.read()->a == 1999);
+         // Every replaced value has been freed once its readers were done.
+         CHECK(counted::live == 1);
+      }
+      CHECK(counted::live == 0);
+   }
+}
@@ -0,0 +1,126 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <versa/build_note.hpp>
+
+using namespace versa::info;
+
+namespace {
+   std::vector<std::byte> read_file(const std::string& path) {
+      std::ifstream in(path, std::ios::binary);
+      std::vector<char> chars((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+      std::vector<std::byte> bytes(chars.size());
+      std::memcpy(bytes.data(), chars.data(), chars.size());
+      return bytes;
+   }
+
+   std::string self_path() {
+      return std::filesystem::read_symlink("/proc/self/exe").string();
+   }
+}
+
+TEST_CASE("Build Note Tests", "[build_note_tests]") {
+   SECTION("Check Note Layout") {
+      constexpr auto note = make_elf_build_note(1, 2, 3, 4, "rc.1", "0123456789abcdef0123456789abcdef01234567");
+      static_assert(note.name_size == 6);
+      static_assert(note.desc_size == 128);
+      static_assert(note.desc.magic == build_note_magic);
+      static_assert(note.desc.version().key() == version_t{1, 2, 3, 4}.key());
+      static_assert(note.desc.suffix() == "rc.1");
+      static_assert(note.desc.git_hash().size() == 40);
+      static_assert(note.desc.info().arch == build_architecture);
+      static_assert(note.desc.info().compiler == build_compiler);
+      CHECK(note.desc.to_version_info() == version_info(1, 2, 3, 4, "rc.1", "0123456789abcdef0123456789abcdef01234567"));
+
+      // Overlong strings are truncated and stay terminated.
+      constexpr auto truncated = make_elf_build_note(0, 0, 0, 0, std::string_view("0123456789012345678901234567890123456789"), "");
+      static_assert(truncated.desc.suffix().size() == 31);
+   }
+
+#if defined(__ELF__) && defined(__linux__)
+   SECTION("Check Own Note") {
+      // The test binary is built with versa_setup_target(... ELF_NOTE).
+      build_note note;
+      REQUIRE(read_build_note(self_path().c_str(), note) == std::errc{});
+      CHECK(note.to_version_info() == version_info(1, 0, 0, 0, "alpha"));
+      CHECK(note.info().arch == build_architecture);
+      CHECK(note.info().os == build_operating_system);
+      CHECK(note.info().endianess == build_endianess);
+      CHECK(note.info().compiler_version == VERSA_COMPILER_VERSION);
+
+      const auto image = read_file(self_path());
+      build_note from_memory;
+      REQUIRE(read_build_note(image, from_memory) == std::errc{});
+      CHECK(std::memcmp(&note, &from_memory, sizeof(note)) == 0);
+   }
+
+   SECTION("Check Foreign Byte Order") {
+      // A big-endian 32 bit image whose only content is a section with the note, as an object file has.
+      auto note = make_elf_build_note(7, 8, 9, 10, "beta", "abc");
+      std::vector<std::byte> image(52 + sizeof(note) + 2 * 40, std::byte{0});
+      auto put16 = [&](std::size_t at, uint16_t v) { versa::util::store_endian<uint16_t, std::endian::big>(image.data() + at, v); };
+      auto put32 = [&](std::size_t at, uint32_t v) { versa::util::store_endian<uint32_t, std::endian::big>(image.data() + at, v); };
+      std::memcpy(image.data(), "\x7f" "ELF\x01\x02\x01", 7);
+      const std::size_t note_at = 52, shoff = 52 + sizeof(note);
+      put32(32, static_cast<uint32_t>(shoff));
+      put16(46, 40);
+      put16(48, 2);
+      put32(shoff + 40 + 4, 7);
+      put32(shoff + 40 + 16, static_cast<uint32_t>(note_at));
+      put32(shoff + 40 + 20, static_cast<uint32_t>(sizeof(note)));
+      put32(shoff + 40 + 32, 4);
+
+      // The header and the descriptor words are in the target's order, the owner name is text.
+      uint32_t words[5 + 12];
+      std::memcpy(words, &note, sizeof(words));
+      if constexpr (std::endian::native == std::endian::little) {
+         versa::util::byteswap(std::span<uint32_t>(words, 3));
+         versa::util::byteswap(std::span<uint32_t>(words + 5, 12));
+      }
+      std::memcpy(static_cast<void*>(&note), words, sizeof(words));
+      std::memcpy(image.data() + note_at, &note, sizeof(note));
+
+      build_note out;
+      REQUIRE(read_build_note(image, out) == std::errc{});
+      CHECK(out.to_version_info() == version_info(7, 8, 9, 10, "beta", "abc"));
+      CHECK(out.info().arch == build_architecture);
+   }
+
+   SECTION("Check Errors") {
+      build_note note;
+      CHECK(read_build_note("/nonexistent/versa", note) == std::errc::no_such_file_or_directory);
+      CHECK(read_build_note("/", note) == std::errc::is_a_directory);
+
+      const auto path = (std::filesystem::temp_directory_path() / "versa_not_elf").string();
+      std::ofstream(path) << std::string(100, 'x');
+      CHECK(read_build_note(path.c_str(), note) == std::errc::executable_format_error);
+
+      // An ELF image with the note cut off is rejected rather than read past its end.
+      auto image = read_file(self_path());
+      image.resize(64);
+      CHECK(read_build_note(image, note) == std::errc::no_message);
+      std::filesystem::remove(path);
+   }
+
+   SECTION("Check Parallel Scan") {
+      std::vector<std::string> paths(100, self_path());
+      paths[10] = "/nonexistent/versa";
+      const auto results = scan_build_notes(paths, 4);
+      REQUIRE(results.size() == paths.size());
+      for (std::size_t i = 0; i < paths.size(); ++i) {
+         if (i == 10) {
+            CHECK(results[i].error == std::errc::no_such_file_or_directory);
+         } else {
+            CHECK(results[i].error == std::errc{});
+            CHECK(results[i].note.suffix() == "alpha");
+         }
+      }
+      CHECK(scan_build_notes(std::span<const std::string>{}).empty());
+   }
+#endif
+}
@@ -0,0 +1,26 @@
+#include <catch2/catch_all.hpp>
+
+// The policy is a template argument of the failure handler, so this translation unit may differ from check_tests.cpp.
+#define VERSA_CHECK_POLICY VERSA_CHECK_DISABLED
+#include <versa/check.hpp>
+
+namespace {
+   int evaluated = 0;
+
+   int count_evaluation() { return ++evaluated; }
+
+   // limit and name are only used by the check; they must not become unused variables.
+   void checked_with_message(int value) {
+      const int limit = 3;
+      const char* name = "value";
+      VERSA_CHECK(count_evaluation() > 0 && value < limit, "{} {} is over {}", name, value, limit);
+   }
+}
+
+TEST_CASE("Check Disabled Tests", "[check_disabled_tests]") {
+   SECTION("Check Nothing Is Evaluated") {
+      CHECK_NOTHROW(checked_with_message(10));
+      VERSA_CHECK(count_evaluation() < 0);
+      CHECK(evaluated == 0);
+   }
+}
@@ -0,0 +1,88 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#define VERSA_CHECK_COUNTERS 1
+#include <versa/check.hpp>
+#include <versa/constants.hpp>
+
+using namespace versa::util;
+
+namespace {
+   int checked_divide(int a, int b) {
+      VERSA_CHECK(b != 0, "cannot divide {} by {}", a, b);
+      return a / b;
+   }
+
+   void checked_without_message(bool ok) { VERSA_CHECK(ok); }
+
+   uint64_t failures_of(std::string_view expression) {
+      uint64_t failures = 0;
+      for_each_check_site([&](const check_site& site) {
+         if (site.expression == expression)
+            failures += site.failures();
+      });
+      return failures;
+   }
+}
+
+TEST_CASE("Check Tests", "[check_tests]") {
+   SECTION("Check Passing And Failing") {
+      CHECK(checked_divide(6, 3) == 2);
+      try {
+         checked_divide(6, 0);
+         FAIL("VERSA_CHECK did not throw");
+      } catch (const std::runtime_error& e) {
+         const std::string what = e.what();
+         CHECK(what.find("check_tests.cpp:") != std::string::npos);
+         CHECK(what.find("check `b != 0` failed: cannot divide 6 by 0") != std::string::npos);
+      }
+      CHECK_THROWS_AS(checked_without_message(false), std::runtime_error);
+      checked_without_message(true);
+   }
+
+   SECTION("Check Message Formatting") {
+      CHECK(detail::format_check_message("plain") == "plain");
+      CHECK(detail::format_check_message("{} + {} = {}", 1, 2u, 3.5) == "1 + 2 = 3.5");
+      CHECK(detail::format_check_message("{{{}}} {}", "x", std::string("y")) == "{x} y");
+      CHECK(detail::format_check_message("{} {}", true, 'c') == "true c");
+      CHECK(detail::format_check_message("{} and {}", 1) == "1 and {}");
+      CHECK(detail::format_check_message("only {}", 1, 2) == "only 1");
+      CHECK(detail::format_check_message("version {}", versa::info::version_info(1, 2, 3, 4)) == "version 1.2.3.4");
+   }
+
+   SECTION("Check Counters") {
+      const uint64_t before = failures_of("b != 0");
+      for (int i = 0; i < 3; ++i)
+         CHECK_THROWS(checked_divide(i, 0));
+      CHECK(failures_of("b != 0") == before + 3);
+      CHECK(check_counters_report().find(": b != 0: ") != std::string::npos);
+
+      // The log policy reports and carries on.
+      constinit static check_site site{"logged", std::source_location::current()};
+      detail::check_failed<VERSA_CHECK_LOG, true>(site, "logged failure {}", 1);
+      detail::check_failed<VERSA_CHECK_LOG, true>(site);
+      CHECK(site.failures() == 2);
+      CHECK(failures_of("logged") == 2);
+
+      // Without counters nothing is recorded.
+      constinit static check_site quiet{"quiet", std::source_location::current()};
+      CHECK_THROWS(detail::check_failed<VERSA_CHECK_THROW, false>(quiet));
+      CHECK(quiet.failures() == 0);
+   }
+
+   SECTION("Check Util Check") {
+      const std::string message = "a std::string message";
+      check(true, message);
+      try {
+         check(false, message);
+         FAIL("check did not throw");
+      } catch (const std::runtime_error& e) {
+         CHECK(std::string(e.what()) == message);
+      }
+      CHECK_THROWS_WITH(check(false, "literal", 3), "lit");
+   }
+}
@@ -0,0 +1,141 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <random>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <versa/constraints.hpp>
+#include <versa/cpu_features.hpp>
+#include <versa/versions.hpp>
+
+using namespace versa::info;
+
+namespace {
+   constexpr uint64_t key(uint16_t major, uint16_t minor = 0, uint16_t patch = 0, uint16_t tweak = 0) {
+      return version_t{major, minor, patch, tweak}.key();
+   }
+
+   bool accepts(std::string_view constraint, std::string_view version) {
+      version_view v{};
+      REQUIRE(parse_version(version, v) == std::errc{});
+      return make_constraint(constraint).matches(v);
+   }
+
+   // Compares one kernel against version_constraint::matches() on random keys, including partial words.
+   void check_kernel(detail::match_keys_fn kernel) {
+      std::mt19937_64 rng(5);
+      const auto c = make_constraint(">=1.2.0 <2.0.0 || ^3.1 || 5.x || 0.0.0 || >=65535.65535.65535.0");
+      for (std::size_t count : {0u, 1u, 63u, 64u, 65u, 1000u}) {
+         std::vector<uint64_t> keys(count);
+         for (auto& k : keys)
+            k = key(rng() % 7, rng() % 4, rng() % 3, rng() % 2) | (rng() % 50 == 0 ? ~uint64_t{0} : 0) * (rng() % 2);
+         std::vector<uint64_t> bits((count + 63) / 64, ~uint64_t{0});
+         kernel(c.intervals.data(), c.size, keys.data(), count, bits.data());
+         for (std::size_t i = 0; i < count; ++i)
+            REQUIRE(((bits[i / 64] >> (i % 64)) & 1) == c.matches(keys[i]));
+         if (count % 64)
+            REQUIRE(bits.back() >> (count % 64) == 0);
+      }
+   }
+}
+
+TEST_CASE("Version Constraint Tests", "[version_constraint_tests]") {
+   SECTION("Check Comparators") {
+      CHECK(accepts(">=1.2.0 <2.0.0", "1.2.0"));
+      CHECK(accepts(">=1.2.0 <2.0.0", "1.99.7"));
+      CHECK(!accepts(">=1.2.0 <2.0.0", "2.0.0"));
+      CHECK(!accepts(">=1.2.0 <2.0.0", "1.1.9"));
+      CHECK(accepts(">1.2", "1.3.0"));
+      CHECK(!accepts(">1.2", "1.2.9"));
+      CHECK(accepts("<=1.2", "1.2.9"));
+      CHECK(!accepts("<1.2", "1.2.0"));
+      CHECK(accepts("=1.2.3", "1.2.3"));
+      CHECK(accepts("1.2.3.4", "1.2.3.4"));
+      CHECK(!accepts("1.2.3.4", "1.2.3.5"));
+      CHECK(accepts(">= 1.0, < 1.1", "1.0.5"));
+   }
+
+   SECTION("Check Caret Tilde And Wildcards") {
+      CHECK(make_constraint("^1.2.3") == make_constraint(">=1.2.3 <2.0.0"));
+      CHECK(make_constraint("^0.2.3") == make_constraint(">=0.2.3 <0.3.0"));
+      CHECK(make_constraint("^0.0.3") == make_constraint(">=0.0.3 <0.0.4"));
+      CHECK(make_constraint("^0.0") == make_constraint(">=0.0.0 <0.1.0"));
+      CHECK(make_constraint("~1.2.3") == make_constraint(">=1.2.3 <1.3.0"));
+      CHECK(make_constraint("~1") == make_constraint(">=1.0.0 <2.0.0"));
+      CHECK(make_constraint("1.x") == make_constraint(">=1.0.0 <2.0.0"));
+      CHECK(make_constraint("1.2.*") == make_constraint(">=1.2.0 <1.3.0"));
+      CHECK(make_constraint("1.2.3 - 2.3") == make_constraint(">=1.2.3 <2.4.0"));
+      CHECK(make_constraint("*").ranges().size() == 1);
+      CHECK(make_constraint("*").matches(key(65535, 65535, 65535, 65535)));
+      CHECK(make_constraint("").matches(key(0)));
+      CHECK(accepts("^1.2.3-beta.1", "1.9.0"));
+      CHECK(!accepts("^65535", "0.1.0"));
+      CHECK(accepts("^65535", "65535.65535.65535.65535"));
+   }
+
+   SECTION("Check Normalization") {
+      // Overlapping and touching alternatives merge, unsatisfiable ones vanish, order does not matter.
+      const auto c = make_constraint("3.x || >=1.2.0 <2.0.0 || 2.x || >5 <4 || <0.0.0");
+      REQUIRE(c.ranges().size() == 1);
+      CHECK(c.intervals[0] == version_interval{key(1, 2), key(3, 65535, 65535, 65535)});
+      CHECK(make_constraint("1.0.0 || 3.0.0").ranges().size() == 2);
+      CHECK(make_constraint("1.0.0 || 3.0.0") == make_constraint("3.0.0 || 1.0.0"));
+      CHECK(make_constraint(">5 <4").ranges().empty());
+   }
+
+   SECTION("Check Rejected Input") {
+      version_constraint c;
+      CHECK(parse_constraint(">=1.2.x.3", c) == std::errc::invalid_argument);
+      CHECK(parse_constraint("1.2.3 | 2.0", c) == std::errc::invalid_argument);
+      CHECK(parse_constraint(">=", c) == std::errc::invalid_argument);
+      CHECK(parse_constraint("1.2.3.4.5", c) == std::errc::invalid_argument);
+      CHECK(parse_constraint("1.2.65536", c) == std::errc::result_out_of_range);
+      CHECK(parse_constraint("1 || 3 || 5 || 7 || 9 || 11 || 13 || 15 || 17 || 19 || 21 || 23 || 25 || 27 || 29 || 31 || 33", c) ==
+            std::errc::value_too_large);
+      CHECK_THROWS_AS(make_constraint("abc"), std::runtime_error);
+   }
+
+   SECTION("Check Compile Time Constraints") {
+      constexpr auto c = compile_constraint(">=1.2.0 <2.0.0 || ^3.1");
+      static_assert(c.size == 2);
+      static_assert(c.matches(key(1, 5)) && c.matches(key(3, 4, 1)));
+      static_assert(!c.matches(key(2, 0)) && !c.matches(key(3, 0, 9)));
+      static_assert(c == compile_constraint("^3.1 || >=1.2 <2"));
+   }
+
+   SECTION("Check Batch Matching") {
+      check_kernel(&detail::match_keys_portable);
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      if (has_cpu_features(cpu_features::avx2))
+         check_kernel(&detail::match_keys_avx2);
+      if (has_cpu_features(cpu_features::avx512f))
+         check_kernel(&detail::match_keys_avx512);
+#endif
+
+      std::mt19937 rng(11);
+      std::vector<version_info> infos;
+      std::vector<packed_version> packed(1500);
+      for (auto& p : packed) {
+         packed_version::from(version_view{{rng() % 5, rng() % 5, rng() % 5, 0}, "", ""}, p);
+         infos.push_back(p.to_version_info());
+      }
+      const auto c = make_constraint(">=1.2.0 <2.0.0 || ^3.1");
+      std::vector<uint64_t> bits((infos.size() + 63) / 64), packed_bits(bits.size());
+      const std::size_t matched = match(c, std::span<const version_info>(infos), std::span<uint64_t>(bits));
+      CHECK(match(c, std::span<const packed_version>(packed), std::span<uint64_t>(packed_bits)) == matched);
+      CHECK(bits == packed_bits);
+      std::size_t expected = 0;
+      for (std::size_t i = 0; i < infos.size(); ++i) {
+         REQUIRE(((bits[i / 64] >> (i % 64)) & 1) == c.matches(infos[i]));
+         expected += c.matches(infos[i]);
+      }
+      CHECK(matched == expected);
+      CHECK(matched > 0);
+
+      std::vector<uint64_t> too_small(1);
+      CHECK_THROWS_AS(match(c, std::span<const version_info>(infos), std::span<uint64_t>(too_small)), std::runtime_error);
+   }
+}
@@ -0,0 +1,65 @@
+#include <catch2/catch_all.hpp>
+
+#include <versa/constants.hpp>
+#include <versa/cpu_features.hpp>
+
+using namespace versa::info;
+
+TEST_CASE("CPU Features Tests", "[cpu_features_tests]") {
+   SECTION("Check Feature Set Operators") {
+      constexpr auto set = cpu_features::sse2 | cpu_features::avx2;
+      CHECK(has_features(set, cpu_features::sse2));
+      CHECK(has_features(set, cpu_features::avx2));
+      CHECK(has_features(set, cpu_features::sse2 | cpu_features::avx2));
+      CHECK(!has_features(set, cpu_features::avx2 | cpu_features::bmi2));
+      CHECK(has_features(set, cpu_features::none));
+      CHECK((set & ~cpu_features::avx2) == cpu_features::sse2);
+   }
+
+   SECTION("Check Detection Is Stable") {
+      const auto features = host_cpu_features();
+      CHECK(host_cpu_features() == features);
+      CHECK(has_cpu_features(cpu_features::none));
+   }
+
+   SECTION("Check Detection Matches Architecture") {
+      const auto features = host_cpu_features();
+#if VERSA_X64_BUILD
+      CHECK(has_features(features, cpu_features::sse2));
+      CHECK(!has_features(features, cpu_features::neon));
+      CHECK(!has_features(features, cpu_features::sve));
+#elif VERSA_ARM64_BUILD
+      CHECK(has_features(features, cpu_features::neon));
+      CHECK(!has_features(features, cpu_features::sse2));
+#endif
+#if defined(__AVX2__)
+      CHECK(has_features(features, cpu_features::avx2));
+#endif
+#if defined(__SSE4_2__)
+      CHECK(has_features(features, cpu_features::sse42));
+#endif
+      // AVX-512 implies AVX2 on every shipping part, and both need the OS to enable the vector state.
+      if (has_features(features, cpu_features::avx512f))
+         CHECK(has_features(features, cpu_features::avx2));
+   }
+
+   SECTION("Check Masking Features") {
+      const auto features = host_cpu_features();
+
+      mask_cpu_features(cpu_features::none);
+      CHECK(host_cpu_features() == cpu_features::none);
+      CHECK(!has_cpu_features(cpu_features::sse2));
+      CHECK(!has_cpu_features(cpu_features::neon));
+
+      mask_cpu_features(~cpu_features::avx2);
+      CHECK(!has_cpu_features(cpu_features::avx2));
+      CHECK(host_cpu_features() == (features & ~cpu_features::avx2));
+
+      // Masks can only hide features, never report ones the CPU lacks.
+      mask_cpu_features(features | cpu_features::sve | cpu_features::avx512vl);
+      CHECK(host_cpu_features() == features);
+
+      reset_cpu_features_mask();
+      CHECK(host_cpu_features() == features);
+   }
+}
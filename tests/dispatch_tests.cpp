@@ -0,0 +1,85 @@
+#include <catch2/catch_all.hpp>
+
+#include <versa/constants.hpp>
+#include <versa/cpu_features.hpp>
+#include <versa/dispatch.hpp>
+
+using namespace versa::info;
+using namespace versa::util;
+
+namespace {
+   int kernel_scalar(int v) { return v + 1; }
+   int kernel_avx2(int v) { return v + 2; }
+   int kernel_avx512(int v) { return v + 3; }
+   int kernel_neon(int v) { return v + 4; }
+   int kernel_foreign(int v) { return v + 5; }
+
+   // Claims no features but is built for an architecture we are not running on.
+   constexpr auto foreign_arch = build_architecture == architectures::s390x ? architectures::wasm32 : architectures::s390x;
+
+   using kernel_dispatch = dispatcher<
+      implementation<&kernel_foreign, cpu_features::none, foreign_arch>,
+      implementation<&kernel_avx512, cpu_features::avx512f | cpu_features::avx512bw, architectures::x64 | architectures::x86>,
+      implementation<&kernel_avx2, cpu_features::avx2, architectures::x64 | architectures::x86>,
+      implementation<&kernel_neon, cpu_features::neon, architectures::arm64>,
+      implementation<&kernel_scalar>>;
+
+   int expected_for(cpu_features host) {
+      if constexpr (build_architecture == architectures::x64 || build_architecture == architectures::x86) {
+         if (has_features(host, cpu_features::avx512f | cpu_features::avx512bw)) return 3;
+         if (has_features(host, cpu_features::avx2)) return 2;
+      } else if constexpr (build_architecture == architectures::arm64) {
+         if (has_features(host, cpu_features::neon)) return 4;
+      }
+      return 1;
+   }
+
+   int noexcept_scalar(int v) noexcept { return v * 2; }
+   constexpr dispatcher<implementation<&noexcept_scalar>> noexcept_dispatch;
+}
+
+#if VERSA_HAS_IFUNC
+VERSA_DEFINE_IFUNC(int, versa_test_ifunc_kernel, (int), kernel_dispatch)
+#endif
+
+TEST_CASE("Dispatch Tests", "[dispatch_tests]") {
+   constexpr kernel_dispatch kernel;
+
+   SECTION("Check Selection By Features") {
+      CHECK(kernel_dispatch::select(cpu_features::none) == &kernel_scalar);
+      CHECK(kernel_dispatch::select(host_cpu_features())(0) == expected_for(host_cpu_features()));
+      if constexpr (build_architecture == architectures::x64) {
+         CHECK(kernel_dispatch::select(cpu_features::avx2) == &kernel_avx2);
+         CHECK(kernel_dispatch::select(cpu_features::avx2 | cpu_features::avx512f) == &kernel_avx2);
+         CHECK(kernel_dispatch::select(cpu_features::avx2 | cpu_features::avx512f | cpu_features::avx512bw) == &kernel_avx512);
+         CHECK(kernel_dispatch::select(cpu_features::neon) == &kernel_scalar);
+      }
+   }
+
+   SECTION("Check Calls Are Routed To The Resolved Implementation") {
+      kernel_dispatch::reset();
+      CHECK(kernel(10) == 10 + expected_for(host_cpu_features()));
+      CHECK(kernel_dispatch::get() == kernel_dispatch::select(host_cpu_features()));
+      CHECK(kernel(20) == 20 + expected_for(host_cpu_features()));
+      CHECK(noexcept_dispatch(21) == 42);
+   }
+
+   SECTION("Check Masked Features Force The Portable Path") {
+      mask_cpu_features(cpu_features::none);
+      kernel_dispatch::reset();
+      CHECK(kernel(10) == 11);
+      CHECK(kernel_dispatch::get() == &kernel_scalar);
+
+      // The cached selection survives until reset.
+      reset_cpu_features_mask();
+      CHECK(kernel(10) == 11);
+      kernel_dispatch::reset();
+      CHECK(kernel(10) == 10 + expected_for(host_cpu_features()));
+   }
+
+#if VERSA_HAS_IFUNC
+   SECTION("Check GNU Indirect Function") {
+      CHECK(versa_test_ifunc_kernel(100) == 100 + expected_for(host_cpu_features()));
+   }
+#endif
+}
@@ -0,0 +1,95 @@
+#include <catch2/catch_all.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+#include <versa/endian.hpp>
+
+using namespace versa::util;
+
+namespace {
+   template <typename T>
+   std::vector<T> sequence(std::size_t n) {
+      std::vector<T> values(n);
+      for (std::size_t i = 0; i < n; ++i)
+         values[i] = static_cast<T>(0x0102030405060708ull * (i + 1));
+      return values;
+   }
+
+   template <typename T>
+   void check_bulk_byteswap(std::size_t n) {
+      auto values = sequence<T>(n);
+      auto expected = values;
+      for (auto& v : expected)
+         v = byteswap(v);
+      byteswap(std::span<T>(values));
+      CHECK(values == expected);
+
+      auto portable = sequence<T>(n);
+      detail::byteswap_portable<sizeof(T)>(reinterpret_cast<std::byte*>(portable.data()), portable.size());
+      CHECK(portable == expected);
+   }
+}
+
+TEST_CASE("Endian Tests", "[endian_tests]") {
+   SECTION("Check Byteswap") {
+      static_assert(byteswap(uint16_t{0x0102}) == 0x0201);
+      static_assert(byteswap(uint32_t{0x01020304}) == 0x04030201);
+      static_assert(byteswap(uint64_t{0x0102030405060708}) == 0x0807060504030201);
+      static_assert(byteswap(int32_t{-2}) == static_cast<int32_t>(0xFEFFFFFF));
+      static_assert(byteswap(uint8_t{0xAB}) == 0xAB);
+      volatile uint32_t runtime = 0x01020304;
+      CHECK(byteswap(static_cast<uint32_t>(runtime)) == 0x04030201u);
+      CHECK(versa::info::build_endianess == (std::endian::native == std::endian::little ? versa::info::endianesses::little : versa::info::endianesses::big));
+   }
+
+   SECTION("Check Views Over Raw Bytes") {
+      std::vector<std::byte> buffer = {std::byte{0x00}, std::byte{0x12}, std::byte{0x34}, std::byte{0x56},
+                                       std::byte{0x78}, std::byte{0x9A}, std::byte{0xBC}, std::byte{0xDE}, std::byte{0xF0}};
+      const be<const uint32_t> big(buffer, 1);
+      const le<const uint32_t> little(buffer, 1);
+      CHECK(big == 0x12345678u);
+      CHECK(little == 0x78563412u);
+      CHECK(be<const uint16_t>(buffer, 7).load() == 0xDEF0);
+      CHECK(be<const uint64_t>(buffer, 1) == 0x123456789ABCDEF0ull);
+
+      // Writes land in the buffer in the view's byte order.
+      const be<uint16_t> field(buffer, 0);
+      field = 0xCAFE;
+      CHECK(buffer[0] == std::byte{0xCA});
+      CHECK(buffer[1] == std::byte{0xFE});
+      le<int32_t>(buffer, 2).store(-2);
+      CHECK(buffer[2] == std::byte{0xFE});
+      CHECK(buffer[5] == std::byte{0xFF});
+      CHECK(le<const int32_t>(buffer, 2) == -2);
+
+      CHECK_THROWS(be<const uint32_t>(buffer, 6));
+      CHECK_THROWS(be<const uint32_t>(buffer, 100));
+   }
+
+   SECTION("Check Views Over Fixed Bytes") {
+      fixed_bytes<8> record = std::array<uint8_t, 8>{0, 0, 0, 42, 1, 0, 0, 0};
+      CHECK(be<const uint32_t>::at<0>(record) == 42u);
+      CHECK(le<const uint32_t>::at<4>(record) == 1u);
+      be<uint32_t>::at<4>(record) = 7;
+      CHECK(record[7] == 7);
+      CHECK(le<const uint32_t>::at<4>(record) == 0x07000000u);
+      const fixed_bytes<8>& view = record;
+      CHECK(be<const uint16_t>::at<6>(view) == 7);
+   }
+
+   SECTION("Check Bulk Byteswap") {
+      for (std::size_t n : {0, 1, 3, 7, 8, 15, 16, 17, 33, 100, 1000}) {
+         check_bulk_byteswap<uint16_t>(n);
+         check_bulk_byteswap<uint32_t>(n);
+         check_bulk_byteswap<uint64_t>(n);
+      }
+      auto values = sequence<uint32_t>(10);
+      const auto original = values;
+      convert_endian<std::endian::native>(std::span<uint32_t>(values));
+      CHECK(values == original);
+      convert_endian<std::endian::native == std::endian::little ? std::endian::big : std::endian::little>(std::span<uint32_t>(values));
+      CHECK(values[0] == byteswap(original[0]));
+   }
+}
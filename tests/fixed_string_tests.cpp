@@ -2,13 +2,68 @@
 #include <catch2/catch_all.hpp>
 #include <iostream>
 #include <fstream>
+#include <cstring>
+#include <random>
+#include <vector>
 
 #include <versa/constants.hpp>
+#include <versa/cpu_features.hpp>
 #include <versa/utils.hpp>
 #include <versa/fixed_string.hpp>
 
 using namespace versa::util;
 
+namespace {
+   template <fixed_string S>
+   constexpr std::size_t template_argument_size() { return S.size(); }
+
+   template <std::size_t N>
+   std::vector<fixed_bytes<N>> random_keys(std::size_t count, uint32_t seed) {
+      std::mt19937 rng(seed);
+      std::vector<fixed_bytes<N>> keys(count);
+      for (auto& k : keys)
+         for (auto& c : k)
+            c = static_cast<char>(rng());
+      return keys;
+   }
+
+   template <std::size_t N>
+   void check_comparisons() {
+      auto keys = random_keys<N>(64, N);
+      // Force keys that only differ late, and in bytes above 0x7f, to catch sign and word order bugs.
+      keys[1] = keys[0];
+      keys[1][N - 1] = static_cast<char>(static_cast<unsigned char>(keys[0][N - 1]) ^ 0x80);
+      keys[2] = keys[0];
+      for (const auto& a : keys) {
+         for (const auto& b : keys) {
+            const int expected = std::memcmp(a.data(), b.data(), N);
+            CHECK((a == b) == (expected == 0));
+            CHECK((a <=> b) == (expected <=> 0));
+         }
+      }
+   }
+
+   template <std::size_t N>
+   void check_find(std::size_t (*fn)(const fixed_bytes<N>*, std::size_t, const fixed_bytes<N>&) noexcept) {
+      const auto keys = random_keys<N>(67, 7);
+      for (std::size_t i = 0; i < keys.size(); ++i)
+         CHECK(fn(keys.data(), keys.size(), keys[i]) == i);
+      const auto missing = random_keys<N>(1, 99)[0];
+      CHECK(fn(keys.data(), keys.size(), missing) == keys.size());
+      CHECK(fn(keys.data(), 0, keys[0]) == 0);
+
+      // Digests that share a long prefix pass any prefix filter and need the full comparison.
+      auto shared = random_keys<N>(67, 7);
+      for (auto& k : shared)
+         std::memset(k.data(), 'x', N - 4);
+      for (std::size_t i = 0; i < shared.size(); ++i)
+         CHECK(fn(shared.data(), shared.size(), shared[i]) == i);
+      auto near_miss = shared[0];
+      near_miss.data()[N - 1] = 'z';
+      CHECK(fn(shared.data(), shared.size(), near_miss) == shared.size());
+   }
+}
+
 TEST_CASE("Fixed_String Tests", "[fixed_string_tests]") {
    SECTION("Check Constructors") {
       CHECK(fixed_bytes<5>().size() == 5);
@@ -17,13 +72,73 @@ TEST_CASE("Fixed_String Tests", "[fixed_string_tests]") {
       CHECK(fixed_bytes<4>(std::string("test")).size() == 4);
       CHECK(fixed_bytes<4>(std::string_view("test")).size() == 4);
       CHECK(fixed_bytes{"test"}.size() == 4);
+      CHECK(to_string_view(fixed_bytes{"test"}) == "test");
    }
 
    SECTION("Check Constructors with Incorrect Sizes") {
-      //auto fs = fixed_string<3>("test");
-      //CHECK(fixed_string<5>(std::array<char, 4>{'t', 'e', 's', 't'}).size() == 4);
-      //CHECK(fixed_string<5>(std::string("test")).size() == 4);
-      //CHECK(fixed_string<5>(std::string_view("test")).size() == 4);
+      CHECK_THROWS_AS(fixed_bytes<5>(std::string("test")), std::runtime_error);
+      CHECK_THROWS_AS(fixed_bytes<3>(std::string_view("test")), std::runtime_error);
+   }
+
+   SECTION("Check Equality and Ordering") {
+      CHECK(fixed_bytes{"abcd"} == fixed_bytes{"abcd"});
+      CHECK(fixed_bytes{"abcd"} != fixed_bytes{"abce"});
+      CHECK(fixed_bytes{"abcd"} < fixed_bytes{"abce"});
+      CHECK(fixed_bytes{"b"} > fixed_bytes{"a"});
+      check_comparisons<3>();
+      check_comparisons<8>();
+      check_comparisons<16>();
+      check_comparisons<20>();
+      check_comparisons<32>();
+      check_comparisons<40>();
+      check_comparisons<64>();
+      check_comparisons<100>();
    }
 
-}
\ No newline at end of file
+   SECTION("Check Find") {
+      check_find<8>(&detail::find_portable<8, std::byte>);
+      check_find<20>(&detail::find_portable<20, std::byte>);
+      check_find<32>(&detail::find_portable<32, std::byte>);
+      check_find<64>(&detail::find_portable<64, std::byte>);
+#if VERSA_X64_BUILD
+      check_find<8>(&detail::find_sse2<8, std::byte>);
+      check_find<16>(&detail::find_sse2<16, std::byte>);
+      check_find<20>(&detail::find_sse2<20, std::byte>);
+      check_find<32>(&detail::find_sse2<32, std::byte>);
+      check_find<64>(&detail::find_sse2<64, std::byte>);
+      if (versa::info::has_cpu_features(versa::info::cpu_features::avx2)) {
+         check_find<8>(&detail::find_avx2<8, std::byte>);
+         check_find<16>(&detail::find_avx2<16, std::byte>);
+         check_find<32>(&detail::find_avx2<32, std::byte>);
+         check_find<64>(&detail::find_avx2<64, std::byte>);
+      }
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+      check_find<8>(&detail::find_neon<8, std::byte>);
+      check_find<16>(&detail::find_neon<16, std::byte>);
+      check_find<20>(&detail::find_neon<20, std::byte>);
+      check_find<32>(&detail::find_neon<32, std::byte>);
+#endif
+      const auto keys = random_keys<32>(10, 3);
+      const std::span<const fixed_bytes<32>> view(keys);
+      CHECK(find(view, keys[6]) == view.begin() + 6);
+      CHECK(find(view, random_keys<32>(1, 4)[0]) == view.end());
+      const auto digests = random_keys<20>(10, 3);
+      const std::span<const fixed_bytes<20>> digest_view(digests);
+      CHECK(find(digest_view, digests[9]) == digest_view.begin() + 9);
+   }
+
+   SECTION("Check Constant Evaluation") {
+      constexpr fixed_string s = "hello";
+      static_assert(s.size() == 5);
+      static_assert(s[1] == 'e');
+      static_assert(std::string_view(s) == "hello");
+      static_assert(s == fixed_string("hello"));
+      static_assert(s < fixed_string("help!"));
+      static_assert(fixed_bytes("abc") == fixed_bytes("abc"));
+      static_assert(fixed_bytes("abc") > fixed_bytes("abb"));
+      static_assert(template_argument_size<"command">() == 7);
+      static_assert(template_argument_size<s>() == 5);
+      CHECK(to_string_view(s) == "hello");
+      CHECK(fixed_bytes<5>(std::string_view("hello")) == fixed_bytes<5>(std::string_view(s)));
+   }
+}
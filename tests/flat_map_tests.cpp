@@ -0,0 +1,186 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <versa/fixed_string.hpp>
+#include <versa/flat_map.hpp>
+#include <versa/hash.hpp>
+
+using namespace versa::util;
+
+namespace {
+   template <typename K>
+   K make_key(uint32_t i) {
+      if constexpr (std::is_integral_v<K>) {
+         return static_cast<K>(i);
+      } else {
+         K key{};
+         std::memcpy(key.data(), &i, sizeof(i));
+         return key;
+      }
+   }
+
+   // Throws from its constructor when asked to, and counts the live instances.
+   struct fragile {
+      static inline int live = 0;
+      int value;
+      fragile(int v) : value(v) {
+         if (v < 0)
+            throw std::runtime_error("fragile");
+         ++live;
+      }
+      fragile(const fragile& o) : value(o.value) { ++live; }
+      fragile(fragile&& o) noexcept : value(o.value) { ++live; }
+      ~fragile() { --live; }
+   };
+
+   // Runs a random mix of operations against std::unordered_map and checks they agree.
+   template <typename K>
+   void check_against_unordered_map() {
+      std::mt19937 rng(1234);
+      flat_map<K, std::string> map;
+      std::unordered_map<K, std::string> expected;
+
+      for (std::size_t step = 0; step < 20000; ++step) {
+         const K key = make_key<K>(rng() % 2048);
+         const std::string value = std::to_string(step);
+         switch (rng() % 5) {
+            case 0:
+               CHECK(map.try_emplace(key, value).second == expected.try_emplace(key, value).second);
+               break;
+            case 1:
+               map.insert_or_assign(key, value);
+               expected.insert_or_assign(key, value);
+               break;
+            case 2:
+               CHECK(map.erase(key) == expected.erase(key));
+               break;
+            case 3:
+               map[key] += "x";
+               expected[key] += "x";
+               break;
+            default: {
+               const auto it = map.find(key);
+               const auto e  = expected.find(key);
+               REQUIRE((it == map.end()) == (e == expected.end()));
+               if (e != expected.end())
+                  CHECK(it->second == e->second);
+            }
+         }
+         REQUIRE(map.size() == expected.size());
+      }
+
+      std::size_t visited = 0;
+      for (const auto& [k, v] : map) {
+         REQUIRE(expected.count(k) == 1);
+         CHECK(expected.at(k) == v);
+         ++visited;
+      }
+      CHECK(visited == expected.size());
+   }
+}
+
+TEST_CASE("Flat Map Tests", "[flat_map_tests]") {
+   SECTION("Check Basic Operations") {
+      flat_map<int, int> map;
+      CHECK(map.empty());
+      CHECK(map.find(1) == map.end());
+      CHECK(!map.contains(1));
+      CHECK_THROWS(map.at(1));
+
+      CHECK(map.emplace(1, 10).second);
+      CHECK(!map.emplace(1, 20).second);
+      CHECK(map.at(1) == 10);
+      map[2] = 20;
+      CHECK(map.size() == 2);
+      CHECK(map.contains(2));
+      CHECK(map.erase(1) == 1);
+      CHECK(map.erase(1) == 0);
+      CHECK(!map.contains(1));
+      CHECK(map.size() == 1);
+
+      map.clear();
+      CHECK(map.empty());
+      CHECK(map.begin() == map.end());
+   }
+
+   SECTION("Check Growth And Reserve") {
+      flat_map<int, int> map;
+      map.reserve(1000);
+      const auto capacity = map.capacity();
+      CHECK(capacity >= 1000);
+      for (int i = 0; i < 1000; ++i)
+         map[i] = i * 2;
+      CHECK(map.capacity() == capacity);
+      for (int i = 1000; i < 10000; ++i)
+         map[i] = i * 2;
+      CHECK(map.size() == 10000);
+      for (int i = 0; i < 10000; ++i)
+         REQUIRE(map.at(i) == i * 2);
+
+      // Erasing and reinserting reuses tombstones instead of growing forever.
+      const auto grown = map.capacity();
+      for (int round = 0; round < 10; ++round) {
+         for (int i = 0; i < 5000; ++i)
+            map.erase(i);
+         for (int i = 0; i < 5000; ++i)
+            map[i] = i;
+      }
+      CHECK(map.capacity() == grown);
+   }
+
+   SECTION("Check Copy And Move") {
+      flat_map<std::string, std::string> map = {{"a", "1"}, {"b", "2"}, {"c", "3"}};
+      auto copy = map;
+      CHECK(copy.size() == 3);
+      CHECK(copy.at("b") == "2");
+      copy["b"] = "x";
+      CHECK(map.at("b") == "2");
+
+      auto moved = std::move(copy);
+      CHECK(moved.at("b") == "x");
+      CHECK(copy.empty());
+
+      copy = moved;
+      CHECK(copy.at("c") == "3");
+      map = std::move(moved);
+      CHECK(map.at("b") == "x");
+   }
+
+   SECTION("Check Against Unordered Map") {
+      check_against_unordered_map<uint32_t>();
+      check_against_unordered_map<fixed_bytes<20>>();
+   }
+
+   SECTION("Check Throwing Values") {
+      {
+         flat_map<uint32_t, fragile> map;
+         for (int i = 0; i < 100; ++i)
+            map.try_emplace(i, i);
+         for (int i = 100; i < 110; ++i)
+            CHECK_THROWS(map.try_emplace(i, -1));
+         // A failed insert leaves no half built entry behind.
+         CHECK(map.size() == 100);
+         CHECK(fragile::live == 100);
+         CHECK_FALSE(map.contains(105));
+         map.try_emplace(105, 5);
+         CHECK(map.at(105).value == 5);
+      }
+      CHECK(fragile::live == 0);
+   }
+
+   SECTION("Check Identity Hash") {
+      // std::hash<uint64_t> is the identity, keys that only differ in high bits must still spread out.
+      flat_map<uint64_t, int> map;
+      for (uint64_t i = 0; i < 4096; ++i)
+         map[i << 40] = static_cast<int>(i);
+      for (uint64_t i = 0; i < 4096; ++i)
+         REQUIRE(map.at(i << 40) == static_cast<int>(i));
+   }
+}
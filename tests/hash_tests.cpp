@@ -0,0 +1,101 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <set>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
+
+#include <versa/fixed_string.hpp>
+#include <versa/hash.hpp>
+
+using namespace versa::util;
+
+namespace {
+   template <std::size_t N>
+   void check_fixed_bytes_hash() {
+      std::mt19937 rng(N);
+      fixed_bytes<N> key;
+      for (auto& c : key)
+         c = static_cast<char>(rng());
+
+      CHECK(hash(key) == hash_bytes(key.data(), N));
+      CHECK(hash(key, 7) == hash_bytes(key.data(), N, 7));
+      CHECK(hash(key) != hash(key, 7));
+      CHECK(std::hash<fixed_bytes<N>>{}(key) == static_cast<std::size_t>(hash(key)));
+
+      // Every single bit flip has to change the hash.
+      std::set<uint64_t> seen = {hash(key)};
+      for (std::size_t i = 0; i < N * 8; ++i) {
+         auto flipped = key;
+         flipped[i / 8] = static_cast<char>(flipped[i / 8] ^ (1 << (i % 8)));
+         seen.insert(hash(flipped));
+      }
+      CHECK(seen.size() == N * 8 + 1);
+   }
+}
+
+TEST_CASE("Hash Tests", "[hash_tests]") {
+   SECTION("Check Byte Hashing") {
+      const char text[] = "the quick brown fox jumps over the lazy dog, again and again and again";
+      std::unordered_set<uint64_t> seen;
+      for (std::size_t size = 0; size < sizeof(text); ++size) {
+         CHECK(hash_bytes(text, size) == hash_bytes(text, size));
+         seen.insert(hash_bytes(text, size));
+      }
+      // Prefixes of every length, including the empty one, all hash differently.
+      CHECK(seen.size() == sizeof(text));
+
+      // The hash only depends on the bytes, not on their address or alignment.
+      std::vector<char> copy(sizeof(text) + 1);
+      std::memcpy(copy.data() + 1, text, sizeof(text));
+      CHECK(hash_bytes(copy.data() + 1, sizeof(text)) == hash_bytes(text, sizeof(text)));
+   }
+
+   SECTION("Check Fixed Bytes Hashing") {
+      check_fixed_bytes_hash<1>();
+      check_fixed_bytes_hash<3>();
+      check_fixed_bytes_hash<8>();
+      check_fixed_bytes_hash<16>();
+      check_fixed_bytes_hash<20>();
+      check_fixed_bytes_hash<32>();
+      check_fixed_bytes_hash<48>();
+      check_fixed_bytes_hash<64>();
+      check_fixed_bytes_hash<100>();
+   }
+
+   SECTION("Check Low Collision Rate") {
+      // Sequential counters are the worst case for weak mixers.
+      std::unordered_set<uint64_t> seen;
+      std::unordered_set<uint64_t> low_bits;
+      for (uint64_t i = 0; i < 100000; ++i) {
+         fixed_bytes<20> key{};
+         std::memcpy(key.data(), &i, sizeof(i));
+         const uint64_t h = hash(key);
+         seen.insert(h);
+         low_bits.insert(h & 0xFFFF);
+      }
+      CHECK(seen.size() == 100000);
+      // 100000 uniform draws over 65536 buckets fill about 1 - e^-1.53 = 78% of them.
+      CHECK(low_bits.size() > 65536 * 3 / 4);
+   }
+
+   SECTION("Check Constant Evaluation") {
+      // Every length class of the kernel, hashed at compile time and at run time.
+      constexpr std::string_view text = "the quick brown fox jumps over the lazy dog, then sleeps in the sun";
+      constexpr uint64_t h0 = hash_string(text.substr(0, 0)), h3 = hash_string(text.substr(0, 3), 5),
+                         h12 = hash_string(text.substr(0, 12)), h30 = hash_string(text.substr(0, 30)),
+                         h67 = hash_string(text, 9);
+      CHECK(h0 == hash_bytes(text.data(), 0));
+      CHECK(h3 == hash_bytes(text.data(), 3, 5));
+      CHECK(h12 == hash_bytes(text.data(), 12));
+      CHECK(h30 == hash_bytes(text.data(), 30));
+      CHECK(h67 == hash_bytes(text.data(), text.size(), 9));
+      constexpr uint64_t fixed = hash(fixed_string("hello world"));
+      CHECK(fixed == hash(fixed_bytes<11>(std::string_view("hello world"))));
+      CHECK(fixed == hash_string("hello world"));
+   }
+}
+
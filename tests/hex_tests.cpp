@@ -0,0 +1,129 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <versa/cpu_features.hpp>
+#include <versa/fixed_string.hpp>
+#include <versa/hex.hpp>
+
+using namespace versa::util;
+
+namespace {
+   std::string reference_hex(const std::vector<std::byte>& bytes) {
+      std::string result;
+      for (auto b : bytes) {
+         result += "0123456789abcdef"[static_cast<uint8_t>(b) >> 4];
+         result += "0123456789abcdef"[static_cast<uint8_t>(b) & 0xF];
+      }
+      return result;
+   }
+
+   // Checks one encode/decode kernel pair over every length up to 100, including every invalid position.
+   void check_kernels(detail::hex_encode_fn encode, detail::hex_decode_fn decode) {
+      std::mt19937 rng(7);
+      for (std::size_t size = 0; size <= 100; ++size) {
+         std::vector<std::byte> bytes(size);
+         for (auto& b : bytes)
+            b = static_cast<std::byte>(rng());
+         const std::string expected = reference_hex(bytes);
+
+         std::string hex(2 * size, '\0');
+         encode(hex.data(), bytes.data(), size);
+         REQUIRE(hex == expected);
+
+         std::vector<std::byte> decoded(size);
+         REQUIRE(decode(decoded.data(), hex.data(), size));
+         REQUIRE(decoded == bytes);
+
+         std::string upper = hex;
+         for (auto& c : upper)
+            c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+         REQUIRE(decode(decoded.data(), upper.data(), size));
+         REQUIRE(decoded == bytes);
+
+         for (std::size_t i = 0; i < hex.size(); ++i) {
+            for (char bad : {'g', 'G', '/', ':', '@', '`', ' ', '\0', '\x80', '\xff'}) {
+               std::string corrupt = hex;
+               corrupt[i] = bad;
+               REQUIRE(!decode(decoded.data(), corrupt.data(), size));
+            }
+         }
+      }
+   }
+}
+
+TEST_CASE("Hex Tests", "[hex_tests]") {
+   SECTION("Check Fixed Bytes Conversion") {
+      const std::string git_hash = "4b825dc642cb6eb9a060e54bf8d69288fbee4904";
+      const auto bytes = from_hex<20>(git_hash);
+      CHECK(static_cast<uint8_t>(bytes[0]) == 0x4b);
+      CHECK(static_cast<uint8_t>(bytes[19]) == 0x04);
+      CHECK(to_hex(bytes) == git_hash);
+
+      char out[40];
+      to_hex(bytes, out);
+      CHECK(std::string_view(out, 40) == git_hash);
+
+      fixed_bytes<20> parsed;
+      CHECK(from_hex("4B825DC642CB6EB9A060E54BF8D69288FBEE4904", parsed));
+      CHECK(parsed == bytes);
+      CHECK(!from_hex(git_hash.substr(1), parsed));
+      CHECK(!from_hex(git_hash + "00", parsed));
+      CHECK(!from_hex("4b825dc642cb6eb9a060e54bf8d69288fbee490z", parsed));
+      CHECK_THROWS(from_hex<20>("not a hash"));
+   }
+
+   SECTION("Check Batch Conversion") {
+      std::mt19937 rng(3);
+      std::vector<fixed_bytes<20>> values(37);
+      for (auto& v : values)
+         for (auto& c : v)
+            c = static_cast<char>(rng());
+
+      std::string hex(40 * values.size(), '\0');
+      to_hex(std::span<const fixed_bytes<20>>(values), std::span<char>(hex));
+      for (std::size_t i = 0; i < values.size(); ++i)
+         CHECK(hex.substr(40 * i, 40) == to_hex(values[i]));
+
+      std::vector<fixed_bytes<20>> decoded(values.size());
+      CHECK(from_hex(hex, std::span<fixed_bytes<20>>(decoded)) == values.size());
+      CHECK(decoded == values);
+
+      hex[40 * 5 + 3] = 'x';
+      CHECK(from_hex(hex, std::span<fixed_bytes<20>>(decoded)) == 5);
+
+      std::string small(10, '\0');
+      CHECK_THROWS(to_hex(std::span<const fixed_bytes<20>>(values), std::span<char>(small)));
+      CHECK_THROWS(from_hex(small, std::span<fixed_bytes<20>>(decoded)));
+   }
+
+   SECTION("Check Scalar Kernels") {
+      check_kernels(&detail::hex_encode_scalar, &detail::hex_decode_scalar);
+   }
+
+   SECTION("Check Vector Kernels") {
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      if (versa::info::has_cpu_features(versa::info::cpu_features::ssse3))
+         check_kernels(&detail::hex_encode_ssse3, &detail::hex_decode_ssse3);
+      if (versa::info::has_cpu_features(versa::info::cpu_features::avx2))
+         check_kernels(&detail::hex_encode_avx2, &detail::hex_decode_avx2);
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+      check_kernels(&detail::hex_encode_neon, &detail::hex_decode_neon);
+#endif
+      check_kernels(detail::hex_encoder(), detail::hex_decoder());
+   }
+
+   SECTION("Check Constant Evaluation") {
+      constexpr auto encoded = []() {
+         std::array<char, 4> out = {};
+         const std::byte in[2] = {std::byte{0xAB}, std::byte{0x01}};
+         detail::hex_encode_scalar(out.data(), in, 2);
+         return out;
+      }();
+      CHECK(std::string_view(encoded.data(), 4) == "ab01");
+   }
+}
@@ -0,0 +1,126 @@
+#include <catch2/catch_all.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include <versa/perf.hpp>
+
+using namespace versa::perf;
+
+TEST_CASE("Perf Tests", "[perf_tests]") {
+   SECTION("Check Cycle Clock") {
+      const uint64_t a = cycle_clock::ticks();
+      const uint64_t b = cycle_clock::ticks_ordered();
+      CHECK(b >= a);
+      CHECK(cycle_clock::calibrate() > 0);
+      CHECK(cycle_clock::frequency() == cycle_clock::calibrate());
+
+      // The conversion agrees with the steady clock over a sleep, within the noise of a busy machine.
+      const auto start = std::chrono::steady_clock::now();
+      const auto cycles_start = cycle_clock::now();
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      const auto cycles_elapsed = cycle_clock::now() - cycles_start;
+      const auto steady_elapsed = std::chrono::steady_clock::now() - start;
+      const double ratio = std::chrono::duration<double>(cycles_elapsed).count() / std::chrono::duration<double>(steady_elapsed).count();
+      CHECK(ratio > 0.8);
+      CHECK(ratio < 1.25);
+
+      CHECK(cycle_clock::to_nanoseconds(0) == 0);
+      const auto one_second = cycle_clock::to_duration(cycle_clock::frequency()).count();
+      CHECK(one_second > 999000000);
+      CHECK(one_second < 1001000000);
+   }
+
+   SECTION("Check Histogram Buckets") {
+      using histogram = log_linear_histogram<5>;
+      static_assert(histogram::index_of(0) == 0);
+      static_assert(histogram::index_of(63) == 63);
+      static_assert(histogram::index_of(64) == 64);
+      static_assert(histogram::index_of(65) == 64);
+      static_assert(histogram::index_of(66) == 65);
+      static_assert(histogram::index_of(~uint64_t{0}) == histogram::bucket_count - 1);
+      static_assert(histogram::highest_value(histogram::bucket_count - 1) == ~uint64_t{0});
+
+      std::vector<uint64_t> values = {0, 1, 31, 32, 63, 64, 65, 127, 128, 1000, 123456789, uint64_t{1} << 40, ~uint64_t{0} >> 1};
+      for (uint64_t v = 1; v < (uint64_t{1} << 63); v = v * 3 + 1)
+         values.push_back(v);
+      for (const uint64_t v : values) {
+         const std::size_t i = histogram::index_of(v);
+         CHECK(i < histogram::bucket_count);
+         CHECK(histogram::lowest_value(i) <= v);
+         CHECK(histogram::highest_value(i) >= v);
+         // Every bucket spans at most 1/32 of its values.
+         CHECK((histogram::highest_value(i) - histogram::lowest_value(i)) * 32 <= v);
+      }
+      for (std::size_t i = 1; i < histogram::bucket_count; ++i)
+         CHECK(histogram::lowest_value(i) == histogram::highest_value(i - 1) + 1);
+   }
+
+   SECTION("Check Histogram Percentiles") {
+      latency_histogram h;
+      CHECK(h.count() == 0);
+      CHECK(h.value_at_percentile(50) == 0);
+
+      for (uint64_t v = 1; v <= 10000; ++v)
+         h.record(v);
+      CHECK(h.count() == 10000);
+      CHECK(h.min() == 1);
+      CHECK(h.max() == 10000);
+      CHECK(h.mean() == 5000.5);
+      CHECK(h.value_at_percentile(0) == 1);
+      // Within the 1/128 bucket width of the exact answers.
+      CHECK(h.value_at_percentile(50) >= 5000);
+      CHECK(h.value_at_percentile(50) <= 5000 + 5000 / 128);
+      CHECK(h.value_at_percentile(99) >= 9900);
+      CHECK(h.value_at_percentile(99) <= 9900 + 9900 / 128);
+      CHECK(h.value_at_percentile(100) == 10000);
+
+      h.reset();
+      h.record(250, 3);
+      CHECK(h.count() == 3);
+      CHECK(h.value_at_percentile(50) == 250);
+   }
+
+   SECTION("Check Histogram Merge") {
+      // One histogram per thread, merged afterwards, counts the same as a shared one.
+      std::vector<latency_histogram> locals(4);
+      std::vector<std::thread> threads;
+      for (std::size_t t = 0; t < locals.size(); ++t)
+         threads.emplace_back([&, t] {
+            for (uint64_t v = 0; v < 1000; ++v)
+               locals[t].record(v * (t + 1));
+         });
+      for (auto& thread : threads)
+         thread.join();
+
+      latency_histogram merged, expected;
+      for (std::size_t t = 0; t < locals.size(); ++t) {
+         merged.merge(locals[t]);
+         for (uint64_t v = 0; v < 1000; ++v)
+            expected.record(v * (t + 1));
+      }
+      CHECK(merged.count() == expected.count());
+      CHECK(merged.min() == expected.min());
+      CHECK(merged.max() == expected.max());
+      CHECK(merged.mean() == expected.mean());
+      for (double p : {1.0, 25.0, 50.0, 90.0, 99.9})
+         CHECK(merged.value_at_percentile(p) == expected.value_at_percentile(p));
+   }
+
+   SECTION("Check Scoped Stopwatch") {
+      uint64_t total = 0;
+      {
+         scoped_stopwatch watch(total);
+         std::this_thread::sleep_for(std::chrono::milliseconds(5));
+         CHECK(watch.elapsed() >= 4000000);
+      }
+      CHECK(total >= 4000000);
+
+      latency_histogram h;
+      for (int i = 0; i < 10; ++i)
+         scoped_stopwatch watch(h);
+      CHECK(h.count() == 10);
+   }
+}
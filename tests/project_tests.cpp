@@ -0,0 +1,32 @@
+#include <catch2/catch_all.hpp>
+
+#include <versa/project.hpp>
+
+TEST_CASE("Project Tests", "[project_tests]") {
+   SECTION("Check Generated Version") {
+      // From versa_setup_target(libversa_unit_tests ...) in tests/CMakeLists.txt.
+      CHECK(test_version_0::version.major == 1);
+      CHECK(test_version_0::version.minor == 0);
+      CHECK(test_version_0::version.patch == 0);
+      CHECK(test_version_0::version.tweak == 0);
+      CHECK(test_version_0::version.suffix == "alpha");
+      CHECK(test_version_0::version.git_hash.empty());
+   }
+
+   SECTION("Check No Version Definitions") {
+      // The version is linked in, not passed to every compile.
+#ifdef _VERSA_PROJECT_MAJOR_VERSION
+      FAIL("_VERSA_PROJECT_MAJOR_VERSION is defined");
+#endif
+      SUCCEED();
+   }
+
+   SECTION("Check Platform Flags") {
+      static_assert(VERSA_CPP_BUILD == 1 && VERSA_C_BUILD == 0);
+      static_assert(VERSA_UNKNOWN_BUILD == (versa::info::build_architecture == versa::info::architectures::unknown));
+      static_assert(VERSA_UNKNOWN_COMPILER == 0);
+#if VERSA_X64_BUILD && !VERSA_WINDOWS_BUILD
+      CHECK(versa::info::build_architecture == versa::info::architectures::x64);
+#endif
+   }
+}
@@ -0,0 +1,159 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include <versa/record_table.hpp>
+
+using namespace versa::util;
+
+namespace {
+   using digest_t   = fixed_bytes<12>;
+   using meta_t = fixed_bytes<8>;
+   using table_t = record_table<digest_t, meta_t>;
+
+   digest_t make_key(uint32_t i) {
+      digest_t key;
+      std::memset(key._data, 0, sizeof(key._data));
+      // Big endian, so that key order is numeric order.
+      be<uint32_t>(key._data + 4) = i * 7;
+      return key;
+   }
+
+   meta_t make_value(uint64_t i) {
+      meta_t value;
+      std::memcpy(value._data, &i, sizeof(i));
+      return value;
+   }
+
+   uint64_t value_of(const meta_t* value) {
+      uint64_t i;
+      std::memcpy(&i, value->_data, sizeof(i));
+      return i;
+   }
+
+   std::string temp_path(const char* name) {
+      return (std::filesystem::temp_directory_path() / name).string();
+   }
+
+   // Adds keys 0..count-1 in a scrambled order, then every key again with another value.
+   uint64_t build(const std::string& path, uint32_t count, record_table_options options) {
+      record_table_builder<digest_t, meta_t> builder(path, options);
+      for (uint32_t i = 0; i < count; ++i) {
+         const uint32_t k = static_cast<uint32_t>((uint64_t{i} * 7919) % count);
+         builder.add(make_key(k), make_value(k));
+      }
+      for (uint32_t i = 0; i < count; ++i)
+         builder.add(make_key(i), make_value(~uint64_t{0}));
+      return builder.finish();
+   }
+}
+
+TEST_CASE("Record Table Tests", "[record_table_tests]") {
+   SECTION("Check Eytzinger Order") {
+      // Walking a 6 node tree in key order.
+      CHECK(detail::eytzinger_first(6) == 4);
+      CHECK(detail::eytzinger_next(4, 6) == 2);
+      CHECK(detail::eytzinger_next(2, 6) == 5);
+      CHECK(detail::eytzinger_next(5, 6) == 1);
+      CHECK(detail::eytzinger_next(1, 6) == 6);
+      CHECK(detail::eytzinger_next(6, 6) == 3);
+      CHECK(detail::eytzinger_next(3, 6) == 0);
+   }
+
+   for (const auto layout : {record_layout::sorted, record_layout::eytzinger}) {
+      for (const std::size_t budget : {std::size_t{1} << 20, std::size_t{0}}) {
+         // A zero budget still holds 1024 records, so 5000 records take several runs.
+         const std::string path = temp_path("versa_record_table.tbl");
+         const uint32_t count = 5000;
+         REQUIRE(build(path, count, {layout, budget}) == count);
+
+         SECTION("Check Lookups " + std::to_string(static_cast<int>(layout)) + " " + std::to_string(budget)) {
+            const table_t table(path.c_str());
+            REQUIRE(table.size() == count);
+            CHECK(table.layout() == layout);
+            for (uint32_t i = 0; i < count; ++i) {
+               const meta_t* value = table.find(make_key(i));
+               REQUIRE(value != nullptr);
+               // The first record added for a key is kept.
+               CHECK(value_of(value) == i);
+            }
+            CHECK(table.find(make_key(count)) == nullptr);
+            digest_t between = make_key(10);
+            between._data[11] = std::byte{1};
+            CHECK_FALSE(table.contains(between));
+            digest_t smallest;
+            std::memset(smallest._data, 0, sizeof(smallest._data));
+            CHECK(table.contains(smallest));
+            digest_t largest;
+            std::memset(largest._data, 0xFF, sizeof(largest._data));
+            CHECK_FALSE(table.contains(largest));
+
+            if (layout == record_layout::sorted)
+               CHECK(std::is_sorted(table.records().begin(), table.records().end(),
+                                    [](const auto& a, const auto& b) { return a.key < b.key; }));
+         }
+
+         SECTION("Check Batched Lookups " + std::to_string(static_cast<int>(layout)) + " " + std::to_string(budget)) {
+            const table_t table(path.c_str());
+            std::vector<digest_t> keys;
+            for (uint32_t i = 0; i < 100; ++i)
+               keys.push_back(make_key(i * 53 % (count + 40)));
+            std::vector<const meta_t*> found(keys.size());
+            table.find_batch(keys, found);
+            for (std::size_t i = 0; i < keys.size(); ++i)
+               CHECK(found[i] == table.find(keys[i]));
+         }
+         std::filesystem::remove(path);
+      }
+   }
+
+   SECTION("Check Small And Empty Tables") {
+      const std::string path = temp_path("versa_record_table_small.tbl");
+      for (const auto layout : {record_layout::sorted, record_layout::eytzinger}) {
+         for (uint32_t count = 0; count < 20; ++count) {
+            REQUIRE(build(path, count, {layout, 1 << 20}) == count);
+            const table_t table(path.c_str());
+            REQUIRE(table.size() == count);
+            for (uint32_t i = 0; i < count; ++i)
+               CHECK(table.contains(make_key(i)));
+            CHECK_FALSE(table.contains(make_key(count)));
+            std::vector<digest_t> keys{make_key(0), make_key(count)};
+            std::vector<const meta_t*> found(2);
+            table.find_batch(keys, found);
+            CHECK((found[0] != nullptr) == (count > 0));
+            CHECK(found[1] == nullptr);
+         }
+      }
+      std::filesystem::remove(path);
+   }
+
+   SECTION("Check In Memory Images") {
+      const std::string path = temp_path("versa_record_table_image.tbl");
+      build(path, 100, {record_layout::eytzinger, 1 << 20});
+      std::ifstream in(path, std::ios::binary);
+      const std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+      std::vector<std::byte> image(bytes.size());
+      std::memcpy(image.data(), bytes.data(), bytes.size());
+      std::filesystem::remove(path);
+
+      table_t table(image);
+      CHECK(table.size() == 100);
+      CHECK(value_of(table.find(make_key(42))) == 42);
+
+      table_t moved(std::move(table));
+      CHECK(moved.contains(make_key(42)));
+
+      CHECK_THROWS(table_t(std::span<const std::byte>(image.data(), image.size() - 1)));
+      CHECK_THROWS(record_table<fixed_bytes<16>, meta_t>{image});
+      image[0] = std::byte{'X'};
+      CHECK_THROWS(table_t{image});
+      CHECK_THROWS(table_t(std::span<const std::byte>(image.data(), 10)));
+      CHECK_THROWS(table_t(temp_path("versa_record_table_missing.tbl").c_str()));
+   }
+}
@@ -0,0 +1,43 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <versa/string_switch.hpp>
+
+using namespace versa::util;
+
+namespace {
+   std::size_t command(std::string_view name) {
+      return string_switch<"get", "put", "del", "scan", "incr", "decr", "append", "expire", "ttl", "ping",
+                           "auth", "select", "flush", "keys", "exists", "rename", "mget", "mset">(name);
+   }
+}
+
+TEST_CASE("String Switch Tests", "[string_switch_tests]") {
+   SECTION("Check Every Key") {
+      const std::vector<std::string> keys = {"get", "put", "del", "scan", "incr", "decr", "append", "expire", "ttl",
+                                             "ping", "auth", "select", "flush", "keys", "exists", "rename", "mget", "mset"};
+      for (std::size_t i = 0; i < keys.size(); ++i)
+         CHECK(command(keys[i]) == i);
+   }
+
+   SECTION("Check Unknown Strings") {
+      constexpr std::size_t none = 18;
+      for (std::string_view s : {"", "g", "ge", "gets", "GET", "get ", "pu", "mse", "msets", "appendx", "x", "delete"})
+         CHECK(command(s) == none);
+      // A string that hashes to a used slot still has to compare equal to its key.
+      for (std::size_t i = 0; i < 10000; ++i)
+         CHECK(command("key" + std::to_string(i)) == none);
+   }
+
+   SECTION("Check Constant Evaluation") {
+      static_assert(string_switch<"one">("one") == 0);
+      static_assert(string_switch<"one">("two") == 1);
+      static_assert(string_switch<"a", "bb", "ccc">("ccc") == 2);
+      static_assert(string_switch<"a", "bb", "ccc">("dd") == 3);
+      static_assert(detail::string_switch_table<"a", "bb", "ccc">::slots.size() >= 3);
+   }
+}
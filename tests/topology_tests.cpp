@@ -0,0 +1,113 @@
+#include <catch2/catch_all.hpp>
+
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <versa/topology.hpp>
+
+using namespace versa::info;
+
+namespace {
+   void write_file(const std::filesystem::path& path, const std::string& text) {
+      std::filesystem::create_directories(path.parent_path());
+      std::ofstream(path) << text << '\n';
+   }
+
+   void write_cache(const std::filesystem::path& cpu, int index, int level, const std::string& type,
+                    const std::string& size, const std::string& shared) {
+      const auto dir = cpu / "cache" / ("index" + std::to_string(index));
+      write_file(dir / "level", std::to_string(level));
+      write_file(dir / "type", type);
+      write_file(dir / "size", size);
+      write_file(dir / "coherency_line_size", "64");
+      write_file(dir / "ways_of_associativity", "8");
+      write_file(dir / "shared_cpu_list", shared);
+   }
+
+   // Two packages of two cores with two threads each, and two NUMA nodes.
+   std::filesystem::path make_fake_sysfs() {
+      const auto root = std::filesystem::temp_directory_path() / "versa_fake_sysfs";
+      std::filesystem::remove_all(root);
+      const auto system = root / "devices" / "system";
+      write_file(system / "cpu" / "online", "0-7");
+      for (int cpu = 0; cpu < 8; ++cpu) {
+         const auto dir = system / "cpu" / ("cpu" + std::to_string(cpu));
+         write_file(dir / "topology" / "physical_package_id", std::to_string(cpu / 4));
+         write_file(dir / "topology" / "core_id", std::to_string((cpu / 2) % 2));
+      }
+      const auto cpu0 = system / "cpu" / "cpu0";
+      write_cache(cpu0, 0, 1, "Data", "48K", "0-1");
+      write_cache(cpu0, 1, 1, "Instruction", "32K", "0-1");
+      write_cache(cpu0, 2, 2, "Unified", "2048K", "0-1");
+      write_cache(cpu0, 3, 3, "Unified", "32M", "0-3");
+      write_file(system / "node" / "online", "0-1");
+      return root;
+   }
+}
+
+TEST_CASE("Topology Tests", "[topology_tests]") {
+   SECTION("Check Interference Sizes") {
+      static_assert(destructive_interference_size(architectures::x64) == 128);
+      static_assert(constructive_interference_size(architectures::x64) == 64);
+      static_assert(destructive_interference_size(architectures::s390x) == 256);
+      static_assert(destructive_interference_size(architectures::riscv64) == 64);
+      static_assert(hardware_destructive_interference_size >= hardware_constructive_interference_size);
+      alignas(hardware_destructive_interference_size) char padded[1];
+      CHECK(reinterpret_cast<std::uintptr_t>(padded) % hardware_destructive_interference_size == 0);
+   }
+
+   SECTION("Check Cpu List Parsing") {
+      CHECK(detail::parse_cpu_list("0") == std::vector<uint32_t>{0});
+      CHECK(detail::parse_cpu_list("0-3,8,10-11") == std::vector<uint32_t>{0, 1, 2, 3, 8, 10, 11});
+      CHECK(detail::parse_cpu_list("").empty());
+      CHECK(detail::parse_cpu_list("x,2").size() == 1);
+      CHECK(detail::parse_cache_size("48K") == 48 * 1024);
+      CHECK(detail::parse_cache_size("2M") == 2 * 1024 * 1024);
+      CHECK(detail::parse_cache_size("512") == 512);
+      CHECK(detail::parse_cache_size("") == 0);
+   }
+
+   SECTION("Check Fake Sysfs Tree") {
+      const auto root = make_fake_sysfs();
+      const auto topology = host_topology::load(root.string());
+      CHECK(topology.logical_cores == 8);
+      CHECK(topology.physical_cores == 4);
+      CHECK(topology.packages == 2);
+      CHECK(topology.smt_width() == 2);
+      CHECK(topology.numa_nodes == 2);
+      CHECK(topology.cache_line_size == 64);
+      REQUIRE(topology.caches.size() == 4);
+      CHECK(topology.caches[0].type == cache_types::data);
+      CHECK(topology.caches[1].type == cache_types::instruction);
+      CHECK(topology.l1d_size() == 48 * 1024);
+      CHECK(topology.l2_size() == 2048 * 1024);
+      CHECK(topology.l3_size() == 32 * 1024 * 1024);
+      CHECK(topology.data_cache(3)->shared_by == 4);
+      CHECK(topology.data_cache(1)->ways == 8);
+      CHECK(topology.data_cache(4) == nullptr);
+
+      // reload() swaps the cached topology; references to the earlier one stay valid.
+      const host_topology& host = host_topology::get();
+      const host_topology& fake = host_topology::reload(root.string());
+      CHECK(&host_topology::get() == &fake);
+      CHECK(fake.logical_cores == 8);
+      CHECK(host.logical_cores >= 1);
+      host_topology::reload();
+      std::filesystem::remove_all(root);
+   }
+
+   SECTION("Check Host Topology") {
+      const host_topology& topology = host_topology::get();
+      CHECK(&host_topology::get() == &topology);
+      CHECK(topology.logical_cores >= 1);
+      CHECK(topology.physical_cores >= 1);
+      CHECK(topology.physical_cores <= topology.logical_cores);
+      CHECK(topology.numa_nodes >= 1);
+      CHECK(topology.cache_line_size >= 16);
+      CHECK((topology.cache_line_size & (topology.cache_line_size - 1)) == 0);
+#if VERSA_X64_BUILD
+      CHECK(topology.l1d_size() > 0);
+#endif
+   }
+}
@@ -0,0 +1,136 @@
+#include <catch2/catch_all.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define VERSA_TRACING 1
+#include <versa/trace.hpp>
+
+using namespace versa::trace;
+
+namespace {
+   std::vector<event> collect() {
+      std::vector<event> events;
+      drain([&](const event& e) { events.push_back(e); });
+      return events;
+   }
+
+   void traced_work(int depth) {
+      VERSA_TRACE_SCOPE("traced_work");
+      if (depth > 0)
+         traced_work(depth - 1);
+   }
+
+   // Destroyed after the thread has released its buffer when created before the thread's first event.
+   struct late_tracer {
+      ~late_tracer() { counter("after release", 2); }
+   };
+}
+
+TEST_CASE("Trace Tests", "[trace_tests]") {
+   collect();
+
+   SECTION("Check Scopes And Counters") {
+      traced_work(2);
+      VERSA_TRACE_COUNTER("queue_depth", 42);
+      const auto events = collect();
+      REQUIRE(events.size() == 4);
+      // Scopes are recorded when they end, so the innermost comes first.
+      CHECK(std::string(events[0].name) == "traced_work");
+      CHECK(events[0].kind == event_kind::scope);
+      CHECK(events[0].timestamp >= events[2].timestamp);
+      CHECK(events[0].timestamp + events[0].value <= events[2].timestamp + events[2].value);
+      CHECK(events[3].kind == event_kind::counter);
+      CHECK(events[3].value == 42);
+      CHECK(events[3].thread == events[0].thread);
+      CHECK(collect().empty());
+   }
+
+   SECTION("Check Threads") {
+      constexpr int threads = 4, per_thread = 1000;
+      std::vector<std::thread> workers;
+      for (int t = 0; t < threads; ++t)
+         workers.emplace_back([] {
+            for (int i = 0; i < per_thread; ++i)
+               VERSA_TRACE_COUNTER("work", i);
+         });
+      for (auto& w : workers)
+         w.join();
+
+      // Every thread has its own id and its events arrive in order.
+      std::map<uint32_t, std::vector<uint64_t>> by_thread;
+      for (const auto& e : collect())
+         by_thread[e.thread].push_back(e.value);
+      REQUIRE(by_thread.size() == threads);
+      for (const auto& [thread, values] : by_thread) {
+         REQUIRE(values.size() == per_thread);
+         for (int i = 0; i < per_thread; ++i)
+            REQUIRE(values[i] == static_cast<uint64_t>(i));
+      }
+
+      // Finished threads hand their buffers on instead of allocating more.
+      std::thread([] { VERSA_TRACE_COUNTER("late", 1); }).join();
+      CHECK(collect().size() == 1);
+   }
+
+   SECTION("Check Tracing After Release") {
+      const uint64_t before = dropped();
+      std::thread([] {
+         thread_local late_tracer tracer;
+         (void)tracer;
+         VERSA_TRACE_COUNTER("before release", 1);
+      }).join();
+      // The buffer may already belong to another thread, so the late event is dropped instead.
+      const auto events = collect();
+      REQUIRE(events.size() == 1);
+      CHECK(events[0].value == 1);
+      CHECK(dropped() == before + 1);
+   }
+
+   SECTION("Check Full Ring") {
+      const uint64_t before = dropped();
+      for (std::size_t i = 0; i < detail::thread_buffer::capacity + 10; ++i)
+         VERSA_TRACE_COUNTER("flood", i);
+      CHECK(dropped() == before + 10);
+      CHECK(collect().size() == detail::thread_buffer::capacity);
+   }
+
+   SECTION("Check Chrome JSON") {
+      std::string json;
+      append_chrome_json(json, {"a \"quoted\" name", 1234567, 2500, 3, event_kind::scope});
+      CHECK(json == R"({"name":"a \"quoted\" name","ph":"X","ts":1234.567,"dur":2.500,"pid":1,"tid":3})");
+      json.clear();
+      append_chrome_json(json, {"depth", 1000, 7, 1, event_kind::counter});
+      CHECK(json == R"({"name":"depth","ph":"C","ts":1.000,"args":{"value":7},"pid":1,"tid":1})");
+
+      std::FILE* file = std::tmpfile();
+      REQUIRE(file != nullptr);
+      {
+         chrome_json_writer writer(file);
+         {
+            background_flusher flusher(writer, std::chrono::milliseconds(1));
+            for (int i = 0; i < 100; ++i)
+               traced_work(0);
+         }
+         traced_work(0);
+      }
+      std::rewind(file);
+      std::string text;
+      char buffer[4096];
+      for (std::size_t n; (n = std::fread(buffer, 1, sizeof(buffer), file)) > 0;)
+         text.append(buffer, n);
+      std::fclose(file);
+      CHECK(text.rfind("{\"traceEvents\":[\n", 0) == 0);
+      CHECK(text.size() >= 5);
+      CHECK(text.substr(text.size() - 4) == "\n]}\n");
+      std::size_t count = 0;
+      for (std::size_t at = 0; (at = text.find("\"ph\":\"X\"", at)) != std::string::npos; ++at)
+         ++count;
+      CHECK(count == 101);
+      CHECK(text.find("}{") == std::string::npos);
+   }
+}
@@ -0,0 +1,187 @@
+/* Built as C11, so the C API of the generated versa/version.h is checked by a C compiler. Each
+   versa_check_c_ function returns 0 when it passes, or the line of the first failing expectation, which
+   versions_tests.cpp reports. */
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <versa/version.h>
+
+#define EXPECT(...) do { if (!(__VA_ARGS__)) return __LINE__; } while (0)
+
+static int same(const char* a, const char* b) {
+   return a && b && strcmp(a, b) == 0;
+}
+
+static uint64_t next_random(uint64_t* state) {
+   *state = *state * 6364136223846793005ull + 1442695040888963407ull;
+   return *state;
+}
+
+static int is_sorted(const uint64_t* v, size_t n) {
+   size_t i;
+   for (i = 1; i < n; ++i)
+      if (v[i - 1] > v[i])
+         return 0;
+   return 1;
+}
+
+/* Sorts a copy of v with and without scratch space, and checks both orders agree. */
+static int sorts_agree(const uint64_t* v, size_t n) {
+   uint64_t* radix   = (uint64_t*)malloc(n * sizeof(uint64_t));
+   uint64_t* sorted  = (uint64_t*)malloc(n * sizeof(uint64_t));
+   uint64_t* scratch = (uint64_t*)malloc(n * sizeof(uint64_t));
+   int ok = radix && sorted && scratch;
+   if (ok) {
+      memcpy(radix, v, n * sizeof(uint64_t));
+      memcpy(sorted, v, n * sizeof(uint64_t));
+      lv_version_sort(radix, n, scratch);
+      lv_version_sort(sorted, n, NULL);
+      ok = is_sorted(radix, n) && memcmp(radix, sorted, n * sizeof(uint64_t)) == 0;
+   }
+   free(radix);
+   free(sorted);
+   free(scratch);
+   return ok;
+}
+
+int versa_check_c_version_init(void) {
+   lv_version_info_t v;
+   lv_version_info_t made;
+   lv_version_info_t current;
+   lv_version_info_t* heap;
+
+   EXPECT(lv_version_init(&v, 1, 2, 3, 4, "rc1", "abc") == &v);
+   EXPECT(v.major == 1 && v.minor == 2 && v.patch == 3 && v.tweak == 4);
+   EXPECT(same(v.suffix, "rc1") && same(v.git_hash, "abc"));
+
+   made = lv_make_version_info(5, 6, 7, 8, "", "def");
+   EXPECT(made.major == 5 && made.minor == 6 && made.patch == 7 && made.tweak == 8);
+   EXPECT(same(made.suffix, "") && same(made.git_hash, "def"));
+
+   /* The heap constructor used to store the git hash into suffix. */
+   heap = lv_create_version_info(9, 8, 7, 6, "beta", "0123abcd");
+   EXPECT(heap != NULL);
+   EXPECT(heap->major == 9 && heap->minor == 8 && heap->patch == 7 && heap->tweak == 6);
+   EXPECT(same(heap->suffix, "beta") && same(heap->git_hash, "0123abcd"));
+   lv_free_version_info(heap);
+   lv_free_version_info(NULL);
+
+   /* tests/CMakeLists.txt configures this header as test_version_0 1.0.0.0-alpha, without a git hash. */
+   EXPECT(test_version_0_init_version_info(&current) == &current);
+   EXPECT(current.major == 1 && current.minor == 0 && current.patch == 0 && current.tweak == 0);
+   EXPECT(same(current.suffix, "alpha") && same(current.git_hash, ""));
+   EXPECT(lv_version_number(&current) == test_version_0_version_number());
+   EXPECT(same(test_version_0_version_major_s(), "1"));
+
+   heap = test_version_0_create_version_info();
+   EXPECT(heap != NULL);
+   EXPECT(lv_version_cmp(heap, &current) == 0);
+   lv_free_version_info(heap);
+   return 0;
+}
+
+int versa_check_c_version_arena(void) {
+   /* Room for three structs after the arena aligns the first one, which starts a byte off. */
+   _Alignas(lv_version_info_t) unsigned char buffer[3 * sizeof(lv_version_info_t) + sizeof(void*)];
+   lv_version_arena_t arena;
+   lv_version_info_t* first;
+   lv_version_info_t* v;
+   size_t count = 0;
+
+   lv_version_arena_init(&arena, buffer + 1, sizeof(buffer) - 1);
+   first = lv_arena_create_version_info(&arena, 1, 0, 0, 0, "", "");
+   EXPECT(first != NULL);
+   EXPECT((uintptr_t)first % sizeof(void*) == 0);
+   for (v = first; v; v = lv_arena_create_version_info(&arena, 2, 0, 0, (uint16_t)count, "x", "y")) {
+      EXPECT((unsigned char*)v >= buffer + 1 && (unsigned char*)(v + 1) <= buffer + sizeof(buffer));
+      ++count;
+   }
+   EXPECT(count == 3);
+   EXPECT(first->major == 1);
+
+   /* A full arena stays full until it is reset. */
+   EXPECT(lv_arena_create_version_info(&arena, 3, 0, 0, 0, "", "") == NULL);
+   lv_version_arena_reset(&arena);
+   v = lv_arena_create_version_info(&arena, 4, 5, 6, 7, "rc2", "abc");
+   EXPECT(v == first);
+   EXPECT(v->major == 4 && v->tweak == 7 && same(v->suffix, "rc2") && same(v->git_hash, "abc"));
+
+   lv_version_arena_init(&arena, buffer, sizeof(lv_version_info_t) - 1);
+   EXPECT(lv_arena_create_version_info(&arena, 1, 0, 0, 0, "", "") == NULL);
+   lv_version_arena_init(&arena, buffer, 0);
+   EXPECT(lv_arena_create_version_info(&arena, 1, 0, 0, 0, "", "") == NULL);
+   return 0;
+}
+
+int versa_check_c_version_batch(void) {
+   const lv_version_info_t infos[4] = {
+      {1, 2, 3, 4, "", ""},
+      {1, 2, 3, 5, "", ""},
+      {2, 0, 0, 0, "", ""},
+      {0, 65535, 65535, 65535, "", ""},
+   };
+   uint64_t a[4];
+   uint64_t b[4];
+   int8_t out[4];
+
+   lv_version_pack(infos, 4, a);
+   EXPECT(a[0] == lv_version_number(&infos[0]) && a[3] == lv_version_number(&infos[3]));
+   EXPECT(lv_version_cmp(&infos[0], &infos[1]) == -1);
+   EXPECT(lv_version_cmp(&infos[2], &infos[3]) == 1);
+
+   b[0] = a[1];
+   b[1] = a[0];
+   b[2] = a[2];
+   b[3] = a[2];
+   lv_version_cmp_many(a, b, 4, out);
+   EXPECT(out[0] == -1 && out[1] == 1 && out[2] == 0 && out[3] == -1);
+   lv_version_cmp_many(a, b, 0, NULL);
+
+   EXPECT(lv_version_max_index(a, 0) == SIZE_MAX);
+   EXPECT(lv_version_max_index(a, 1) == 0);
+   EXPECT(lv_version_max_index(a, 4) == 2);
+   b[0] = a[3];
+   b[1] = a[2];
+   b[2] = a[0];
+   b[3] = a[2];
+   EXPECT(lv_version_max_index(b, 4) == 1);
+   return 0;
+}
+
+int versa_check_c_version_sort(void) {
+   enum { count = 1000 };
+   static uint64_t v[count];
+   uint64_t state = 42;
+   uint64_t small[5] = {40, 10, 30, 10, 20};
+   uint64_t scratch[5];
+   size_t i;
+
+   /* Fewer than 256 versions take the qsort path, with or without scratch. */
+   lv_version_sort(small, 5, scratch);
+   EXPECT(small[0] == 10 && small[1] == 10 && small[2] == 20 && small[3] == 30 && small[4] == 40);
+   lv_version_sort(small, 0, NULL);
+   lv_version_sort(small, 1, NULL);
+
+   /* Every byte differs, so the radix sort makes all eight passes. */
+   for (i = 0; i < count; ++i)
+      v[i] = next_random(&state);
+   EXPECT(sorts_agree(v, count));
+
+   /* Typical versions share their major and minor, so the radix sort skips those bytes. */
+   for (i = 0; i < count; ++i)
+      v[i] = (1ull << 48) | (4ull << 32) | (next_random(&state) >> 32);
+   EXPECT(sorts_agree(v, count));
+
+   /* Only the lowest byte differs: one pass, which leaves the result in scratch to copy back. */
+   for (i = 0; i < count; ++i)
+      v[i] = (3ull << 48) | (next_random(&state) >> 56);
+   EXPECT(sorts_agree(v, count));
+
+   for (i = 0; i < count; ++i)
+      v[i] = 7;
+   EXPECT(sorts_agree(v, count));
+   return 0;
+}
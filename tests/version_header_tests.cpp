@@ -0,0 +1,29 @@
+#include <catch2/catch_all.hpp>
+
+#include <string_view>
+
+// Only the generated header, to check it stands on its own; project_tests.cpp covers versa/project.hpp.
+#include <versa/version.hpp>
+
+TEST_CASE("Version Header Tests", "[version_header_tests]") {
+   SECTION("Check Generated Version") {
+      // From versa_setup_target(libversa_unit_tests ...) in tests/CMakeLists.txt.
+      static_assert(test_version_0::version.major == 1 && test_version_0::version.tweak == 0);
+      CHECK(test_version_0::version.suffix == "alpha");
+      CHECK(test_version_0::version.git_hash.empty());
+      CHECK(test_version_0::version == test_version_0::version_info(1, 0, 0, 0, "alpha"));
+      CHECK(test_version_0::version > test_version_0::version_info(0, 9));
+   }
+
+   SECTION("Check Formatting") {
+      CHECK(test_version_0::version.to_string() == "1.0.0.0-alpha");
+      CHECK(test_version_0::version.to_string<test_version_0::version_info::parts::major>() == "1");
+      CHECK(test_version_0::version.to_string<test_version_0::version_info::parts::suffix>() == "alpha");
+
+      char buffer[32];
+      REQUIRE(test_version_0::version.formatted_size() <= sizeof(buffer));
+      const char* end = test_version_0::version.format_to(buffer);
+      CHECK(std::string_view(buffer, end) == "1.0.0.0-alpha");
+      CHECK(versa::util::to_string_view(test_version_0::version_string) == "1.0.0.0-alpha");
+   }
+}
@@ -0,0 +1,366 @@
+#include <catch2/catch_all.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#include <versa/constants.hpp>
+#include <versa/cpu_features.hpp>
+#include <versa/versions.hpp>
+
+using namespace versa::info;
+
+// Defined in version_c_tests.c, each returns 0 or the line of its first failed expectation.
+extern "C" {
+   int versa_check_c_version_init(void);
+   int versa_check_c_version_arena(void);
+   int versa_check_c_version_batch(void);
+   int versa_check_c_version_sort(void);
+}
+
+namespace {
+   version_view parse_ok(std::string_view text) {
+      version_view v{};
+      REQUIRE(parse_version(text, v) == std::errc{});
+      return v;
+   }
+
+   // Builds a manifest whose lines straddle 64 byte block boundaries in every possible way.
+   std::string make_manifest(std::size_t count, std::vector<version_info>& expected) {
+      std::string text;
+      for (std::size_t i = 0; i < count; ++i) {
+         version_info v(static_cast<uint16_t>(i % 7), static_cast<uint16_t>(i % 100), static_cast<uint16_t>(i), static_cast<uint16_t>(i * 3),
+                        i % 3 == 0 ? "" : std::string(i % 11 + 1, 'a'), i % 2 == 0 ? "" : "abc" + std::to_string(i));
+         text += v.to_string();
+         text += i % 5 == 0 ? "\r\n" : "\n";
+         if (i % 13 == 0)
+            text += "\n";
+         expected.push_back(v);
+      }
+      return text;
+   }
+
+   void check_manifest(detail::parse_versions_fn parse) {
+      std::vector<version_info> expected;
+      const std::string text = make_manifest(500, expected);
+      std::vector<version_view> out(expected.size());
+      const auto result = parse(text, out);
+      CHECK(result.parsed == expected.size());
+      CHECK(result.failed == 0);
+      CHECK(result.consumed == text.size());
+      for (std::size_t i = 0; i < expected.size(); ++i) {
+         REQUIRE(out[i].major == expected[i].major);
+         REQUIRE(out[i].minor == expected[i].minor);
+         REQUIRE(out[i].patch == expected[i].patch);
+         REQUIRE(out[i].tweak == expected[i].tweak);
+         REQUIRE(out[i].suffix == expected[i].suffix);
+         REQUIRE(out[i].git_hash == expected[i].git_hash);
+      }
+
+      // A small output buffer stops at a line boundary and the rest parses when resumed.
+      std::vector<version_view> part(100);
+      std::size_t offset = 0, total = 0;
+      while (offset < text.size()) {
+         const auto r = parse(std::string_view(text).substr(offset), part);
+         for (std::size_t i = 0; i < r.parsed; ++i)
+            REQUIRE(part[i].patch == expected[total + i].patch);
+         total  += r.parsed;
+         offset += r.consumed;
+      }
+      CHECK(total == expected.size());
+
+      const std::string bad = "1.2.3\nnot a version\n4.5.6\n1.2.3.4.5\n7.8";
+      const auto r = parse(bad, out);
+      CHECK(r.parsed == 3);
+      CHECK(r.failed == 2);
+      CHECK(r.first_failure == 6);
+      CHECK(out[2].major == 7);
+      CHECK(out[2].minor == 8);
+   }
+
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+   // The vector fast path may decline a line, but whatever it accepts has to match parse_version().
+   void check_fast_path(detail::fast_parse_fn fast) {
+      std::mt19937 rng(99);
+      const std::string_view alphabet = "0123456789012345678901234567890123456789....--+ ()vVax_";
+      std::size_t accepted = 0;
+      for (std::size_t iter = 0; iter < 200000; ++iter) {
+         char line[64] = {};
+         const std::size_t len = 1 + rng() % 62;
+         for (std::size_t i = 0; i < len; ++i)
+            line[i] = alphabet[rng() % alphabet.size()];
+         if (iter % 2)
+            std::memcpy(line, "1.2.3", std::min<std::size_t>(len, 5));
+         version_view fast_out{}, scalar_out{};
+         if (fast(line, len, fast_out)) {
+            ++accepted;
+            REQUIRE(parse_version(std::string_view(line, len), scalar_out) == std::errc{});
+            REQUIRE(fast_out.major == scalar_out.major);
+            REQUIRE(fast_out.minor == scalar_out.minor);
+            REQUIRE(fast_out.patch == scalar_out.patch);
+            REQUIRE(fast_out.tweak == scalar_out.tweak);
+            REQUIRE(fast_out.suffix == scalar_out.suffix);
+            REQUIRE(fast_out.git_hash == scalar_out.git_hash);
+         }
+      }
+      CHECK(accepted > 1000);
+   }
+#endif
+}
+
+TEST_CASE("Version Parse Tests", "[version_parse_tests]") {
+   SECTION("Check To String Round Trip") {
+      const version_info v(1, 2, 3, 4, "alpha", "abc123");
+      CHECK(v.to_string() == "1.2.3.4-alpha (abc123)");
+      version_info parsed(0);
+      REQUIRE(version_info::parse(v.to_string(), parsed) == std::errc{});
+      CHECK(parsed.to_string() == v.to_string());
+
+      const auto view = parse_ok("65535.0.7.0");
+      CHECK(view.major == 65535);
+      CHECK(view.patch == 7);
+      CHECK(view.suffix.empty());
+      CHECK(view.git_hash.empty());
+   }
+
+   SECTION("Check Semver Variants") {
+      auto v = parse_ok("v1.2.3");
+      CHECK((v.major == 1 && v.minor == 2 && v.patch == 3 && v.tweak == 0));
+      v = parse_ok("1.2.3-rc.1+build.5");
+      CHECK(v.suffix == "rc.1");
+      CHECK(v.git_hash.empty());
+      v = parse_ok("1.0.0+20130313144700");
+      CHECK(v.suffix.empty());
+      v = parse_ok("1.0.0-x-y-z.--");
+      CHECK(v.suffix == "x-y-z.--");
+      v = parse_ok("2");
+      CHECK((v.major == 2 && v.minor == 0));
+      v = parse_ok("2.1-beta (deadBEEF)");
+      CHECK((v.major == 2 && v.minor == 1 && v.suffix == "beta" && v.git_hash == "deadBEEF"));
+   }
+
+   SECTION("Check Rejected Input") {
+      version_view v{};
+      for (std::string_view bad : {"", "v", "1.", ".1", "1..2", "1.2.3.4.5", "1.2-", "1.2+", "1.2 ()", "1.2 (abc",
+                                   "1.2 abc)", "1.2.3 ", " 1.2.3", "1.2.3-al pha", "1.2.3 (ab c)", "a.b.c", "1.2.3\n"})
+         CHECK(parse_version(bad, v) == std::errc::invalid_argument);
+      CHECK(parse_version("65536.0", v) == std::errc::result_out_of_range);
+      CHECK(parse_version("1.99999999999999999999", v) == std::errc::result_out_of_range);
+
+      version_info info(9, 9, 9, 9);
+      CHECK(version_info::parse("bogus", info) == std::errc::invalid_argument);
+      CHECK(info.major == 9);
+   }
+
+   SECTION("Check Constant Evaluation") {
+      constexpr auto v = []() {
+         version_view out{};
+         parse_version("3.14.15-pi (cafe)", out);
+         return out;
+      }();
+      static_assert(v.major == 3 && v.minor == 14 && v.patch == 15);
+      static_assert(v.suffix == "pi" && v.git_hash == "cafe");
+   }
+
+   SECTION("Check Batch Parsing") {
+      check_manifest(&detail::parse_versions_portable);
+#if VERSA_X64_BUILD || VERSA_X86_BUILD
+      check_manifest(&detail::parse_versions_sse2);
+      check_fast_path(&detail::parse_version_sse2);
+      if (has_cpu_features(cpu_features::avx2)) {
+         check_manifest(&detail::parse_versions_avx2);
+         check_fast_path(&detail::parse_version_avx2);
+      }
+#elif defined(__ARM_NEON) && (VERSA_ARM64_BUILD)
+      check_manifest(&detail::parse_versions_neon);
+#endif
+      check_manifest(&parse_versions);
+   }
+}
+
+namespace {
+   constexpr version_view constant_version{{1, 22, 333, 4444}, "rc.1", "4b825dc"};
+   constexpr version_view constant_bare{{65535, 0, 10, 9}, "", ""};
+}
+
+TEST_CASE("Version Format Tests", "[version_format_tests]") {
+   SECTION("Check Format To") {
+      const version_info v(1, 2, 3, 4, "alpha", "abc123");
+      char buffer[64];
+      char* end = v.format_to(buffer);
+      CHECK(std::string_view(buffer, end - buffer) == "1.2.3.4-alpha (abc123)");
+      CHECK(v.formatted_size() == static_cast<std::size_t>(end - buffer));
+      CHECK(v.to_string() == "1.2.3.4-alpha (abc123)");
+
+      CHECK(version_info(10, 200, 3000, 40000).to_string() == "10.200.3000.40000");
+      CHECK(version_info(0, 0, 0, 0, "", "abc").to_string() == "0.0.0.0 (abc)");
+      CHECK(version_info(0, 0, 0, 0, "x").to_string() == "0.0.0.0-x");
+
+      version_view view{};
+      REQUIRE(parse_version("7.8.9-beta+meta (ff)", view) == std::errc{});
+      end = view.format_to(buffer);
+      CHECK(std::string_view(buffer, end - buffer) == "7.8.9.0-beta (ff)");
+      CHECK(view.formatted_size() == static_cast<std::size_t>(end - buffer));
+   }
+
+   SECTION("Check Compile Time Rendering") {
+      constexpr auto rendered = render_version<constant_version>();
+      static_assert(rendered.size() == constant_version.formatted_size());
+      CHECK(versa::util::to_string_view(rendered) == "1.22.333.4444-rc.1 (4b825dc)");
+      CHECK(versa::util::to_string_view(version_string<constant_bare>) == "65535.0.10.9");
+      CHECK(versa::util::to_string_view(version_string<constant_bare>).data() ==
+            versa::util::to_string_view(version_string<constant_bare>).data());
+   }
+
+#if defined(__cpp_lib_format)
+   SECTION("Check Formatter") {
+      CHECK(std::format("{}", version_info(1, 2, 3, 4, "alpha", "abc123")) == "1.2.3.4-alpha (abc123)");
+      CHECK(std::format("[{}]", constant_version) == "[1.22.333.4444-rc.1 (4b825dc)]");
+   }
+#endif
+}
+
+namespace {
+   constexpr packed_version make_packed(std::string_view text) {
+      packed_version v{};
+      packed_version::parse(text, v);
+      return v;
+   }
+
+   template <packed_version V>
+   constexpr std::size_t packed_suffix_size() { return V.suffix().size(); }
+}
+
+TEST_CASE("Packed Version Tests", "[packed_version_tests]") {
+   SECTION("Check Layout") {
+      static_assert(sizeof(packed_version) == 48);
+      static_assert(std::is_trivially_copyable_v<packed_version>);
+      static_assert(std::has_unique_object_representations_v<packed_version>);
+   }
+
+   SECTION("Check Round Trip") {
+      for (std::string_view text : {"1.2.3.4", "1.2.3.4-alpha (4b825dc642cb6eb9a060e54bf8d69288fbee4904)", "0.0.0.0 (abc)",
+                                    "65535.65535.65535.65535-abcdefghijklmn (4B825DC)", "9.8.7.6-rc.1"}) {
+         packed_version v{};
+         REQUIRE(packed_version::parse(text, v) == std::errc{});
+         version_view expected{};
+         REQUIRE(parse_version(text, expected) == std::errc{});
+         CHECK(v.major == expected.major);
+         CHECK(v.tweak == expected.tweak);
+         CHECK(v.suffix() == expected.suffix);
+         CHECK(v.git_hash_digits == expected.git_hash.size());
+
+         std::string lower(text);
+         for (auto& c : lower)
+            if (c >= 'A' && c <= 'F') c = static_cast<char>(c - 'A' + 'a');
+         CHECK(v.to_string() == lower);
+         CHECK(v.formatted_size() == lower.size());
+         CHECK(v.to_version_info().to_string() == lower);
+
+         packed_version from_info{};
+         REQUIRE(packed_version::from(v.to_version_info(), from_info) == std::errc{});
+         CHECK(from_info == v);
+
+         // Equal versions have equal bytes, so packed versions can be compared, hashed or stored raw.
+         packed_version copy;
+         std::memcpy(&copy, &v, sizeof(v));
+         CHECK(copy == v);
+         CHECK(std::memcmp(&from_info, &v, sizeof(v)) == 0);
+      }
+   }
+
+   SECTION("Check Rejected Input") {
+      packed_version v{};
+      CHECK(packed_version::parse("1.2.3-abcdefghijklmno", v) == std::errc::value_too_large);
+      CHECK(packed_version::parse("1.2.3 (4b825dc642cb6eb9a060e54bf8d69288fbee49040)", v) == std::errc::value_too_large);
+      CHECK(packed_version::parse("1.2.3 (xyz)", v) == std::errc::invalid_argument);
+      CHECK(packed_version::parse("1.2.3.", v) == std::errc::invalid_argument);
+   }
+
+   SECTION("Check Compile Time Use") {
+      static constexpr packed_version v = make_packed("3.2.1-rc1 (abcdef)");
+      static_assert(v.major == 3 && v.suffix() == "rc1" && v.git_hash_digits == 6);
+      static_assert(packed_suffix_size<v>() == 3);
+      static_assert(packed_suffix_size<make_packed("1.0.0-beta")>() == 4);
+      CHECK(versa::util::to_string_view(version_string<v>) == "3.2.1.0-rc1 (abcdef)");
+   }
+}
+
+TEST_CASE("Version Order Tests", "[version_order_tests]") {
+   SECTION("Check Key") {
+      // The old decimal number() let 1.100.0 pass 2.0.0; the key keeps every field in its own 16 bits.
+      CHECK(version_info(1, 100, 0, 0).number() < version_info(2, 0, 0, 0).number());
+      CHECK(version_info(0, 0, 65535, 0).number() < version_info(0, 1, 0, 0).number());
+      CHECK(version_info(1, 100, 0, 0) < version_info(2, 0, 0, 0));
+      CHECK(version_info(1, 2, 3, 4).number() == 0x0001000200030004ull);
+      static_assert(version_t{65535, 65535, 65535, 65535}.key() == ~uint64_t{0});
+      static_assert(version_t{1, 0, 0, 0}.key() > version_t{0, 65535, 65535, 65535}.key());
+   }
+
+   SECTION("Check Prerelease Precedence") {
+      // The example list from the semver specification, lowest first.
+      const std::vector<std::string_view> ordered = {
+         "1.0.0-alpha", "1.0.0-alpha.1", "1.0.0-alpha.beta", "1.0.0-beta", "1.0.0-beta.2",
+         "1.0.0-beta.11", "1.0.0-rc.1", "1.0.0", "1.0.1-0", "1.0.1-1a"};
+      for (std::size_t i = 0; i < ordered.size(); ++i) {
+         for (std::size_t j = 0; j < ordered.size(); ++j) {
+            const version_view a = parse_ok(ordered[i]), b = parse_ok(ordered[j]);
+            REQUIRE((a <=> b) == (i <=> j));
+            REQUIRE((version_info(a.major, a.minor, a.patch, a.tweak, a.suffix) <=>
+                     version_info(b.major, b.minor, b.patch, b.tweak, b.suffix)) == (i <=> j));
+         }
+      }
+      static_assert(detail::compare_prerelease("rc.2", "rc.10") < 0);
+      static_assert(detail::compare_prerelease("", "rc") > 0);
+      static_assert(detail::compare_prerelease("9", "a") < 0);
+      CHECK(parse_ok("1.0.0 (abc)") != parse_ok("1.0.0 (abd)"));
+      CHECK(parse_ok("1.0.0 (abc)") < parse_ok("1.0.0 (abd)"));
+   }
+
+   SECTION("Check Sort Versions") {
+      std::mt19937 rng(7);
+      const std::string_view suffixes[] = {"", "", "", "rc.1", "rc.2", "rc.10", "alpha", "beta.3"};
+      for (std::size_t count : {0u, 1u, 100u, 5000u}) {
+         std::vector<packed_version> packed(count);
+         std::vector<version_info> infos;
+         for (auto& p : packed) {
+            // Narrow ranges so that equal keys, and so the suffix tie-break, are common.
+            const version_view v{{rng() % 3, rng() % 4, rng() % 300, rng() % 2}, suffixes[rng() % 8], ""};
+            REQUIRE(packed_version::from(v, p) == std::errc{});
+            infos.push_back(p.to_version_info());
+         }
+         std::vector<packed_version> expected = packed;
+         std::sort(expected.begin(), expected.end());
+         sort_versions(std::span<packed_version>(packed));
+         CHECK(packed == expected);
+
+         std::vector<version_info> expected_infos = infos;
+         std::sort(expected_infos.begin(), expected_infos.end());
+         sort_versions(std::span<version_info>(infos));
+         for (std::size_t i = 0; i < count; ++i)
+            REQUIRE(infos[i] == expected_infos[i]);
+      }
+   }
+}
+
+TEST_CASE("Version C API Tests", "[version_c_api_tests]") {
+   SECTION("Check Init") {
+      CHECK(versa_check_c_version_init() == 0);
+   }
+
+   SECTION("Check Arena") {
+      CHECK(versa_check_c_version_arena() == 0);
+   }
+
+   SECTION("Check Batch Comparisons") {
+      CHECK(versa_check_c_version_batch() == 0);
+   }
+
+   SECTION("Check Sort") {
+      CHECK(versa_check_c_version_sort() == 0);
+   }
+}
@@ -0,0 +1,120 @@
+// versa_scan [-j threads] [-q] path...
+//
+// Prints the version and build_info recorded by versa_setup_target(... ELF_NOTE) in each file, or in
+// every regular file below each directory, without running or loading any of them.
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <versa/build_note.hpp>
+
+namespace {
+   using namespace versa::info;
+
+   const char* name_of(architectures arch) {
+      switch (arch) {
+         case architectures::x86:     return "x86";
+         case architectures::x64:     return "x64";
+         case architectures::arm32:   return "arm32";
+         case architectures::arm64:   return "arm64";
+         case architectures::sparc32: return "sparc32";
+         case architectures::sparc64: return "sparc64";
+         case architectures::mips32:  return "mips32";
+         case architectures::mips64:  return "mips64";
+         case architectures::ppc32:   return "ppc32";
+         case architectures::ppc64:   return "ppc64";
+         case architectures::riscv32: return "riscv32";
+         case architectures::riscv64: return "riscv64";
+         case architectures::s390:    return "s390";
+         case architectures::s390x:   return "s390x";
+         case architectures::wasm32:  return "wasm32";
+         case architectures::wasm64:  return "wasm64";
+         default:                     return "unknown";
+      }
+   }
+
+   const char* name_of(compilers compiler) {
+      switch (compiler) {
+         case compilers::msvc:  return "msvc";
+         case compilers::gcc:   return "gcc";
+         case compilers::clang: return "clang";
+         case compilers::cl430: return "cl430";
+         case compilers::intel: return "intel";
+         default:               return "unknown";
+      }
+   }
+
+   const char* name_of(build_types build) {
+      switch (build) {
+         case build_types::debug:                   return "debug";
+         case build_types::release:                 return "release";
+         case build_types::release_with_debug_info: return "relwithdebinfo";
+         case build_types::profile:                 return "profile";
+         case build_types::trace:                   return "trace";
+         case build_types::minimum_size:            return "minsizerel";
+         default:                                   return "unknown";
+      }
+   }
+
+   void collect(const std::filesystem::path& path, std::vector<std::string>& files) {
+      std::error_code ec;
+      if (std::filesystem::is_directory(path, ec)) {
+         for (auto it = std::filesystem::recursive_directory_iterator(path, std::filesystem::directory_options::skip_permission_denied, ec);
+              !ec && it != std::filesystem::recursive_directory_iterator(); it.increment(ec))
+            if (it->is_regular_file(ec))
+               files.push_back(it->path().string());
+      } else {
+         files.push_back(path.string());
+      }
+   }
+
+   int usage() {
+      std::fputs("usage: versa_scan [-j threads] [-q] path...\n"
+                 "  -j N  read files on N threads, default one per core\n"
+                 "  -q    do not report files without a build note\n", stderr);
+      return 2;
+   }
+}
+
+int main(int argc, char** argv) {
+   unsigned threads = 0;
+   bool quiet = false;
+   std::vector<std::string> files;
+   for (int i = 1; i < argc; ++i) {
+      const std::string_view arg = argv[i];
+      if (arg == "-j" && i + 1 < argc)
+         threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+      else if (arg == "-q")
+         quiet = true;
+      else if (arg == "-h" || arg == "--help" || (arg.size() > 1 && arg[0] == '-'))
+         return usage();
+      else
+         collect(arg, files);
+   }
+   if (files.empty())
+      return usage();
+
+   const auto results = scan_build_notes(files, threads);
+   std::size_t found = 0;
+   for (std::size_t i = 0; i < files.size(); ++i) {
+      const auto& result = results[i];
+      if (result.error == std::errc{}) {
+         ++found;
+         const build_info info = result.note.info();
+         std::printf("%s: %s %s %s-%u %s\n", files[i].c_str(), result.note.to_version_info().to_string().c_str(),
+                     name_of(info.arch), name_of(info.compiler), static_cast<unsigned>(info.compiler_version), name_of(info.build));
+      } else if (!quiet) {
+         std::fprintf(stderr, "%s: %s\n", files[i].c_str(),
+                      result.error == std::errc::no_message ? "no build note"
+                                                            : std::make_error_code(result.error).message().c_str());
+      }
+   }
+   return found ? 0 : 1;
+}